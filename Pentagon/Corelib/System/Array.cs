@@ -122,6 +122,13 @@ public class Array
         if (startIndex >= array.Length) throw new ArgumentOutOfRangeException(nameof(startIndex));
         if (count < 0) throw new ArgumentOutOfRangeException(nameof(count));
         if (startIndex + count > array.Length) throw new ArgumentOutOfRangeException(nameof(startIndex));
+
+        if (RuntimeHelpers.IsBitwiseEquatable<T>())
+        {
+            var size = (ulong)Unsafe.SizeOf<T>();
+            var index = Buffer.IndexOf(array.GetDataPtr() + (ulong)startIndex * size, (ulong)count, size, Unsafe.AsPointer(ref value));
+            return index < 0 ? -1 : startIndex + index;
+        }
         
         for (var i = startIndex; i < startIndex + count; i++)
         {
@@ -1,8 +1,31 @@
 namespace System;
 
-public readonly struct Boolean
+public readonly struct Boolean : ISpanFormattable
 {
+
+    public static readonly string TrueString = "True";
+    public static readonly string FalseString = "False";
+
 #pragma warning disable 169
     private readonly bool _value;
 #pragma warning restore 169
+
+    public override string ToString()
+    {
+        return _value ? TrueString : FalseString;
+    }
+
+    public bool TryFormat(Span<char> destination, out int charsWritten, string format = null)
+    {
+        var str = _value ? TrueString : FalseString;
+        if (!str.AsSpan().TryCopyTo(destination))
+        {
+            charsWritten = 0;
+            return false;
+        }
+
+        charsWritten = str.Length;
+        return true;
+    }
+
 }
\ No newline at end of file
@@ -0,0 +1,33 @@
+using System.Runtime.CompilerServices;
+
+namespace System;
+
+/// <summary>
+/// Native kernels for working on blittable memory, these must never be used on
+/// memory that contains references since they bypass the GC write barrier.
+/// </summary>
+internal static class Buffer
+{
+
+    [MethodImpl(MethodImplOptions.InternalCall)]
+    internal static extern void Memmove(ulong dest, ulong src, ulong size);
+
+    [MethodImpl(MethodImplOptions.InternalCall)]
+    internal static extern void ZeroMemory(ulong dest, ulong size);
+
+    /// <summary>
+    /// Set count elements of the given size to the value pointed by value
+    /// </summary>
+    [MethodImpl(MethodImplOptions.InternalCall)]
+    internal static extern void Fill(ulong dest, ulong count, ulong elementSize, ulong value);
+
+    /// <summary>
+    /// Bitwise search for the value pointed by value, returns -1 if not found
+    /// </summary>
+    [MethodImpl(MethodImplOptions.InternalCall)]
+    internal static extern int IndexOf(ulong ptr, ulong count, ulong elementSize, ulong value);
+
+    [MethodImpl(MethodImplOptions.InternalCall)]
+    internal static extern bool SequenceEqual(ulong a, ulong b, ulong size);
+
+}
@@ -0,0 +1,68 @@
+using System.Runtime.CompilerServices;
+
+namespace System.Buffers;
+
+/// <summary>
+/// The pool behind MemoryPool.Shared, the blocks are arrays rented from ArrayPool.Shared
+/// </summary>
+internal sealed class ArrayMemoryPool<T> : MemoryPool<T>
+{
+
+    private const int DefaultBufferSize = 4096;
+
+    public override int MaxBufferSize => Array.MaxLength;
+
+    public override IMemoryOwner<T> Rent(int minBufferSize = -1)
+    {
+        if (minBufferSize == -1)
+        {
+            minBufferSize = 1 + (DefaultBufferSize - 1) / Unsafe.SizeOf<T>();
+        }
+        else if ((uint)minBufferSize > Array.MaxLength)
+        {
+            throw new ArgumentOutOfRangeException(nameof(minBufferSize));
+        }
+
+        return new ArrayMemoryPoolBuffer(minBufferSize);
+    }
+
+    protected override void Dispose(bool disposing)
+    {
+        // the shared pool is never disposed
+    }
+
+    private sealed class ArrayMemoryPoolBuffer : IMemoryOwner<T>
+    {
+
+        private T[] _array;
+
+        public ArrayMemoryPoolBuffer(int size)
+        {
+            _array = ArrayPool<T>.Shared.Rent(size);
+        }
+
+        public Memory<T> Memory
+        {
+            get
+            {
+                var array = _array;
+                if (array == null)
+                    throw new ObjectDisposedException(nameof(ArrayMemoryPoolBuffer));
+
+                return new Memory<T>(array);
+            }
+        }
+
+        public void Dispose()
+        {
+            var array = _array;
+            if (array == null)
+                return;
+
+            _array = null;
+            ArrayPool<T>.Shared.Return(array);
+        }
+
+    }
+
+}
\ No newline at end of file
@@ -0,0 +1,30 @@
+namespace System.Buffers;
+
+/// <summary>
+/// A pool of arrays, renting an array instead of allocating one saves both the zeroing
+/// of the new array and the work of the GC to collect it later.
+/// </summary>
+public abstract class ArrayPool<T>
+{
+
+    private static readonly SharedArrayPool<T> s_shared = new();
+
+    /// <summary>
+    /// The pool that is shared by the whole system
+    /// </summary>
+    public static ArrayPool<T> Shared => s_shared;
+
+    /// <summary>
+    /// Rent an array that is at least of the given length, it may be longer and it is
+    /// not cleared, so it may contain the data of the previous renter
+    /// </summary>
+    public abstract T[] Rent(int minimumLength);
+
+    /// <summary>
+    /// Return an array that was rented from this pool, the array must not be used after this
+    /// </summary>
+    /// <param name="array">The array to return</param>
+    /// <param name="clearArray">Clear the array before it is given to the next renter</param>
+    public abstract void Return(T[] array, bool clearArray = false);
+
+}
\ No newline at end of file
@@ -0,0 +1,34 @@
+namespace System.Buffers;
+
+/// <summary>
+/// A pool of memory blocks, the blocks are returned to the pool when their owner is disposed
+/// </summary>
+public abstract class MemoryPool<T> : IDisposable
+{
+
+    private static readonly ArrayMemoryPool<T> s_shared = new();
+
+    /// <summary>
+    /// A pool that is backed by ArrayPool.Shared
+    /// </summary>
+    public static MemoryPool<T> Shared => s_shared;
+
+    /// <summary>
+    /// The largest buffer that can be rented from the pool
+    /// </summary>
+    public abstract int MaxBufferSize { get; }
+
+    /// <summary>
+    /// Rent a block of at least the given size, -1 gives a block of the default size of the pool
+    /// </summary>
+    public abstract IMemoryOwner<T> Rent(int minBufferSize = -1);
+
+    public void Dispose()
+    {
+        Dispose(true);
+        GC.SuppressFinalize(this);
+    }
+
+    protected abstract void Dispose(bool disposing);
+
+}
\ No newline at end of file
@@ -0,0 +1,161 @@
+using System.Threading;
+
+namespace System.Buffers;
+
+/// <summary>
+/// The pool behind ArrayPool.Shared. The arrays are kept in power of two buckets, and every
+/// cpu has a small stack per bucket, so renting and returning on the same cpu only touches
+/// memory no other cpu is using. When the stack of our cpu is empty we steal from the other
+/// cpus before allocating a new array.
+/// </summary>
+internal sealed class SharedArrayPool<T> : ArrayPool<T>
+{
+
+    private const int MinimumArrayLength = 16;
+
+    // 16 elements up to 1M elements
+    private const int BucketCount = 17;
+
+    private const int ArraysPerPartition = 8;
+
+    /// <summary>
+    /// The arrays of a single bucket on a single cpu, the lock is only contended when
+    /// another cpu steals from us or when we got moved while using it
+    /// </summary>
+    private sealed class Partition
+    {
+
+        private readonly T[][] _arrays = new T[ArraysPerPartition][];
+        private int _count;
+        private SpinLock _lock;
+
+        public bool TryPush(T[] array)
+        {
+            var lockTaken = false;
+            _lock.Enter(ref lockTaken);
+
+            var pushed = false;
+            if (_count < _arrays.Length)
+            {
+                _arrays[_count++] = array;
+                pushed = true;
+            }
+
+            _lock.Exit();
+            return pushed;
+        }
+
+        public T[] TryPop()
+        {
+            if (_count == 0)
+                return null;
+
+            var lockTaken = false;
+            _lock.Enter(ref lockTaken);
+
+            T[] array = null;
+            if (_count > 0)
+            {
+                array = _arrays[--_count];
+                _arrays[_count] = null;
+            }
+
+            _lock.Exit();
+            return array;
+        }
+
+    }
+
+    // indexed by the cpu and then by the bucket, the partitions of a
+    // cpu are only created once an array is returned on that cpu
+    private readonly Partition[][] _partitions = new Partition[Environment.ProcessorCount][];
+
+    private static int SelectBucketIndex(int length)
+    {
+        // the log2 of the length rounded up, relative to the smallest bucket,
+        // anything larger than the last bucket gives BucketCount
+        var index = 0;
+        var size = MinimumArrayLength;
+        while (size < length && index < BucketCount)
+        {
+            size <<= 1;
+            index++;
+        }
+        return index;
+    }
+
+    private static int GetBucketArrayLength(int index)
+    {
+        return MinimumArrayLength << index;
+    }
+
+    private Partition[] GetOrCreatePartitions(int cpu)
+    {
+        var partitions = _partitions[cpu];
+        if (partitions != null)
+            return partitions;
+
+        partitions = new Partition[BucketCount];
+        for (var i = 0; i < partitions.Length; i++)
+        {
+            partitions[i] = new Partition();
+        }
+
+        // someone else might have beaten us to it
+        return Interlocked.CompareExchange(ref _partitions[cpu], partitions, null) ?? partitions;
+    }
+
+    public override T[] Rent(int minimumLength)
+    {
+        if (minimumLength < 0) throw new ArgumentOutOfRangeException(nameof(minimumLength), "Non-negative number required.");
+
+        if (minimumLength == 0)
+            return Array.Empty<T>();
+
+        // too large to pool
+        if (minimumLength > GetBucketArrayLength(BucketCount - 1))
+            return new T[minimumLength];
+
+        var bucket = SelectBucketIndex(minimumLength);
+
+        // start from our own cpu, and then steal from the next ones
+        var cpu = Thread.GetCurrentProcessorId();
+        for (var i = 0; i < _partitions.Length; i++)
+        {
+            var partitions = _partitions[(cpu + i) % _partitions.Length];
+            if (partitions == null)
+                continue;
+
+            var array = partitions[bucket].TryPop();
+            if (array != null)
+                return array;
+        }
+
+        return new T[GetBucketArrayLength(bucket)];
+    }
+
+    public override void Return(T[] array, bool clearArray = false)
+    {
+        if (array == null) throw new ArgumentNullException(nameof(array));
+
+        if (array.Length == 0)
+            return;
+
+        var bucket = SelectBucketIndex(array.Length);
+        if (bucket >= BucketCount)
+            return;
+
+        if (array.Length != GetBucketArrayLength(bucket))
+            throw new ArgumentException("The buffer is not associated with this pool and may not be returned to it.", nameof(array));
+
+        if (clearArray)
+        {
+            Array.Clear(array);
+        }
+
+        // if our stack is full the array is simply left for the GC
+        var cpu = Thread.GetCurrentProcessorId();
+        GetOrCreatePartitions(cpu)[bucket].TryPush(array);
+    }
+
+}
\ No newline at end of file
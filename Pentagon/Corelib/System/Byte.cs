@@ -1,6 +1,6 @@
 namespace System;
 
-public readonly struct Byte
+public readonly struct Byte : ISpanFormattable
 {
 
     public const byte MaxValue = 255;
@@ -26,7 +26,17 @@ public readonly struct Byte
 
     public override string ToString()
     {
-        return "";
+        return Number.UInt64ToString(_value, null);
+    }
+
+    public string ToString(string format)
+    {
+        return Number.UInt64ToString(_value, format);
+    }
+
+    public bool TryFormat(Span<char> destination, out int charsWritten, string format = null)
+    {
+        return Number.TryFormatUInt64(_value, format, destination, out charsWritten);
     }
     
 }
\ No newline at end of file
@@ -1,21 +1,463 @@
+using System.Runtime.CompilerServices;
+
 namespace System.Collections.Generic;
 
-public class Dictionary<TKey, TValue>
+/// <summary>
+/// A hash map that keeps all the entries in a single array, the buckets only hold the index
+/// of the first entry in the chain, so adding and removing entries never allocates unless we
+/// need to grow the table.
+/// </summary>
+public class Dictionary<TKey, TValue> : IEnumerable<KeyValuePair<TKey, TValue>>
 {
 
-    private class Chain
+    private const int DefaultCapacity = 4;
+
+    /// <summary>
+    /// The next of a free entry is encoded as StartOfFreeList - nextFree, so that the
+    /// end of the free list (-1) becomes -2 and is not confused with the end of a chain
+    /// </summary>
+    private const int StartOfFreeList = -3;
+
+    private struct Entry
     {
-        public KeyValuePair<TKey, TValue> Entry;
-        public Chain Next;
+        public uint HashCode;
+
+        // the next entry in the chain, -1 at the end of the chain
+        public int Next;
+
+        public TKey Key;
+        public TValue Value;
     }
-    
-    private Chain[][] _table;
-    private int _capacity;
-    private int _size;
-    
-    private void Add(TKey key, TValue value)
+
+    // one-based index into the entries, zero means the bucket is empty
+    private int[] _buckets;
+    private Entry[] _entries;
+    private int _shift;
+
+    private int _count;
+    private int _freeList;
+    private int _freeCount;
+    private int _version;
+
+    private readonly IEqualityComparer<TKey> _comparer;
+
+    public int Count => _count - _freeCount;
+
+    public IEqualityComparer<TKey> Comparer => _comparer;
+
+    public Dictionary()
+        : this(0, null)
+    {
+    }
+
+    public Dictionary(int capacity)
+        : this(capacity, null)
+    {
+    }
+
+    public Dictionary(IEqualityComparer<TKey> comparer)
+        : this(0, comparer)
+    {
+    }
+
+    public Dictionary(int capacity, IEqualityComparer<TKey> comparer)
+    {
+        if (capacity < 0) throw new ArgumentOutOfRangeException(nameof(capacity), "Non-negative number required.");
+
+        _comparer = comparer ?? EqualityComparer<TKey>.Default;
+        _freeList = -1;
+
+        if (capacity > 0)
+        {
+            Initialize(capacity);
+        }
+    }
+
+    public TValue this[TKey key]
+    {
+        get
+        {
+            var i = FindEntry(key);
+            if (i < 0)
+                throw new KeyNotFoundException();
+            return _entries[i].Value;
+        }
+        set => TryInsert(key, value, InsertionBehavior.OverwriteExisting);
+    }
+
+    #region Hashing
+
+    private void Initialize(int capacity)
+    {
+        var size = DefaultCapacity;
+        var log = 2;
+        while (size < capacity)
+        {
+            size *= 2;
+            log++;
+        }
+
+        _buckets = new int[size];
+        _entries = new Entry[size];
+        _shift = 32 - log;
+        _freeList = -1;
+    }
+
+    /// <summary>
+    /// The table is a power of two, so take the top bits of a multiplicative hash, this spreads
+    /// keys that only differ in their high bits (like aligned addresses) over all the buckets
+    /// </summary>
+    private int GetBucket(uint hashCode)
     {
-        
+        return (int)((hashCode * 0x9E3779B9u) >> _shift);
     }
-    
+
+    private void Resize()
+    {
+        var newSize = _entries.Length * 2;
+        if ((uint)newSize > Array.MaxLength)
+            throw new InvalidOperationException("Dictionary capacity overflow.");
+
+        var entries = new Entry[newSize];
+        Array.Copy(_entries, entries, _count);
+
+        _buckets = new int[newSize];
+        _entries = entries;
+        _shift--;
+
+        // rechain all the live entries, the free list stays as is
+        for (var i = 0; i < _count; i++)
+        {
+            if (entries[i].Next < -1)
+                continue;
+
+            var bucket = GetBucket(entries[i].HashCode);
+            entries[i].Next = _buckets[bucket] - 1;
+            _buckets[bucket] = i + 1;
+        }
+    }
+
+    #endregion
+
+    #region Lookup
+
+    private int FindEntry(TKey key)
+    {
+        if (key == null) throw new ArgumentNullException(nameof(key));
+
+        if (_buckets == null)
+            return -1;
+
+        var hashCode = (uint)_comparer.GetHashCode(key);
+        var entries = _entries;
+        var i = _buckets[GetBucket(hashCode)] - 1;
+        while (i >= 0)
+        {
+            ref var entry = ref entries[i];
+            if (entry.HashCode == hashCode && _comparer.Equals(entry.Key, key))
+                return i;
+            i = entry.Next;
+        }
+
+        return -1;
+    }
+
+    public bool ContainsKey(TKey key)
+    {
+        return FindEntry(key) >= 0;
+    }
+
+    public bool TryGetValue(TKey key, out TValue value)
+    {
+        var i = FindEntry(key);
+        if (i >= 0)
+        {
+            value = _entries[i].Value;
+            return true;
+        }
+
+        value = default;
+        return false;
+    }
+
+    #endregion
+
+    #region Insertion
+
+    private enum InsertionBehavior
+    {
+        None,
+        OverwriteExisting,
+        ThrowOnExisting,
+    }
+
+    /// <summary>
+    /// Find the entry of the key, adding a new entry with a default value if there is none
+    /// </summary>
+    private int FindOrAddEntry(TKey key, out bool exists)
+    {
+        if (key == null) throw new ArgumentNullException(nameof(key));
+
+        if (_buckets == null)
+        {
+            Initialize(0);
+        }
+
+        var hashCode = (uint)_comparer.GetHashCode(key);
+        var i = _buckets[GetBucket(hashCode)] - 1;
+        while (i >= 0)
+        {
+            ref var entry = ref _entries[i];
+            if (entry.HashCode == hashCode && _comparer.Equals(entry.Key, key))
+            {
+                exists = true;
+                return i;
+            }
+            i = entry.Next;
+        }
+
+        // reuse a removed entry if we can, otherwise take the next one
+        int index;
+        if (_freeCount > 0)
+        {
+            index = _freeList;
+            _freeList = StartOfFreeList - _entries[index].Next;
+            _freeCount--;
+        }
+        else
+        {
+            if (_count == _entries.Length)
+            {
+                Resize();
+            }
+            index = _count;
+            _count++;
+        }
+
+        var bucket = GetBucket(hashCode);
+        ref var newEntry = ref _entries[index];
+        newEntry.HashCode = hashCode;
+        newEntry.Next = _buckets[bucket] - 1;
+        newEntry.Key = key;
+        newEntry.Value = default;
+        _buckets[bucket] = index + 1;
+        _version++;
+
+        exists = false;
+        return index;
+    }
+
+    private bool TryInsert(TKey key, TValue value, InsertionBehavior behavior)
+    {
+        var i = FindOrAddEntry(key, out var exists);
+        if (exists)
+        {
+            if (behavior == InsertionBehavior.ThrowOnExisting)
+                throw new ArgumentException("An item with the same key has already been added.", nameof(key));
+
+            if (behavior == InsertionBehavior.None)
+                return false;
+        }
+
+        _entries[i].Value = value;
+        return true;
+    }
+
+    public void Add(TKey key, TValue value)
+    {
+        TryInsert(key, value, InsertionBehavior.ThrowOnExisting);
+    }
+
+    public bool TryAdd(TKey key, TValue value)
+    {
+        return TryInsert(key, value, InsertionBehavior.None);
+    }
+
+    /// <summary>
+    /// Used by CollectionsMarshal, the reference is only valid until the dictionary is modified
+    /// </summary>
+    internal ref TValue GetValueRefOrAddDefault(TKey key, out bool exists)
+    {
+        var i = FindOrAddEntry(key, out exists);
+        return ref _entries[i].Value;
+    }
+
+    public int EnsureCapacity(int capacity)
+    {
+        if (capacity < 0) throw new ArgumentOutOfRangeException(nameof(capacity), "Non-negative number required.");
+
+        if (_entries == null)
+        {
+            Initialize(capacity);
+        }
+        else
+        {
+            while (_entries.Length < capacity)
+            {
+                Resize();
+            }
+        }
+
+        return _entries.Length;
+    }
+
+    #endregion
+
+    #region Removal
+
+    public bool Remove(TKey key)
+    {
+        return Remove(key, out _);
+    }
+
+    public bool Remove(TKey key, out TValue value)
+    {
+        if (key == null) throw new ArgumentNullException(nameof(key));
+
+        if (_buckets != null)
+        {
+            var hashCode = (uint)_comparer.GetHashCode(key);
+            var bucket = GetBucket(hashCode);
+            var last = -1;
+            var i = _buckets[bucket] - 1;
+            while (i >= 0)
+            {
+                ref var entry = ref _entries[i];
+                if (entry.HashCode == hashCode && _comparer.Equals(entry.Key, key))
+                {
+                    // unlink from the chain
+                    if (last < 0)
+                    {
+                        _buckets[bucket] = entry.Next + 1;
+                    }
+                    else
+                    {
+                        _entries[last].Next = entry.Next;
+                    }
+
+                    value = entry.Value;
+
+                    // and push to the free list, clearing the references
+                    // so we won't keep the objects alive
+                    entry.Next = StartOfFreeList - _freeList;
+                    if (RuntimeHelpers.IsReferenceOrContainsReferences<TKey>())
+                    {
+                        entry.Key = default;
+                    }
+                    if (RuntimeHelpers.IsReferenceOrContainsReferences<TValue>())
+                    {
+                        entry.Value = default;
+                    }
+                    _freeList = i;
+                    _freeCount++;
+                    _version++;
+                    return true;
+                }
+
+                last = i;
+                i = entry.Next;
+            }
+        }
+
+        value = default;
+        return false;
+    }
+
+    public void Clear()
+    {
+        if (_count == 0)
+            return;
+
+        Array.Clear(_buckets);
+        Array.Clear(_entries, 0, _count);
+        _count = 0;
+        _freeList = -1;
+        _freeCount = 0;
+        _version++;
+    }
+
+    #endregion
+
+    #region Enumeration
+
+    public Enumerator GetEnumerator()
+    {
+        return new Enumerator(this);
+    }
+
+    IEnumerator<KeyValuePair<TKey, TValue>> IEnumerable<KeyValuePair<TKey, TValue>>.GetEnumerator()
+    {
+        return new Enumerator(this);
+    }
+
+    IEnumerator IEnumerable.GetEnumerator()
+    {
+        return new Enumerator(this);
+    }
+
+    public struct Enumerator : IEnumerator<KeyValuePair<TKey, TValue>>
+    {
+
+        private readonly Dictionary<TKey, TValue> _dictionary;
+        private readonly int _version;
+        private int _index;
+
+        public KeyValuePair<TKey, TValue> Current { get; private set; }
+
+        object IEnumerator.Current
+        {
+            get
+            {
+                if (_index == 0 || _index == _dictionary._count + 1)
+                {
+                    throw new InvalidOperationException("Enumeration has either not started or has already finished.");
+                }
+                return Current;
+            }
+        }
+
+        internal Enumerator(Dictionary<TKey, TValue> dictionary)
+        {
+            _dictionary = dictionary;
+            _version = dictionary._version;
+            _index = 0;
+            Current = default;
+        }
+
+        public void Dispose()
+        {
+        }
+
+        public bool MoveNext()
+        {
+            if (_version != _dictionary._version)
+                throw new InvalidOperationException("Collection was modified; enumeration operation may not execute.");
+
+            // skip the entries that are on the free list
+            while ((uint)_index < (uint)_dictionary._count)
+            {
+                ref var entry = ref _dictionary._entries[_index++];
+                if (entry.Next >= -1)
+                {
+                    Current = new KeyValuePair<TKey, TValue>(entry.Key, entry.Value);
+                    return true;
+                }
+            }
+
+            _index = _dictionary._count + 1;
+            Current = default;
+            return false;
+        }
+
+        public void Reset()
+        {
+            if (_version != _dictionary._version)
+                throw new InvalidOperationException("Collection was modified; enumeration operation may not execute.");
+            _index = 0;
+            Current = default;
+        }
+    }
+
+    #endregion
+
 }
\ No newline at end of file
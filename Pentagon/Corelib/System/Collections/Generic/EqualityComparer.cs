@@ -0,0 +1,95 @@
+using System.Runtime.CompilerServices;
+
+namespace System.Collections.Generic;
+
+public abstract class EqualityComparer<T> : IEqualityComparer<T>
+{
+
+    /// <summary>
+    /// The comparer used by the collections when none is given, primitive types get a
+    /// comparer that works on the raw value, everything else goes through IEquatable&lt;T&gt;
+    /// when the type implements it and Equals(object) otherwise
+    /// </summary>
+    public static EqualityComparer<T> Default { get; } = CreateDefault();
+
+    public abstract bool Equals(T x, T y);
+
+    public abstract int GetHashCode(T obj);
+
+    private static EqualityComparer<T> CreateDefault()
+    {
+        // this is a constant for the jit, and is only true for the primitive
+        // integer types, for these we don't want to box every key on lookup
+        if (RuntimeHelpers.IsBitwiseEquatable<T>())
+        {
+            return new BitwiseEqualityComparer<T>();
+        }
+        
+        return new ObjectEqualityComparer<T>();
+    }
+
+}
+
+/// <summary>
+/// Compares the values by their bits, only valid for types where that is the same as Equals
+/// </summary>
+internal sealed class BitwiseEqualityComparer<T> : EqualityComparer<T>
+{
+
+    private readonly int _size = Unsafe.SizeOf<T>();
+
+    public override unsafe bool Equals(T x, T y)
+    {
+        var a = Unsafe.AsPointer(ref x);
+        var b = Unsafe.AsPointer(ref y);
+        switch (_size)
+        {
+            case 1: return *(byte*)a == *(byte*)b;
+            case 2: return *(ushort*)a == *(ushort*)b;
+            case 4: return *(uint*)a == *(uint*)b;
+            default: return *(ulong*)a == *(ulong*)b;
+        }
+    }
+
+    public override unsafe int GetHashCode(T obj)
+    {
+        var ptr = Unsafe.AsPointer(ref obj);
+        switch (_size)
+        {
+            case 1: return *(byte*)ptr;
+            case 2: return *(ushort*)ptr;
+            case 4: return *(int*)ptr;
+            default:
+                var value = *(ulong*)ptr;
+                return (int)value ^ (int)(value >> 32);
+        }
+    }
+    
+}
+
+internal sealed class ObjectEqualityComparer<T> : EqualityComparer<T>
+{
+
+    public override bool Equals(T x, T y)
+    {
+        if (x != null)
+        {
+            if (y == null)
+                return false;
+
+            // prefer the typed Equals, for structs it does not need
+            // to box the other value to compare them
+            if (x is IEquatable<T> equatable)
+                return equatable.Equals(y);
+
+            return x.Equals(y);
+        }
+        return y == null;
+    }
+
+    public override int GetHashCode(T obj)
+    {
+        return obj?.GetHashCode() ?? 0;
+    }
+    
+}
\ No newline at end of file
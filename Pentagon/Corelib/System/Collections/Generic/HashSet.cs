@@ -0,0 +1,372 @@
+using System.Runtime.CompilerServices;
+
+namespace System.Collections.Generic;
+
+/// <summary>
+/// A set with the same layout as the Dictionary, an array of entries that are
+/// chained from a power of two bucket array
+/// </summary>
+public class HashSet<T> : ICollection<T>
+{
+
+    private const int DefaultCapacity = 4;
+    private const int StartOfFreeList = -3;
+
+    private struct Entry
+    {
+        public uint HashCode;
+
+        // the next entry in the chain, -1 at the end of the chain
+        public int Next;
+
+        public T Value;
+    }
+
+    // one-based index into the entries, zero means the bucket is empty
+    private int[] _buckets;
+    private Entry[] _entries;
+    private int _shift;
+
+    private int _count;
+    private int _freeList;
+    private int _freeCount;
+    private int _version;
+
+    private readonly IEqualityComparer<T> _comparer;
+
+    public int Count => _count - _freeCount;
+
+    public bool IsReadOnly => false;
+
+    public IEqualityComparer<T> Comparer => _comparer;
+
+    public HashSet()
+        : this(0, null)
+    {
+    }
+
+    public HashSet(int capacity)
+        : this(capacity, null)
+    {
+    }
+
+    public HashSet(IEqualityComparer<T> comparer)
+        : this(0, comparer)
+    {
+    }
+
+    public HashSet(int capacity, IEqualityComparer<T> comparer)
+    {
+        if (capacity < 0) throw new ArgumentOutOfRangeException(nameof(capacity), "Non-negative number required.");
+
+        _comparer = comparer ?? EqualityComparer<T>.Default;
+        _freeList = -1;
+
+        if (capacity > 0)
+        {
+            Initialize(capacity);
+        }
+    }
+
+    #region Hashing
+
+    private void Initialize(int capacity)
+    {
+        var size = DefaultCapacity;
+        var log = 2;
+        while (size < capacity)
+        {
+            size *= 2;
+            log++;
+        }
+
+        _buckets = new int[size];
+        _entries = new Entry[size];
+        _shift = 32 - log;
+        _freeList = -1;
+    }
+
+    private int GetBucket(uint hashCode)
+    {
+        return (int)((hashCode * 0x9E3779B9u) >> _shift);
+    }
+
+    private void Resize()
+    {
+        var newSize = _entries.Length * 2;
+        if ((uint)newSize > Array.MaxLength)
+            throw new InvalidOperationException("HashSet capacity overflow.");
+
+        var entries = new Entry[newSize];
+        Array.Copy(_entries, entries, _count);
+
+        _buckets = new int[newSize];
+        _entries = entries;
+        _shift--;
+
+        // rechain all the live entries, the free list stays as is
+        for (var i = 0; i < _count; i++)
+        {
+            if (entries[i].Next < -1)
+                continue;
+
+            var bucket = GetBucket(entries[i].HashCode);
+            entries[i].Next = _buckets[bucket] - 1;
+            _buckets[bucket] = i + 1;
+        }
+    }
+
+    #endregion
+
+    private int FindItem(T item)
+    {
+        if (_buckets == null)
+            return -1;
+
+        var hashCode = item == null ? 0 : (uint)_comparer.GetHashCode(item);
+        var entries = _entries;
+        var i = _buckets[GetBucket(hashCode)] - 1;
+        while (i >= 0)
+        {
+            ref var entry = ref entries[i];
+            if (entry.HashCode == hashCode && _comparer.Equals(entry.Value, item))
+                return i;
+            i = entry.Next;
+        }
+
+        return -1;
+    }
+
+    public bool Contains(T item)
+    {
+        return FindItem(item) >= 0;
+    }
+
+    public bool TryGetValue(T equalValue, out T actualValue)
+    {
+        var i = FindItem(equalValue);
+        if (i >= 0)
+        {
+            actualValue = _entries[i].Value;
+            return true;
+        }
+
+        actualValue = default;
+        return false;
+    }
+
+    /// <summary>
+    /// Add the item to the set
+    /// </summary>
+    /// <returns>false if the item was already in the set</returns>
+    public bool Add(T item)
+    {
+        if (_buckets == null)
+        {
+            Initialize(0);
+        }
+
+        var hashCode = item == null ? 0 : (uint)_comparer.GetHashCode(item);
+        var i = _buckets[GetBucket(hashCode)] - 1;
+        while (i >= 0)
+        {
+            ref var entry = ref _entries[i];
+            if (entry.HashCode == hashCode && _comparer.Equals(entry.Value, item))
+                return false;
+            i = entry.Next;
+        }
+
+        int index;
+        if (_freeCount > 0)
+        {
+            index = _freeList;
+            _freeList = StartOfFreeList - _entries[index].Next;
+            _freeCount--;
+        }
+        else
+        {
+            if (_count == _entries.Length)
+            {
+                Resize();
+            }
+            index = _count;
+            _count++;
+        }
+
+        var bucket = GetBucket(hashCode);
+        ref var newEntry = ref _entries[index];
+        newEntry.HashCode = hashCode;
+        newEntry.Next = _buckets[bucket] - 1;
+        newEntry.Value = item;
+        _buckets[bucket] = index + 1;
+        _version++;
+        return true;
+    }
+
+    void ICollection<T>.Add(T item)
+    {
+        Add(item);
+    }
+
+    public void UnionWith(IEnumerable<T> other)
+    {
+        if (other == null) throw new ArgumentNullException(nameof(other));
+
+        foreach (var item in other)
+        {
+            Add(item);
+        }
+    }
+
+    public bool Remove(T item)
+    {
+        if (_buckets == null)
+            return false;
+
+        var hashCode = item == null ? 0 : (uint)_comparer.GetHashCode(item);
+        var bucket = GetBucket(hashCode);
+        var last = -1;
+        var i = _buckets[bucket] - 1;
+        while (i >= 0)
+        {
+            ref var entry = ref _entries[i];
+            if (entry.HashCode == hashCode && _comparer.Equals(entry.Value, item))
+            {
+                if (last < 0)
+                {
+                    _buckets[bucket] = entry.Next + 1;
+                }
+                else
+                {
+                    _entries[last].Next = entry.Next;
+                }
+
+                entry.Next = StartOfFreeList - _freeList;
+                if (RuntimeHelpers.IsReferenceOrContainsReferences<T>())
+                {
+                    entry.Value = default;
+                }
+                _freeList = i;
+                _freeCount++;
+                _version++;
+                return true;
+            }
+
+            last = i;
+            i = entry.Next;
+        }
+
+        return false;
+    }
+
+    public void Clear()
+    {
+        if (_count == 0)
+            return;
+
+        Array.Clear(_buckets);
+        Array.Clear(_entries, 0, _count);
+        _count = 0;
+        _freeList = -1;
+        _freeCount = 0;
+        _version++;
+    }
+
+    public void CopyTo(T[] array, int arrayIndex)
+    {
+        if (array == null) throw new ArgumentNullException(nameof(array));
+        if (arrayIndex < 0) throw new ArgumentOutOfRangeException(nameof(arrayIndex), "Non-negative number required.");
+        if (array.Length - arrayIndex < Count) throw new ArgumentException("Destination array is not long enough to copy all the items in the collection.");
+
+        for (var i = 0; i < _count; i++)
+        {
+            if (_entries[i].Next >= -1)
+            {
+                array[arrayIndex++] = _entries[i].Value;
+            }
+        }
+    }
+
+    #region Enumeration
+
+    public Enumerator GetEnumerator()
+    {
+        return new Enumerator(this);
+    }
+
+    IEnumerator<T> IEnumerable<T>.GetEnumerator()
+    {
+        return new Enumerator(this);
+    }
+
+    IEnumerator IEnumerable.GetEnumerator()
+    {
+        return new Enumerator(this);
+    }
+
+    public struct Enumerator : IEnumerator<T>
+    {
+
+        private readonly HashSet<T> _set;
+        private readonly int _version;
+        private int _index;
+
+        public T Current { get; private set; }
+
+        object IEnumerator.Current
+        {
+            get
+            {
+                if (_index == 0 || _index == _set._count + 1)
+                {
+                    throw new InvalidOperationException("Enumeration has either not started or has already finished.");
+                }
+                return Current;
+            }
+        }
+
+        internal Enumerator(HashSet<T> set)
+        {
+            _set = set;
+            _version = set._version;
+            _index = 0;
+            Current = default;
+        }
+
+        public void Dispose()
+        {
+        }
+
+        public bool MoveNext()
+        {
+            if (_version != _set._version)
+                throw new InvalidOperationException("Collection was modified; enumeration operation may not execute.");
+
+            // skip the entries that are on the free list
+            while ((uint)_index < (uint)_set._count)
+            {
+                ref var entry = ref _set._entries[_index++];
+                if (entry.Next >= -1)
+                {
+                    Current = entry.Value;
+                    return true;
+                }
+            }
+
+            _index = _set._count + 1;
+            Current = default;
+            return false;
+        }
+
+        public void Reset()
+        {
+            if (_version != _set._version)
+                throw new InvalidOperationException("Collection was modified; enumeration operation may not execute.");
+            _index = 0;
+            Current = default;
+        }
+    }
+
+    #endregion
+
+}
\ No newline at end of file
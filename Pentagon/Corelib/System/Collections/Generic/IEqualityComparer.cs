@@ -0,0 +1,10 @@
+namespace System.Collections.Generic;
+
+public interface IEqualityComparer<in T>
+{
+
+    public bool Equals(T x, T y);
+
+    public int GetHashCode(T obj);
+
+}
\ No newline at end of file
@@ -0,0 +1,20 @@
+using System.Runtime.CompilerServices;
+
+namespace System.Diagnostics;
+
+public static class Debug
+{
+
+    /// <summary>
+    /// Reports a failure that has nobody to be thrown to, the kernel prints it
+    /// and the caller keeps going
+    /// </summary>
+    public static void Fail(string message)
+    {
+        WriteFailure(message ?? string.Empty);
+    }
+
+    [MethodImpl(MethodImplOptions.InternalCall)]
+    private static extern void WriteFailure(string message);
+
+}
\ No newline at end of file
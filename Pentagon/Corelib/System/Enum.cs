@@ -1,3 +1,18 @@
 namespace System;
 
-public abstract class Enum : ValueType { }
\ No newline at end of file
+public abstract class Enum : ValueType
+{
+
+    // an enum is a single integer field, so there are no references to look at
+
+    public override bool Equals(object obj)
+    {
+        return ValueDataEquals(this, obj);
+    }
+
+    public override int GetHashCode()
+    {
+        return GetValueDataHashCode(this);
+    }
+
+}
\ No newline at end of file
@@ -0,0 +1,16 @@
+using System.Runtime.CompilerServices;
+
+namespace System;
+
+public static class Environment
+{
+
+    /// <summary>
+    /// The amount of cpus the kernel is running on
+    /// </summary>
+    public static int ProcessorCount { get; } = GetProcessorCount();
+
+    [MethodImpl(MethodImplOptions.InternalCall)]
+    private static extern int GetProcessorCount();
+
+}
\ No newline at end of file
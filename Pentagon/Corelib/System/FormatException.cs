@@ -0,0 +1,24 @@
+using System.Runtime.InteropServices;
+
+namespace System;
+
+[StructLayout(LayoutKind.Sequential)]
+public class FormatException : SystemException
+{
+
+    public FormatException()
+        : base("One of the identified items was in an invalid format.")
+    {
+    }
+
+    public FormatException(string message)
+        : base(message)
+    {
+    }
+
+    public FormatException(string message, Exception innerException)
+        : base(message, innerException)
+    {
+    }
+
+}
\ No newline at end of file
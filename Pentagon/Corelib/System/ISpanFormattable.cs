@@ -0,0 +1,16 @@
+namespace System;
+
+/// <summary>
+/// A value that can format itself straight into a span of chars, without
+/// allocating a string on the way
+/// </summary>
+public interface ISpanFormattable
+{
+
+    /// <summary>
+    /// Format the value into the destination
+    /// </summary>
+    /// <returns>false if the destination is too small, in which case nothing is written</returns>
+    public bool TryFormat(Span<char> destination, out int charsWritten, string format = null);
+
+}
\ No newline at end of file
@@ -1,6 +1,6 @@
 namespace System;
 
-public readonly struct Int16
+public readonly struct Int16 : ISpanFormattable
 {
 
     public const short MaxValue = 32767;
@@ -26,7 +26,17 @@ public readonly struct Int16
 
     public override string ToString()
     {
-        return "";
+        return Number.Int16ToString(_value, null);
+    }
+
+    public string ToString(string format)
+    {
+        return Number.Int16ToString(_value, format);
+    }
+
+    public bool TryFormat(Span<char> destination, out int charsWritten, string format = null)
+    {
+        return Number.TryFormatInt16(_value, format, destination, out charsWritten);
     }
 
 }
\ No newline at end of file
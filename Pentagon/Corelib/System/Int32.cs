@@ -1,6 +1,6 @@
 namespace System;
 
-public readonly struct Int32
+public readonly struct Int32 : ISpanFormattable
 {
     
     public const int MaxValue = 2147483647;
@@ -31,7 +31,17 @@ public readonly struct Int32
 
     public override string ToString()
     {
-        return "";
+        return Number.Int32ToString(_value, null);
+    }
+
+    public string ToString(string format)
+    {
+        return Number.Int32ToString(_value, format);
+    }
+
+    public bool TryFormat(Span<char> destination, out int charsWritten, string format = null)
+    {
+        return Number.TryFormatInt32(_value, format, destination, out charsWritten);
     }
     
 }
\ No newline at end of file
@@ -1,6 +1,6 @@
 namespace System;
 
-public readonly struct Int64
+public readonly struct Int64 : ISpanFormattable
 {
     
     public const long MaxValue = 9223372036854775807;
@@ -26,7 +26,17 @@ public readonly struct Int64
 
     public override string ToString()
     {
-        return "";
+        return Number.Int64ToString(_value, null);
+    }
+
+    public string ToString(string format)
+    {
+        return Number.Int64ToString(_value, format);
+    }
+
+    public bool TryFormat(Span<char> destination, out int charsWritten, string format = null)
+    {
+        return Number.TryFormatInt64(_value, format, destination, out charsWritten);
     }
     
 }
\ No newline at end of file
@@ -30,7 +30,7 @@ public static class MemoryExtensions
     #region AsSpan
 
     // TODO: readonly span...
-    internal static Span<char> AsSpan(this string text)
+    public static Span<char> AsSpan(this string text)
     {
         return text == null ? Span<char>.Empty : new Span<char>(text.GetDataPtr(), text.Length);
     }
@@ -54,5 +54,207 @@ public static class MemoryExtensions
     }    
 
     #endregion
+
+    #region Search
+
+    public static int IndexOf<T>(this Span<T> span, T value)
+        where T : IEquatable<T>
+    {
+        if (RuntimeHelpers.IsBitwiseEquatable<T>())
+        {
+            return Buffer.IndexOf(span._ptr, (ulong)span.Length, (ulong)Unsafe.SizeOf<T>(), Unsafe.AsPointer(ref value));
+        }
+
+        for (var i = 0; i < span.Length; i++)
+        {
+            if (span[i].Equals(value))
+            {
+                return i;
+            }
+        }
+        return -1;
+    }
+
+    public static bool SequenceEqual<T>(this Span<T> span, Span<T> other)
+        where T : IEquatable<T>
+    {
+        if (span.Length != other.Length)
+        {
+            return false;
+        }
+
+        if (RuntimeHelpers.IsBitwiseEquatable<T>())
+        {
+            return Buffer.SequenceEqual(span._ptr, other._ptr, (ulong)span.Length * (ulong)Unsafe.SizeOf<T>());
+        }
+
+        for (var i = 0; i < span.Length; i++)
+        {
+            if (!span[i].Equals(other[i]))
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    #endregion
+
+    #region TryWrite
+
+    /// <summary>
+    /// Format an interpolated string straight into the destination
+    /// </summary>
+    /// <returns>false if the destination is too small, charsWritten is zero in that case</returns>
+    public static bool TryWrite(this Span<char> destination, [InterpolatedStringHandlerArgument("destination")] ref TryWriteInterpolatedStringHandler handler, out int charsWritten)
+    {
+        if (handler._success)
+        {
+            charsWritten = handler._pos;
+            return true;
+        }
+
+        charsWritten = 0;
+        return false;
+    }
+
+    /// <summary>
+    /// Writes the parts into the destination span, once a part does not fit the rest are
+    /// skipped by the compiler since every append returns false from then on
+    /// </summary>
+    [InterpolatedStringHandler]
+    public ref struct TryWriteInterpolatedStringHandler
+    {
+
+        private readonly Span<char> _destination;
+        internal int _pos;
+        internal bool _success;
+
+        public TryWriteInterpolatedStringHandler(int literalLength, int formattedCount, Span<char> destination, out bool shouldAppend)
+        {
+            _destination = destination;
+            _pos = 0;
+            _success = shouldAppend = destination.Length >= literalLength;
+        }
+
+        private bool Fail()
+        {
+            _success = false;
+            return false;
+        }
+
+        public bool AppendLiteral(string value) => AppendFormatted(value.AsSpan());
+
+        public bool AppendFormatted(string value) => AppendFormatted(value.AsSpan());
+
+        public bool AppendFormatted(Span<char> value)
+        {
+            if (!value.TryCopyTo(_destination.Slice(_pos)))
+                return Fail();
+
+            _pos += value.Length;
+            return true;
+        }
+
+        public bool AppendFormatted(char value)
+        {
+            if (_pos == _destination.Length)
+                return Fail();
+
+            _destination[_pos++] = value;
+            return true;
+        }
+
+        public bool AppendFormatted(bool value) => AppendFormatted(value ? bool.TrueString : bool.FalseString);
+
+        public bool AppendFormatted(int value, string format = null)
+        {
+            if (!value.TryFormat(_destination.Slice(_pos), out var charsWritten, format))
+                return Fail();
+
+            _pos += charsWritten;
+            return true;
+        }
+
+        public bool AppendFormatted(uint value, string format = null)
+        {
+            if (!value.TryFormat(_destination.Slice(_pos), out var charsWritten, format))
+                return Fail();
+
+            _pos += charsWritten;
+            return true;
+        }
+
+        public bool AppendFormatted(long value, string format = null)
+        {
+            if (!value.TryFormat(_destination.Slice(_pos), out var charsWritten, format))
+                return Fail();
+
+            _pos += charsWritten;
+            return true;
+        }
+
+        public bool AppendFormatted(ulong value, string format = null)
+        {
+            if (!value.TryFormat(_destination.Slice(_pos), out var charsWritten, format))
+                return Fail();
+
+            _pos += charsWritten;
+            return true;
+        }
+
+        public bool AppendFormatted(byte value, string format = null)
+        {
+            if (!value.TryFormat(_destination.Slice(_pos), out var charsWritten, format))
+                return Fail();
+
+            _pos += charsWritten;
+            return true;
+        }
+
+        public bool AppendFormatted(sbyte value, string format = null)
+        {
+            if (!value.TryFormat(_destination.Slice(_pos), out var charsWritten, format))
+                return Fail();
+
+            _pos += charsWritten;
+            return true;
+        }
+
+        public bool AppendFormatted(short value, string format = null)
+        {
+            if (!value.TryFormat(_destination.Slice(_pos), out var charsWritten, format))
+                return Fail();
+
+            _pos += charsWritten;
+            return true;
+        }
+
+        public bool AppendFormatted(ushort value, string format = null)
+        {
+            if (!value.TryFormat(_destination.Slice(_pos), out var charsWritten, format))
+                return Fail();
+
+            _pos += charsWritten;
+            return true;
+        }
+
+        public bool AppendFormatted<T>(T value, string format = null)
+        {
+            if (value is ISpanFormattable formattable)
+            {
+                if (!formattable.TryFormat(_destination.Slice(_pos), out var charsWritten, format))
+                    return Fail();
+
+                _pos += charsWritten;
+                return true;
+            }
+
+            return AppendFormatted(value?.ToString());
+        }
+
+    }
+
+    #endregion
     
 }
\ No newline at end of file
@@ -0,0 +1,201 @@
+namespace System;
+
+/// <summary>
+/// Formatting of the integer types. The digits are written straight into the destination, so
+/// formatting into a buffer never allocates, and ToString allocates only the result string.
+/// We support the decimal (D) and hex (X/x) formats, with an optional minimum amount of digits.
+/// </summary>
+internal static class Number
+{
+
+    private const string UpperHexDigits = "0123456789ABCDEF";
+    private const string LowerHexDigits = "0123456789abcdef";
+
+    private struct Format
+    {
+        // 'D', 'X' or 'x'
+        public char Kind;
+        public int MinDigits;
+    }
+
+    private static Format ParseFormat(string format)
+    {
+        var result = new Format { Kind = 'D' };
+        if (string.IsNullOrEmpty(format))
+            return result;
+
+        var kind = format[0];
+        if (kind == 'd')
+            kind = 'D';
+        if (kind != 'D' && kind != 'X' && kind != 'x')
+            throw new FormatException("Format specifier was invalid.");
+        result.Kind = kind;
+
+        for (var i = 1; i < format.Length; i++)
+        {
+            var c = format[i];
+            if (c < '0' || c > '9' || result.MinDigits >= 100)
+                throw new FormatException("Format specifier was invalid.");
+            result.MinDigits = result.MinDigits * 10 + (c - '0');
+        }
+
+        return result;
+    }
+
+    private static int CountDigits(ulong value, Format format)
+    {
+        var digits = 1;
+        if (format.Kind == 'D')
+        {
+            while (value >= 10)
+            {
+                value /= 10;
+                digits++;
+            }
+        }
+        else
+        {
+            while (value >= 16)
+            {
+                value >>= 4;
+                digits++;
+            }
+        }
+
+        return digits < format.MinDigits ? format.MinDigits : digits;
+    }
+
+    private static bool TryFormat(ulong magnitude, bool negative, Format format, Span<char> destination, out int charsWritten)
+    {
+        var length = CountDigits(magnitude, format) + (negative ? 1 : 0);
+        if (length > destination.Length)
+        {
+            charsWritten = 0;
+            return false;
+        }
+
+        // fill from the end, the padding is just more zero digits
+        var start = 0;
+        if (negative)
+        {
+            destination[0] = '-';
+            start = 1;
+        }
+
+        if (format.Kind == 'D')
+        {
+            for (var i = length - 1; i >= start; i--)
+            {
+                destination[i] = (char)('0' + (int)(magnitude % 10));
+                magnitude /= 10;
+            }
+        }
+        else
+        {
+            var digits = format.Kind == 'X' ? UpperHexDigits : LowerHexDigits;
+            for (var i = length - 1; i >= start; i--)
+            {
+                destination[i] = digits[(int)(magnitude & 0xF)];
+                magnitude >>= 4;
+            }
+        }
+
+        charsWritten = length;
+        return true;
+    }
+
+    private static string ToString(ulong magnitude, bool negative, Format format)
+    {
+        var str = string.FastAllocateString(CountDigits(magnitude, format) + (negative ? 1 : 0));
+        TryFormat(magnitude, negative, format, str.AsSpan(), out _);
+        return str;
+    }
+
+    #region Signed
+
+    // in hex signed values are formatted as their two's complement, like "X" of -1 being FFFFFFFF
+
+    public static bool TryFormatInt32(int value, string format, Span<char> destination, out int charsWritten)
+    {
+        var f = ParseFormat(format);
+        if (f.Kind != 'D')
+            return TryFormat((uint)value, false, f, destination, out charsWritten);
+        return TryFormat(value < 0 ? (ulong)-(long)value : (ulong)value, value < 0, f, destination, out charsWritten);
+    }
+
+    public static string Int32ToString(int value, string format)
+    {
+        var f = ParseFormat(format);
+        if (f.Kind != 'D')
+            return ToString((uint)value, false, f);
+        return ToString(value < 0 ? (ulong)-(long)value : (ulong)value, value < 0, f);
+    }
+
+    public static bool TryFormatInt64(long value, string format, Span<char> destination, out int charsWritten)
+    {
+        // negating MinValue gives MinValue back, which as unsigned is the right magnitude
+        var f = ParseFormat(format);
+        if (f.Kind != 'D')
+            return TryFormat(unchecked((ulong)value), false, f, destination, out charsWritten);
+        return TryFormat(value < 0 ? unchecked((ulong)-value) : (ulong)value, value < 0, f, destination, out charsWritten);
+    }
+
+    public static string Int64ToString(long value, string format)
+    {
+        var f = ParseFormat(format);
+        if (f.Kind != 'D')
+            return ToString(unchecked((ulong)value), false, f);
+        return ToString(value < 0 ? unchecked((ulong)-value) : (ulong)value, value < 0, f);
+    }
+
+    // the narrower types are formatted in hex as their own width, like "X" of (short)-1 being FFFF
+
+    public static bool TryFormatInt16(short value, string format, Span<char> destination, out int charsWritten)
+    {
+        var f = ParseFormat(format);
+        if (f.Kind != 'D')
+            return TryFormat((ushort)value, false, f, destination, out charsWritten);
+        return TryFormat(value < 0 ? (ulong)-value : (ulong)value, value < 0, f, destination, out charsWritten);
+    }
+
+    public static string Int16ToString(short value, string format)
+    {
+        var f = ParseFormat(format);
+        if (f.Kind != 'D')
+            return ToString((ushort)value, false, f);
+        return ToString(value < 0 ? (ulong)-value : (ulong)value, value < 0, f);
+    }
+
+    public static bool TryFormatSByte(sbyte value, string format, Span<char> destination, out int charsWritten)
+    {
+        var f = ParseFormat(format);
+        if (f.Kind != 'D')
+            return TryFormat((byte)value, false, f, destination, out charsWritten);
+        return TryFormat(value < 0 ? (ulong)-value : (ulong)value, value < 0, f, destination, out charsWritten);
+    }
+
+    public static string SByteToString(sbyte value, string format)
+    {
+        var f = ParseFormat(format);
+        if (f.Kind != 'D')
+            return ToString((byte)value, false, f);
+        return ToString(value < 0 ? (ulong)-value : (ulong)value, value < 0, f);
+    }
+
+    #endregion
+
+    #region Unsigned
+
+    public static bool TryFormatUInt64(ulong value, string format, Span<char> destination, out int charsWritten)
+    {
+        return TryFormat(value, false, ParseFormat(format), destination, out charsWritten);
+    }
+
+    public static string UInt64ToString(ulong value, string format)
+    {
+        return ToString(value, false, ParseFormat(format));
+    }
+
+    #endregion
+
+}
\ No newline at end of file
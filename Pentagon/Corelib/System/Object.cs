@@ -53,7 +53,7 @@ namespace System
 
         public virtual int GetHashCode()
         {
-            return 0;
+            return RuntimeHelpers.GetHashCode(this);
         }
 
         public static bool ReferenceEquals(object objA, object objB)
@@ -0,0 +1,68 @@
+using System.Text;
+
+namespace System.Runtime.CompilerServices;
+
+/// <summary>
+/// Used by the compiler for <c>$"..."</c> strings, the parts are appended to the cached
+/// builder so the only allocation is the final string
+/// </summary>
+[InterpolatedStringHandler]
+public ref struct DefaultInterpolatedStringHandler
+{
+
+    private StringBuilder _builder;
+
+    public DefaultInterpolatedStringHandler(int literalLength, int formattedCount)
+    {
+        // guess about 11 chars (an int) per hole
+        _builder = StringBuilderCache.Acquire(literalLength + formattedCount * 11);
+    }
+
+    public void AppendLiteral(string value) => _builder.Append(value);
+
+    public void AppendFormatted(string value) => _builder.Append(value);
+
+    public void AppendFormatted(Span<char> value) => _builder.Append(value);
+
+    public void AppendFormatted(char value) => _builder.Append(value);
+
+    public void AppendFormatted(bool value) => _builder.Append(value);
+
+    public void AppendFormatted(int value, string format = null) => _builder.Append(value, format);
+
+    public void AppendFormatted(uint value, string format = null) => _builder.Append(value, format);
+
+    public void AppendFormatted(long value, string format = null) => _builder.Append(value, format);
+
+    public void AppendFormatted(ulong value, string format = null) => _builder.Append(value, format);
+
+    public void AppendFormatted(byte value, string format = null) => _builder.Append(value, format);
+
+    public void AppendFormatted(sbyte value, string format = null) => _builder.Append(value, format);
+
+    public void AppendFormatted(short value, string format = null) => _builder.Append(value, format);
+
+    public void AppendFormatted(ushort value, string format = null) => _builder.Append(value, format);
+
+    public void AppendFormatted<T>(T value, string format = null)
+    {
+        if (value is ISpanFormattable formattable)
+        {
+            _builder.Append(formattable, format);
+        }
+        else
+        {
+            _builder.Append(value?.ToString());
+        }
+    }
+
+    public override string ToString() => _builder.ToString();
+
+    public string ToStringAndClear()
+    {
+        var result = StringBuilderCache.GetStringAndRelease(_builder);
+        _builder = null;
+        return result;
+    }
+
+}
\ No newline at end of file
@@ -0,0 +1,19 @@
+namespace System.Runtime.CompilerServices;
+
+[AttributeUsage(AttributeTargets.Parameter, AllowMultiple = false, Inherited = false)]
+public sealed class InterpolatedStringHandlerArgumentAttribute : Attribute
+{
+
+    public string[] Arguments { get; }
+
+    public InterpolatedStringHandlerArgumentAttribute(string argument)
+    {
+        Arguments = new[] { argument };
+    }
+
+    public InterpolatedStringHandlerArgumentAttribute(string[] arguments)
+    {
+        Arguments = arguments;
+    }
+
+}
\ No newline at end of file
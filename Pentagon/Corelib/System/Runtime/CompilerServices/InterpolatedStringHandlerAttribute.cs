@@ -0,0 +1,11 @@
+namespace System.Runtime.CompilerServices;
+
+[AttributeUsage(AttributeTargets.Class | AttributeTargets.Struct, AllowMultiple = false, Inherited = false)]
+public sealed class InterpolatedStringHandlerAttribute : Attribute
+{
+
+    public InterpolatedStringHandlerAttribute()
+    {
+    }
+
+}
\ No newline at end of file
@@ -0,0 +1,24 @@
+namespace System.Runtime.CompilerServices;
+
+public static class RuntimeHelpers
+{
+
+    // both of these are replaced by a constant by the jit
+
+    [MethodImpl(MethodImplOptions.InternalCall)]
+    public static extern bool IsReferenceOrContainsReferences<T>();
+
+    /// <summary>
+    /// True if comparing the bits of two values is the same as calling Equals
+    /// </summary>
+    [MethodImpl(MethodImplOptions.InternalCall)]
+    internal static extern bool IsBitwiseEquatable<T>();
+
+    /// <summary>
+    /// Get a hash based on the identity of the object, objects never move so this
+    /// is stable for the lifetime of the object
+    /// </summary>
+    [MethodImpl(MethodImplOptions.InternalCall)]
+    public static extern int GetHashCode(object o);
+
+}
@@ -8,4 +8,11 @@ public static class Unsafe
     [MethodImpl(MethodImplOptions.InternalCall)]
     public static extern int SizeOf<T>();
 
+    /// <summary>
+    /// Get the address of the value, only valid for as long as the value can't
+    /// move, which means locals or memory that is not on the managed heap
+    /// </summary>
+    [MethodImpl(MethodImplOptions.InternalCall)]
+    internal static extern ulong AsPointer<T>(ref T value);
+
 }
\ No newline at end of file
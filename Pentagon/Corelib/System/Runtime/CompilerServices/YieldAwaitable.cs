@@ -17,8 +17,6 @@ namespace System.Runtime.CompilerServices
     }
     public readonly struct YieldAwaitable
     {
-        public static Action? StupidContinuation;
-
         public YieldAwaiter GetAwaiter() { return default; }
         public readonly struct YieldAwaiter : ICriticalNotifyCompletion, IStateMachineBoxAwareAwaiter
         {
@@ -35,14 +33,15 @@ namespace System.Runtime.CompilerServices
 
             private static void QueueContinuation(Action continuation, bool flowContext)
             {
-                //ArgumentNullException.ThrowIfNull(continuation);
-                //ThreadPool.QueueUserWorkItem(s_waitCallbackRunAction, continuation);
-                StupidContinuation = continuation;
+                if (continuation == null)
+                    throw new ArgumentNullException(nameof(continuation));
+
+                ThreadPool.QueueUserWorkItem(s_waitCallbackRunAction, continuation);
             }
 
             void IStateMachineBoxAwareAwaiter.AwaitUnsafeOnCompleted(IAsyncStateMachineBox box)
             {
-                 //ThreadPool.UnsafeQueueUserWorkItemInternal(box, preferLocal: false);
+                ThreadPool.UnsafeQueueUserWorkItemInternal(box, preferLocal: false);
             }
 
 
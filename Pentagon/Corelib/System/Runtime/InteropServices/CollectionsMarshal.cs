@@ -0,0 +1,18 @@
+using System.Collections.Generic;
+
+namespace System.Runtime.InteropServices;
+
+public static class CollectionsMarshal
+{
+
+    /// <summary>
+    /// Get a reference to the value of the key, adding a default value if the key is missing, this
+    /// saves the second lookup of a TryGetValue followed by an Add. The reference is only valid until
+    /// the dictionary is modified.
+    /// </summary>
+    public static ref TValue GetValueRefOrAddDefault<TKey, TValue>(Dictionary<TKey, TValue> dictionary, TKey key, out bool exists)
+    {
+        return ref dictionary.GetValueRefOrAddDefault(key, out exists);
+    }
+
+}
\ No newline at end of file
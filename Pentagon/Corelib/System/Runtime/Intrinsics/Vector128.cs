@@ -0,0 +1,172 @@
+using System.Runtime.CompilerServices;
+using System.Runtime.InteropServices;
+
+namespace System.Runtime.Intrinsics;
+
+/// <summary>
+/// A 128bit vector, it has the layout of an xmm register so the hardware
+/// intrinsics can pass it by reference straight to the instruction
+/// </summary>
+[StructLayout(LayoutKind.Sequential, Size = 16)]
+public readonly struct Vector128<T> : IEquatable<Vector128<T>>
+    where T : unmanaged
+{
+
+    internal readonly ulong _lower;
+    internal readonly ulong _upper;
+
+    internal Vector128(ulong lower, ulong upper)
+    {
+        _lower = lower;
+        _upper = upper;
+    }
+
+    public static int Count => 16 / Unsafe.SizeOf<T>();
+
+    public static Vector128<T> Zero => default;
+
+    public static Vector128<T> AllBitsSet => new(~0UL, ~0UL);
+
+    public T GetElement(int index)
+    {
+        if ((uint)index >= (uint)Count)
+            throw new ArgumentOutOfRangeException(nameof(index));
+
+        var copy = this;
+        return new Span<T>(Unsafe.AsPointer(ref copy), Count)[index];
+    }
+
+    public T ToScalar()
+    {
+        return GetElement(0);
+    }
+
+    /// <summary>
+    /// Compares the bits, unlike the element wise compare of the intrinsics
+    /// </summary>
+    public bool Equals(Vector128<T> other)
+    {
+        return _lower == other._lower && _upper == other._upper;
+    }
+
+    public override bool Equals(object obj)
+    {
+        return obj is Vector128<T> other && Equals(other);
+    }
+
+    public override int GetHashCode()
+    {
+        return (_lower ^ _upper).GetHashCode();
+    }
+
+    public static bool operator ==(Vector128<T> left, Vector128<T> right)
+    {
+        return left.Equals(right);
+    }
+
+    public static bool operator !=(Vector128<T> left, Vector128<T> right)
+    {
+        return !left.Equals(right);
+    }
+
+}
+
+public static class Vector128
+{
+
+    #region Create
+
+    public static Vector128<byte> Create(byte value)
+    {
+        var bits = value * 0x0101010101010101ul;
+        return new Vector128<byte>(bits, bits);
+    }
+
+    public static Vector128<ushort> Create(ushort value)
+    {
+        var bits = value * 0x0001000100010001ul;
+        return new Vector128<ushort>(bits, bits);
+    }
+
+    public static Vector128<uint> Create(uint value)
+    {
+        var bits = value * 0x0000000100000001ul;
+        return new Vector128<uint>(bits, bits);
+    }
+
+    public static Vector128<ulong> Create(ulong value)
+    {
+        return new Vector128<ulong>(value, value);
+    }
+
+    public static Vector128<ulong> Create(ulong e0, ulong e1)
+    {
+        return new Vector128<ulong>(e0, e1);
+    }
+
+    public static Vector128<uint> CreateScalar(uint value)
+    {
+        return new Vector128<uint>(value, 0);
+    }
+
+    public static Vector128<ulong> CreateScalar(ulong value)
+    {
+        return new Vector128<ulong>(value, 0);
+    }
+
+    /// <summary>
+    /// Load a vector from the start of the span
+    /// </summary>
+    public static Vector128<T> Create<T>(Span<T> values)
+        where T : unmanaged
+    {
+        if (values.Length < Vector128<T>.Count)
+            throw new ArgumentOutOfRangeException(nameof(values));
+
+        return new Span<Vector128<T>>(values._ptr, 1)[0];
+    }
+
+    #endregion
+
+    /// <summary>
+    /// Store the vector to the start of the span
+    /// </summary>
+    public static void CopyTo<T>(this Vector128<T> vector, Span<T> destination)
+        where T : unmanaged
+    {
+        if (destination.Length < Vector128<T>.Count)
+            throw new ArgumentException("Destination is too short.", nameof(destination));
+
+        new Span<Vector128<T>>(destination._ptr, 1)[0] = vector;
+    }
+
+    #region Reinterpret
+
+    public static Vector128<TTo> As<TFrom, TTo>(this Vector128<TFrom> vector)
+        where TFrom : unmanaged
+        where TTo : unmanaged
+    {
+        return new Vector128<TTo>(vector._lower, vector._upper);
+    }
+
+    public static Vector128<byte> AsByte<T>(this Vector128<T> vector) where T : unmanaged => vector.As<T, byte>();
+
+    public static Vector128<sbyte> AsSByte<T>(this Vector128<T> vector) where T : unmanaged => vector.As<T, sbyte>();
+
+    public static Vector128<short> AsInt16<T>(this Vector128<T> vector) where T : unmanaged => vector.As<T, short>();
+
+    public static Vector128<ushort> AsUInt16<T>(this Vector128<T> vector) where T : unmanaged => vector.As<T, ushort>();
+
+    public static Vector128<int> AsInt32<T>(this Vector128<T> vector) where T : unmanaged => vector.As<T, int>();
+
+    public static Vector128<uint> AsUInt32<T>(this Vector128<T> vector) where T : unmanaged => vector.As<T, uint>();
+
+    public static Vector128<long> AsInt64<T>(this Vector128<T> vector) where T : unmanaged => vector.As<T, long>();
+
+    public static Vector128<ulong> AsUInt64<T>(this Vector128<T> vector) where T : unmanaged => vector.As<T, ulong>();
+
+    public static Vector128<float> AsSingle<T>(this Vector128<T> vector) where T : unmanaged => vector.As<T, float>();
+
+    #endregion
+
+}
\ No newline at end of file
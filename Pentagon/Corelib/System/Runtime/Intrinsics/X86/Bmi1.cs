@@ -0,0 +1,121 @@
+using System.Runtime.CompilerServices;
+
+namespace System.Runtime.Intrinsics.X86;
+
+/// <summary>
+/// Only TrailingZeroCount needs the instruction, the rest are plain
+/// arithmetic which the jit emits inline
+/// </summary>
+public abstract class Bmi1 : X86Base
+{
+
+    internal Bmi1()
+    {
+    }
+
+    public static new extern bool IsSupported
+    {
+        [MethodImpl(MethodImplOptions.InternalCall)]
+        get;
+    }
+
+    #region Natives
+
+    [MethodImpl(MethodImplOptions.InternalCall)]
+    private static extern uint AndNot32(uint left, uint right);
+
+    [MethodImpl(MethodImplOptions.InternalCall)]
+    private static extern ulong AndNot64(ulong left, ulong right);
+
+    [MethodImpl(MethodImplOptions.InternalCall)]
+    private static extern uint ExtractLowestSetBit32(uint value);
+
+    [MethodImpl(MethodImplOptions.InternalCall)]
+    private static extern ulong ExtractLowestSetBit64(ulong value);
+
+    [MethodImpl(MethodImplOptions.InternalCall)]
+    private static extern uint GetMaskUpToLowestSetBit32(uint value);
+
+    [MethodImpl(MethodImplOptions.InternalCall)]
+    private static extern ulong GetMaskUpToLowestSetBit64(ulong value);
+
+    [MethodImpl(MethodImplOptions.InternalCall)]
+    private static extern uint ResetLowestSetBit32(uint value);
+
+    [MethodImpl(MethodImplOptions.InternalCall)]
+    private static extern ulong ResetLowestSetBit64(ulong value);
+
+    [MethodImpl(MethodImplOptions.InternalCall)]
+    private static extern uint TrailingZeroCount32(uint value);
+
+    [MethodImpl(MethodImplOptions.InternalCall)]
+    private static extern ulong TrailingZeroCount64(ulong value);
+
+    #endregion
+
+    #region Operations
+
+    public static uint AndNot(uint left, uint right)
+    {
+        return AndNot32(left, right);
+    }
+
+    public static uint ExtractLowestSetBit(uint value)
+    {
+        return ExtractLowestSetBit32(value);
+    }
+
+    public static uint GetMaskUpToLowestSetBit(uint value)
+    {
+        return GetMaskUpToLowestSetBit32(value);
+    }
+
+    public static uint ResetLowestSetBit(uint value)
+    {
+        return ResetLowestSetBit32(value);
+    }
+
+    public static uint TrailingZeroCount(uint value)
+    {
+        return TrailingZeroCount32(value);
+    }
+
+    #endregion
+
+    public abstract class X64
+    {
+
+        internal X64()
+        {
+        }
+
+        public static bool IsSupported => Bmi1.IsSupported;
+
+        public static ulong AndNot(ulong left, ulong right)
+        {
+            return AndNot64(left, right);
+        }
+
+        public static ulong ExtractLowestSetBit(ulong value)
+        {
+            return ExtractLowestSetBit64(value);
+        }
+
+        public static ulong GetMaskUpToLowestSetBit(ulong value)
+        {
+            return GetMaskUpToLowestSetBit64(value);
+        }
+
+        public static ulong ResetLowestSetBit(ulong value)
+        {
+            return ResetLowestSetBit64(value);
+        }
+
+        public static ulong TrailingZeroCount(ulong value)
+        {
+            return TrailingZeroCount64(value);
+        }
+
+    }
+
+}
\ No newline at end of file
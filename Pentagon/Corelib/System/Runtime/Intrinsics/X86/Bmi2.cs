@@ -0,0 +1,85 @@
+using System.Runtime.CompilerServices;
+
+namespace System.Runtime.Intrinsics.X86;
+
+public abstract class Bmi2 : X86Base
+{
+
+    internal Bmi2()
+    {
+    }
+
+    public static new extern bool IsSupported
+    {
+        [MethodImpl(MethodImplOptions.InternalCall)]
+        get;
+    }
+
+    #region Natives
+
+    [MethodImpl(MethodImplOptions.InternalCall)]
+    private static extern uint ZeroHighBits32(uint value, uint index);
+
+    [MethodImpl(MethodImplOptions.InternalCall)]
+    private static extern ulong ZeroHighBits64(ulong value, ulong index);
+
+    [MethodImpl(MethodImplOptions.InternalCall)]
+    private static extern uint ParallelBitDeposit32(uint value, uint mask);
+
+    [MethodImpl(MethodImplOptions.InternalCall)]
+    private static extern ulong ParallelBitDeposit64(ulong value, ulong mask);
+
+    [MethodImpl(MethodImplOptions.InternalCall)]
+    private static extern uint ParallelBitExtract32(uint value, uint mask);
+
+    [MethodImpl(MethodImplOptions.InternalCall)]
+    private static extern ulong ParallelBitExtract64(ulong value, ulong mask);
+
+    #endregion
+
+    #region Operations
+
+    public static uint ZeroHighBits(uint value, uint index)
+    {
+        return ZeroHighBits32(value, index);
+    }
+
+    public static uint ParallelBitDeposit(uint value, uint mask)
+    {
+        return ParallelBitDeposit32(value, mask);
+    }
+
+    public static uint ParallelBitExtract(uint value, uint mask)
+    {
+        return ParallelBitExtract32(value, mask);
+    }
+
+    #endregion
+
+    public abstract class X64
+    {
+
+        internal X64()
+        {
+        }
+
+        public static bool IsSupported => Bmi2.IsSupported;
+
+        public static ulong ZeroHighBits(ulong value, ulong index)
+        {
+            return ZeroHighBits64(value, index);
+        }
+
+        public static ulong ParallelBitDeposit(ulong value, ulong mask)
+        {
+            return ParallelBitDeposit64(value, mask);
+        }
+
+        public static ulong ParallelBitExtract(ulong value, ulong mask)
+        {
+            return ParallelBitExtract64(value, mask);
+        }
+
+    }
+
+}
\ No newline at end of file
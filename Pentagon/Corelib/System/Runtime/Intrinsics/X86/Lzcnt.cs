@@ -0,0 +1,52 @@
+using System.Runtime.CompilerServices;
+
+namespace System.Runtime.Intrinsics.X86;
+
+/// <summary>
+/// The count of zero bits above the highest set bit, the width of the value if it is zero
+/// </summary>
+public abstract class Lzcnt : X86Base
+{
+
+    internal Lzcnt()
+    {
+    }
+
+    public static new extern bool IsSupported
+    {
+        [MethodImpl(MethodImplOptions.InternalCall)]
+        get;
+    }
+
+    #region Natives
+
+    [MethodImpl(MethodImplOptions.InternalCall)]
+    private static extern uint LeadingZeroCount32(uint value);
+
+    [MethodImpl(MethodImplOptions.InternalCall)]
+    private static extern ulong LeadingZeroCount64(ulong value);
+
+    #endregion
+
+    public static uint LeadingZeroCount(uint value)
+    {
+        return LeadingZeroCount32(value);
+    }
+
+    public abstract class X64
+    {
+
+        internal X64()
+        {
+        }
+
+        public static bool IsSupported => Lzcnt.IsSupported;
+
+        public static ulong LeadingZeroCount(ulong value)
+        {
+            return LeadingZeroCount64(value);
+        }
+
+    }
+
+}
\ No newline at end of file
@@ -0,0 +1,49 @@
+using System.Runtime.CompilerServices;
+
+namespace System.Runtime.Intrinsics.X86;
+
+public abstract class Popcnt : Sse42
+{
+
+    internal Popcnt()
+    {
+    }
+
+    public static new extern bool IsSupported
+    {
+        [MethodImpl(MethodImplOptions.InternalCall)]
+        get;
+    }
+
+    #region Natives
+
+    [MethodImpl(MethodImplOptions.InternalCall)]
+    private static extern uint PopCount32(uint value);
+
+    [MethodImpl(MethodImplOptions.InternalCall)]
+    private static extern ulong PopCount64(ulong value);
+
+    #endregion
+
+    public static uint PopCount(uint value)
+    {
+        return PopCount32(value);
+    }
+
+    public new abstract class X64
+    {
+
+        internal X64()
+        {
+        }
+
+        public static bool IsSupported => Popcnt.IsSupported;
+
+        public static ulong PopCount(ulong value)
+        {
+            return PopCount64(value);
+        }
+
+    }
+
+}
\ No newline at end of file
@@ -0,0 +1,102 @@
+using System.Runtime.CompilerServices;
+
+namespace System.Runtime.Intrinsics.X86;
+
+/// <summary>
+/// The packed single precision operations
+/// </summary>
+public abstract class Sse : X86Base
+{
+
+    internal Sse()
+    {
+    }
+
+    public static new extern bool IsSupported
+    {
+        [MethodImpl(MethodImplOptions.InternalCall)]
+        get;
+    }
+
+    #region Natives
+
+    [MethodImpl(MethodImplOptions.InternalCall)]
+    private static extern void AddSingle<T>(out Vector128<T> result, in Vector128<T> left, in Vector128<T> right) where T : unmanaged;
+
+    [MethodImpl(MethodImplOptions.InternalCall)]
+    private static extern void SubtractSingle<T>(out Vector128<T> result, in Vector128<T> left, in Vector128<T> right) where T : unmanaged;
+
+    [MethodImpl(MethodImplOptions.InternalCall)]
+    private static extern void MultiplySingle<T>(out Vector128<T> result, in Vector128<T> left, in Vector128<T> right) where T : unmanaged;
+
+    [MethodImpl(MethodImplOptions.InternalCall)]
+    private static extern void DivideSingle<T>(out Vector128<T> result, in Vector128<T> left, in Vector128<T> right) where T : unmanaged;
+
+    [MethodImpl(MethodImplOptions.InternalCall)]
+    private static extern void MinSingle<T>(out Vector128<T> result, in Vector128<T> left, in Vector128<T> right) where T : unmanaged;
+
+    [MethodImpl(MethodImplOptions.InternalCall)]
+    private static extern void MaxSingle<T>(out Vector128<T> result, in Vector128<T> left, in Vector128<T> right) where T : unmanaged;
+
+    [MethodImpl(MethodImplOptions.InternalCall)]
+    private static extern void SqrtSingle<T>(out Vector128<T> result, in Vector128<T> value) where T : unmanaged;
+
+    #endregion
+
+    #region Arithmetic
+
+    public static Vector128<float> Add(Vector128<float> left, Vector128<float> right)
+    {
+        AddSingle(out var result, left, right);
+        return result;
+    }
+
+    public static Vector128<float> Subtract(Vector128<float> left, Vector128<float> right)
+    {
+        SubtractSingle(out var result, left, right);
+        return result;
+    }
+
+    public static Vector128<float> Multiply(Vector128<float> left, Vector128<float> right)
+    {
+        MultiplySingle(out var result, left, right);
+        return result;
+    }
+
+    public static Vector128<float> Divide(Vector128<float> left, Vector128<float> right)
+    {
+        DivideSingle(out var result, left, right);
+        return result;
+    }
+
+    public static Vector128<float> Min(Vector128<float> left, Vector128<float> right)
+    {
+        MinSingle(out var result, left, right);
+        return result;
+    }
+
+    public static Vector128<float> Max(Vector128<float> left, Vector128<float> right)
+    {
+        MaxSingle(out var result, left, right);
+        return result;
+    }
+
+    public static Vector128<float> Sqrt(Vector128<float> value)
+    {
+        SqrtSingle(out var result, value);
+        return result;
+    }
+
+    public static unsafe Vector128<float> LoadVector128(float* address)
+    {
+        return *(Vector128<float>*)address;
+    }
+
+    public static unsafe void Store(float* address, Vector128<float> source)
+    {
+        *(Vector128<float>*)address = source;
+    }
+
+    #endregion
+
+}
\ No newline at end of file
@@ -0,0 +1,658 @@
+using System.Runtime.CompilerServices;
+
+namespace System.Runtime.Intrinsics.X86;
+
+/// <summary>
+/// The packed integer operations, the vectors are passed by reference to the natives
+/// so the loads and stores are in managed code and are inlined by the jit
+/// </summary>
+public abstract class Sse2 : Sse
+{
+
+    internal Sse2()
+    {
+    }
+
+    public static new extern bool IsSupported
+    {
+        [MethodImpl(MethodImplOptions.InternalCall)]
+        get;
+    }
+
+    #region Natives
+
+    [MethodImpl(MethodImplOptions.InternalCall)]
+    private static extern void Add8<T>(out Vector128<T> result, in Vector128<T> left, in Vector128<T> right) where T : unmanaged;
+
+    [MethodImpl(MethodImplOptions.InternalCall)]
+    private static extern void Add16<T>(out Vector128<T> result, in Vector128<T> left, in Vector128<T> right) where T : unmanaged;
+
+    [MethodImpl(MethodImplOptions.InternalCall)]
+    private static extern void Add32<T>(out Vector128<T> result, in Vector128<T> left, in Vector128<T> right) where T : unmanaged;
+
+    [MethodImpl(MethodImplOptions.InternalCall)]
+    private static extern void Add64<T>(out Vector128<T> result, in Vector128<T> left, in Vector128<T> right) where T : unmanaged;
+
+    [MethodImpl(MethodImplOptions.InternalCall)]
+    private static extern void Subtract8<T>(out Vector128<T> result, in Vector128<T> left, in Vector128<T> right) where T : unmanaged;
+
+    [MethodImpl(MethodImplOptions.InternalCall)]
+    private static extern void Subtract16<T>(out Vector128<T> result, in Vector128<T> left, in Vector128<T> right) where T : unmanaged;
+
+    [MethodImpl(MethodImplOptions.InternalCall)]
+    private static extern void Subtract32<T>(out Vector128<T> result, in Vector128<T> left, in Vector128<T> right) where T : unmanaged;
+
+    [MethodImpl(MethodImplOptions.InternalCall)]
+    private static extern void Subtract64<T>(out Vector128<T> result, in Vector128<T> left, in Vector128<T> right) where T : unmanaged;
+
+    [MethodImpl(MethodImplOptions.InternalCall)]
+    private static extern void AndVector<T>(out Vector128<T> result, in Vector128<T> left, in Vector128<T> right) where T : unmanaged;
+
+    [MethodImpl(MethodImplOptions.InternalCall)]
+    private static extern void OrVector<T>(out Vector128<T> result, in Vector128<T> left, in Vector128<T> right) where T : unmanaged;
+
+    [MethodImpl(MethodImplOptions.InternalCall)]
+    private static extern void XorVector<T>(out Vector128<T> result, in Vector128<T> left, in Vector128<T> right) where T : unmanaged;
+
+    [MethodImpl(MethodImplOptions.InternalCall)]
+    private static extern void AndNotVector<T>(out Vector128<T> result, in Vector128<T> left, in Vector128<T> right) where T : unmanaged;
+
+    [MethodImpl(MethodImplOptions.InternalCall)]
+    private static extern void CompareEqual8<T>(out Vector128<T> result, in Vector128<T> left, in Vector128<T> right) where T : unmanaged;
+
+    [MethodImpl(MethodImplOptions.InternalCall)]
+    private static extern void CompareEqual16<T>(out Vector128<T> result, in Vector128<T> left, in Vector128<T> right) where T : unmanaged;
+
+    [MethodImpl(MethodImplOptions.InternalCall)]
+    private static extern void CompareEqual32<T>(out Vector128<T> result, in Vector128<T> left, in Vector128<T> right) where T : unmanaged;
+
+    [MethodImpl(MethodImplOptions.InternalCall)]
+    private static extern void CompareGreaterThan8<T>(out Vector128<T> result, in Vector128<T> left, in Vector128<T> right) where T : unmanaged;
+
+    [MethodImpl(MethodImplOptions.InternalCall)]
+    private static extern void CompareGreaterThan16<T>(out Vector128<T> result, in Vector128<T> left, in Vector128<T> right) where T : unmanaged;
+
+    [MethodImpl(MethodImplOptions.InternalCall)]
+    private static extern void CompareGreaterThan32<T>(out Vector128<T> result, in Vector128<T> left, in Vector128<T> right) where T : unmanaged;
+
+    [MethodImpl(MethodImplOptions.InternalCall)]
+    private static extern void SumAbsoluteDifferences8<T>(out Vector128<T> result, in Vector128<T> left, in Vector128<T> right) where T : unmanaged;
+
+    [MethodImpl(MethodImplOptions.InternalCall)]
+    private static extern void ShiftLeftLogical16<T>(out Vector128<T> result, in Vector128<T> value, byte count) where T : unmanaged;
+
+    [MethodImpl(MethodImplOptions.InternalCall)]
+    private static extern void ShiftLeftLogical32<T>(out Vector128<T> result, in Vector128<T> value, byte count) where T : unmanaged;
+
+    [MethodImpl(MethodImplOptions.InternalCall)]
+    private static extern void ShiftLeftLogical64<T>(out Vector128<T> result, in Vector128<T> value, byte count) where T : unmanaged;
+
+    [MethodImpl(MethodImplOptions.InternalCall)]
+    private static extern void ShiftRightLogical16<T>(out Vector128<T> result, in Vector128<T> value, byte count) where T : unmanaged;
+
+    [MethodImpl(MethodImplOptions.InternalCall)]
+    private static extern void ShiftRightLogical32<T>(out Vector128<T> result, in Vector128<T> value, byte count) where T : unmanaged;
+
+    [MethodImpl(MethodImplOptions.InternalCall)]
+    private static extern void ShiftRightLogical64<T>(out Vector128<T> result, in Vector128<T> value, byte count) where T : unmanaged;
+
+    [MethodImpl(MethodImplOptions.InternalCall)]
+    private static extern void ShiftRightArithmetic16<T>(out Vector128<T> result, in Vector128<T> value, byte count) where T : unmanaged;
+
+    [MethodImpl(MethodImplOptions.InternalCall)]
+    private static extern void ShiftRightArithmetic32<T>(out Vector128<T> result, in Vector128<T> value, byte count) where T : unmanaged;
+
+    [MethodImpl(MethodImplOptions.InternalCall)]
+    private static extern int MoveMask8(in Vector128<byte> value);
+
+    #endregion
+
+    #region Arithmetic
+
+    public static Vector128<byte> Add(Vector128<byte> left, Vector128<byte> right)
+    {
+        Add8(out var result, left, right);
+        return result;
+    }
+
+    public static Vector128<sbyte> Add(Vector128<sbyte> left, Vector128<sbyte> right)
+    {
+        Add8(out var result, left, right);
+        return result;
+    }
+
+    public static Vector128<short> Add(Vector128<short> left, Vector128<short> right)
+    {
+        Add16(out var result, left, right);
+        return result;
+    }
+
+    public static Vector128<ushort> Add(Vector128<ushort> left, Vector128<ushort> right)
+    {
+        Add16(out var result, left, right);
+        return result;
+    }
+
+    public static Vector128<int> Add(Vector128<int> left, Vector128<int> right)
+    {
+        Add32(out var result, left, right);
+        return result;
+    }
+
+    public static Vector128<uint> Add(Vector128<uint> left, Vector128<uint> right)
+    {
+        Add32(out var result, left, right);
+        return result;
+    }
+
+    public static Vector128<long> Add(Vector128<long> left, Vector128<long> right)
+    {
+        Add64(out var result, left, right);
+        return result;
+    }
+
+    public static Vector128<ulong> Add(Vector128<ulong> left, Vector128<ulong> right)
+    {
+        Add64(out var result, left, right);
+        return result;
+    }
+
+    public static Vector128<byte> Subtract(Vector128<byte> left, Vector128<byte> right)
+    {
+        Subtract8(out var result, left, right);
+        return result;
+    }
+
+    public static Vector128<sbyte> Subtract(Vector128<sbyte> left, Vector128<sbyte> right)
+    {
+        Subtract8(out var result, left, right);
+        return result;
+    }
+
+    public static Vector128<short> Subtract(Vector128<short> left, Vector128<short> right)
+    {
+        Subtract16(out var result, left, right);
+        return result;
+    }
+
+    public static Vector128<ushort> Subtract(Vector128<ushort> left, Vector128<ushort> right)
+    {
+        Subtract16(out var result, left, right);
+        return result;
+    }
+
+    public static Vector128<int> Subtract(Vector128<int> left, Vector128<int> right)
+    {
+        Subtract32(out var result, left, right);
+        return result;
+    }
+
+    public static Vector128<uint> Subtract(Vector128<uint> left, Vector128<uint> right)
+    {
+        Subtract32(out var result, left, right);
+        return result;
+    }
+
+    public static Vector128<long> Subtract(Vector128<long> left, Vector128<long> right)
+    {
+        Subtract64(out var result, left, right);
+        return result;
+    }
+
+    public static Vector128<ulong> Subtract(Vector128<ulong> left, Vector128<ulong> right)
+    {
+        Subtract64(out var result, left, right);
+        return result;
+    }
+
+    #endregion
+
+    #region Bitwise
+
+    public static Vector128<byte> And(Vector128<byte> left, Vector128<byte> right)
+    {
+        AndVector(out var result, left, right);
+        return result;
+    }
+
+    public static Vector128<sbyte> And(Vector128<sbyte> left, Vector128<sbyte> right)
+    {
+        AndVector(out var result, left, right);
+        return result;
+    }
+
+    public static Vector128<short> And(Vector128<short> left, Vector128<short> right)
+    {
+        AndVector(out var result, left, right);
+        return result;
+    }
+
+    public static Vector128<ushort> And(Vector128<ushort> left, Vector128<ushort> right)
+    {
+        AndVector(out var result, left, right);
+        return result;
+    }
+
+    public static Vector128<int> And(Vector128<int> left, Vector128<int> right)
+    {
+        AndVector(out var result, left, right);
+        return result;
+    }
+
+    public static Vector128<uint> And(Vector128<uint> left, Vector128<uint> right)
+    {
+        AndVector(out var result, left, right);
+        return result;
+    }
+
+    public static Vector128<long> And(Vector128<long> left, Vector128<long> right)
+    {
+        AndVector(out var result, left, right);
+        return result;
+    }
+
+    public static Vector128<ulong> And(Vector128<ulong> left, Vector128<ulong> right)
+    {
+        AndVector(out var result, left, right);
+        return result;
+    }
+
+    public static Vector128<byte> Or(Vector128<byte> left, Vector128<byte> right)
+    {
+        OrVector(out var result, left, right);
+        return result;
+    }
+
+    public static Vector128<sbyte> Or(Vector128<sbyte> left, Vector128<sbyte> right)
+    {
+        OrVector(out var result, left, right);
+        return result;
+    }
+
+    public static Vector128<short> Or(Vector128<short> left, Vector128<short> right)
+    {
+        OrVector(out var result, left, right);
+        return result;
+    }
+
+    public static Vector128<ushort> Or(Vector128<ushort> left, Vector128<ushort> right)
+    {
+        OrVector(out var result, left, right);
+        return result;
+    }
+
+    public static Vector128<int> Or(Vector128<int> left, Vector128<int> right)
+    {
+        OrVector(out var result, left, right);
+        return result;
+    }
+
+    public static Vector128<uint> Or(Vector128<uint> left, Vector128<uint> right)
+    {
+        OrVector(out var result, left, right);
+        return result;
+    }
+
+    public static Vector128<long> Or(Vector128<long> left, Vector128<long> right)
+    {
+        OrVector(out var result, left, right);
+        return result;
+    }
+
+    public static Vector128<ulong> Or(Vector128<ulong> left, Vector128<ulong> right)
+    {
+        OrVector(out var result, left, right);
+        return result;
+    }
+
+    public static Vector128<byte> Xor(Vector128<byte> left, Vector128<byte> right)
+    {
+        XorVector(out var result, left, right);
+        return result;
+    }
+
+    public static Vector128<sbyte> Xor(Vector128<sbyte> left, Vector128<sbyte> right)
+    {
+        XorVector(out var result, left, right);
+        return result;
+    }
+
+    public static Vector128<short> Xor(Vector128<short> left, Vector128<short> right)
+    {
+        XorVector(out var result, left, right);
+        return result;
+    }
+
+    public static Vector128<ushort> Xor(Vector128<ushort> left, Vector128<ushort> right)
+    {
+        XorVector(out var result, left, right);
+        return result;
+    }
+
+    public static Vector128<int> Xor(Vector128<int> left, Vector128<int> right)
+    {
+        XorVector(out var result, left, right);
+        return result;
+    }
+
+    public static Vector128<uint> Xor(Vector128<uint> left, Vector128<uint> right)
+    {
+        XorVector(out var result, left, right);
+        return result;
+    }
+
+    public static Vector128<long> Xor(Vector128<long> left, Vector128<long> right)
+    {
+        XorVector(out var result, left, right);
+        return result;
+    }
+
+    public static Vector128<ulong> Xor(Vector128<ulong> left, Vector128<ulong> right)
+    {
+        XorVector(out var result, left, right);
+        return result;
+    }
+
+    public static Vector128<byte> AndNot(Vector128<byte> left, Vector128<byte> right)
+    {
+        AndNotVector(out var result, left, right);
+        return result;
+    }
+
+    public static Vector128<sbyte> AndNot(Vector128<sbyte> left, Vector128<sbyte> right)
+    {
+        AndNotVector(out var result, left, right);
+        return result;
+    }
+
+    public static Vector128<short> AndNot(Vector128<short> left, Vector128<short> right)
+    {
+        AndNotVector(out var result, left, right);
+        return result;
+    }
+
+    public static Vector128<ushort> AndNot(Vector128<ushort> left, Vector128<ushort> right)
+    {
+        AndNotVector(out var result, left, right);
+        return result;
+    }
+
+    public static Vector128<int> AndNot(Vector128<int> left, Vector128<int> right)
+    {
+        AndNotVector(out var result, left, right);
+        return result;
+    }
+
+    public static Vector128<uint> AndNot(Vector128<uint> left, Vector128<uint> right)
+    {
+        AndNotVector(out var result, left, right);
+        return result;
+    }
+
+    public static Vector128<long> AndNot(Vector128<long> left, Vector128<long> right)
+    {
+        AndNotVector(out var result, left, right);
+        return result;
+    }
+
+    public static Vector128<ulong> AndNot(Vector128<ulong> left, Vector128<ulong> right)
+    {
+        AndNotVector(out var result, left, right);
+        return result;
+    }
+
+    #endregion
+
+    #region Compare
+
+    public static Vector128<byte> CompareEqual(Vector128<byte> left, Vector128<byte> right)
+    {
+        CompareEqual8(out var result, left, right);
+        return result;
+    }
+
+    public static Vector128<sbyte> CompareEqual(Vector128<sbyte> left, Vector128<sbyte> right)
+    {
+        CompareEqual8(out var result, left, right);
+        return result;
+    }
+
+    public static Vector128<short> CompareEqual(Vector128<short> left, Vector128<short> right)
+    {
+        CompareEqual16(out var result, left, right);
+        return result;
+    }
+
+    public static Vector128<ushort> CompareEqual(Vector128<ushort> left, Vector128<ushort> right)
+    {
+        CompareEqual16(out var result, left, right);
+        return result;
+    }
+
+    public static Vector128<int> CompareEqual(Vector128<int> left, Vector128<int> right)
+    {
+        CompareEqual32(out var result, left, right);
+        return result;
+    }
+
+    public static Vector128<uint> CompareEqual(Vector128<uint> left, Vector128<uint> right)
+    {
+        CompareEqual32(out var result, left, right);
+        return result;
+    }
+
+    public static Vector128<sbyte> CompareGreaterThan(Vector128<sbyte> left, Vector128<sbyte> right)
+    {
+        CompareGreaterThan8(out var result, left, right);
+        return result;
+    }
+
+    public static Vector128<short> CompareGreaterThan(Vector128<short> left, Vector128<short> right)
+    {
+        CompareGreaterThan16(out var result, left, right);
+        return result;
+    }
+
+    public static Vector128<int> CompareGreaterThan(Vector128<int> left, Vector128<int> right)
+    {
+        CompareGreaterThan32(out var result, left, right);
+        return result;
+    }
+
+    /// <summary>
+    /// A bit per byte, set if the top bit of the byte is set
+    /// </summary>
+    public static int MoveMask(Vector128<byte> value)
+    {
+        return MoveMask8(value);
+    }
+
+    public static int MoveMask(Vector128<sbyte> value)
+    {
+        return MoveMask8(value.AsByte());
+    }
+
+    /// <summary>
+    /// The sum of the absolute differences of each 8 bytes, in the low 16 bits of each half
+    /// </summary>
+    public static Vector128<ushort> SumAbsoluteDifferences(Vector128<byte> left, Vector128<byte> right)
+    {
+        SumAbsoluteDifferences8(out var result, left, right);
+        return result.AsUInt16();
+    }
+
+    #endregion
+
+    #region Shift
+
+    public static Vector128<short> ShiftLeftLogical(Vector128<short> value, byte count)
+    {
+        ShiftLeftLogical16(out var result, value, count);
+        return result;
+    }
+
+    public static Vector128<ushort> ShiftLeftLogical(Vector128<ushort> value, byte count)
+    {
+        ShiftLeftLogical16(out var result, value, count);
+        return result;
+    }
+
+    public static Vector128<int> ShiftLeftLogical(Vector128<int> value, byte count)
+    {
+        ShiftLeftLogical32(out var result, value, count);
+        return result;
+    }
+
+    public static Vector128<uint> ShiftLeftLogical(Vector128<uint> value, byte count)
+    {
+        ShiftLeftLogical32(out var result, value, count);
+        return result;
+    }
+
+    public static Vector128<long> ShiftLeftLogical(Vector128<long> value, byte count)
+    {
+        ShiftLeftLogical64(out var result, value, count);
+        return result;
+    }
+
+    public static Vector128<ulong> ShiftLeftLogical(Vector128<ulong> value, byte count)
+    {
+        ShiftLeftLogical64(out var result, value, count);
+        return result;
+    }
+
+    public static Vector128<short> ShiftRightLogical(Vector128<short> value, byte count)
+    {
+        ShiftRightLogical16(out var result, value, count);
+        return result;
+    }
+
+    public static Vector128<ushort> ShiftRightLogical(Vector128<ushort> value, byte count)
+    {
+        ShiftRightLogical16(out var result, value, count);
+        return result;
+    }
+
+    public static Vector128<int> ShiftRightLogical(Vector128<int> value, byte count)
+    {
+        ShiftRightLogical32(out var result, value, count);
+        return result;
+    }
+
+    public static Vector128<uint> ShiftRightLogical(Vector128<uint> value, byte count)
+    {
+        ShiftRightLogical32(out var result, value, count);
+        return result;
+    }
+
+    public static Vector128<long> ShiftRightLogical(Vector128<long> value, byte count)
+    {
+        ShiftRightLogical64(out var result, value, count);
+        return result;
+    }
+
+    public static Vector128<ulong> ShiftRightLogical(Vector128<ulong> value, byte count)
+    {
+        ShiftRightLogical64(out var result, value, count);
+        return result;
+    }
+
+    public static Vector128<short> ShiftRightArithmetic(Vector128<short> value, byte count)
+    {
+        ShiftRightArithmetic16(out var result, value, count);
+        return result;
+    }
+
+    public static Vector128<int> ShiftRightArithmetic(Vector128<int> value, byte count)
+    {
+        ShiftRightArithmetic32(out var result, value, count);
+        return result;
+    }
+
+    #endregion
+
+    #region Memory
+
+    public static unsafe Vector128<byte> LoadVector128(byte* address)
+    {
+        return *(Vector128<byte>*)address;
+    }
+
+    public static unsafe Vector128<sbyte> LoadVector128(sbyte* address)
+    {
+        return *(Vector128<sbyte>*)address;
+    }
+
+    public static unsafe Vector128<short> LoadVector128(short* address)
+    {
+        return *(Vector128<short>*)address;
+    }
+
+    public static unsafe Vector128<ushort> LoadVector128(ushort* address)
+    {
+        return *(Vector128<ushort>*)address;
+    }
+
+    public static unsafe Vector128<int> LoadVector128(int* address)
+    {
+        return *(Vector128<int>*)address;
+    }
+
+    public static unsafe Vector128<uint> LoadVector128(uint* address)
+    {
+        return *(Vector128<uint>*)address;
+    }
+
+    public static unsafe Vector128<long> LoadVector128(long* address)
+    {
+        return *(Vector128<long>*)address;
+    }
+
+    public static unsafe Vector128<ulong> LoadVector128(ulong* address)
+    {
+        return *(Vector128<ulong>*)address;
+    }
+
+    public static unsafe void Store(byte* address, Vector128<byte> source)
+    {
+        *(Vector128<byte>*)address = source;
+    }
+
+    public static unsafe void Store(sbyte* address, Vector128<sbyte> source)
+    {
+        *(Vector128<sbyte>*)address = source;
+    }
+
+    public static unsafe void Store(short* address, Vector128<short> source)
+    {
+        *(Vector128<short>*)address = source;
+    }
+
+    public static unsafe void Store(ushort* address, Vector128<ushort> source)
+    {
+        *(Vector128<ushort>*)address = source;
+    }
+
+    public static unsafe void Store(int* address, Vector128<int> source)
+    {
+        *(Vector128<int>*)address = source;
+    }
+
+    public static unsafe void Store(uint* address, Vector128<uint> source)
+    {
+        *(Vector128<uint>*)address = source;
+    }
+
+    public static unsafe void Store(long* address, Vector128<long> source)
+    {
+        *(Vector128<long>*)address = source;
+    }
+
+    public static unsafe void Store(ulong* address, Vector128<ulong> source)
+    {
+        *(Vector128<ulong>*)address = source;
+    }
+
+    #endregion
+
+}
\ No newline at end of file
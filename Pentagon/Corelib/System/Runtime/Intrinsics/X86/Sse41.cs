@@ -0,0 +1,178 @@
+using System.Runtime.CompilerServices;
+
+namespace System.Runtime.Intrinsics.X86;
+
+public abstract class Sse41 : Ssse3
+{
+
+    internal Sse41()
+    {
+    }
+
+    public static new extern bool IsSupported
+    {
+        [MethodImpl(MethodImplOptions.InternalCall)]
+        get;
+    }
+
+    #region Natives
+
+    [MethodImpl(MethodImplOptions.InternalCall)]
+    private static extern void MinInt8<T>(out Vector128<T> result, in Vector128<T> left, in Vector128<T> right) where T : unmanaged;
+
+    [MethodImpl(MethodImplOptions.InternalCall)]
+    private static extern void MaxInt8<T>(out Vector128<T> result, in Vector128<T> left, in Vector128<T> right) where T : unmanaged;
+
+    [MethodImpl(MethodImplOptions.InternalCall)]
+    private static extern void MinUInt16<T>(out Vector128<T> result, in Vector128<T> left, in Vector128<T> right) where T : unmanaged;
+
+    [MethodImpl(MethodImplOptions.InternalCall)]
+    private static extern void MaxUInt16<T>(out Vector128<T> result, in Vector128<T> left, in Vector128<T> right) where T : unmanaged;
+
+    [MethodImpl(MethodImplOptions.InternalCall)]
+    private static extern void MinInt32<T>(out Vector128<T> result, in Vector128<T> left, in Vector128<T> right) where T : unmanaged;
+
+    [MethodImpl(MethodImplOptions.InternalCall)]
+    private static extern void MaxInt32<T>(out Vector128<T> result, in Vector128<T> left, in Vector128<T> right) where T : unmanaged;
+
+    [MethodImpl(MethodImplOptions.InternalCall)]
+    private static extern void MinUInt32<T>(out Vector128<T> result, in Vector128<T> left, in Vector128<T> right) where T : unmanaged;
+
+    [MethodImpl(MethodImplOptions.InternalCall)]
+    private static extern void MaxUInt32<T>(out Vector128<T> result, in Vector128<T> left, in Vector128<T> right) where T : unmanaged;
+
+    [MethodImpl(MethodImplOptions.InternalCall)]
+    private static extern void CompareEqual64<T>(out Vector128<T> result, in Vector128<T> left, in Vector128<T> right) where T : unmanaged;
+
+    [MethodImpl(MethodImplOptions.InternalCall)]
+    private static extern void MultiplyLow32<T>(out Vector128<T> result, in Vector128<T> left, in Vector128<T> right) where T : unmanaged;
+
+    [MethodImpl(MethodImplOptions.InternalCall)]
+    private static extern bool TestZVector<T>(in Vector128<T> left, in Vector128<T> right) where T : unmanaged;
+
+    #endregion
+
+    #region Operations
+
+    public static Vector128<sbyte> Min(Vector128<sbyte> left, Vector128<sbyte> right)
+    {
+        MinInt8(out var result, left, right);
+        return result;
+    }
+
+    public static Vector128<sbyte> Max(Vector128<sbyte> left, Vector128<sbyte> right)
+    {
+        MaxInt8(out var result, left, right);
+        return result;
+    }
+
+    public static Vector128<ushort> Min(Vector128<ushort> left, Vector128<ushort> right)
+    {
+        MinUInt16(out var result, left, right);
+        return result;
+    }
+
+    public static Vector128<ushort> Max(Vector128<ushort> left, Vector128<ushort> right)
+    {
+        MaxUInt16(out var result, left, right);
+        return result;
+    }
+
+    public static Vector128<int> Min(Vector128<int> left, Vector128<int> right)
+    {
+        MinInt32(out var result, left, right);
+        return result;
+    }
+
+    public static Vector128<int> Max(Vector128<int> left, Vector128<int> right)
+    {
+        MaxInt32(out var result, left, right);
+        return result;
+    }
+
+    public static Vector128<uint> Min(Vector128<uint> left, Vector128<uint> right)
+    {
+        MinUInt32(out var result, left, right);
+        return result;
+    }
+
+    public static Vector128<uint> Max(Vector128<uint> left, Vector128<uint> right)
+    {
+        MaxUInt32(out var result, left, right);
+        return result;
+    }
+
+    public static Vector128<long> CompareEqual(Vector128<long> left, Vector128<long> right)
+    {
+        CompareEqual64(out var result, left, right);
+        return result;
+    }
+
+    public static Vector128<ulong> CompareEqual(Vector128<ulong> left, Vector128<ulong> right)
+    {
+        CompareEqual64(out var result, left, right);
+        return result;
+    }
+
+    public static Vector128<int> MultiplyLow(Vector128<int> left, Vector128<int> right)
+    {
+        MultiplyLow32(out var result, left, right);
+        return result;
+    }
+
+    public static Vector128<uint> MultiplyLow(Vector128<uint> left, Vector128<uint> right)
+    {
+        MultiplyLow32(out var result, left, right);
+        return result;
+    }
+
+    #endregion
+
+    #region Test
+
+    /// <summary>
+    /// True if left and right have no bits in common
+    /// </summary>
+    public static bool TestZ(Vector128<byte> left, Vector128<byte> right)
+    {
+        return TestZVector(left, right);
+    }
+
+    public static bool TestZ(Vector128<sbyte> left, Vector128<sbyte> right)
+    {
+        return TestZVector(left, right);
+    }
+
+    public static bool TestZ(Vector128<short> left, Vector128<short> right)
+    {
+        return TestZVector(left, right);
+    }
+
+    public static bool TestZ(Vector128<ushort> left, Vector128<ushort> right)
+    {
+        return TestZVector(left, right);
+    }
+
+    public static bool TestZ(Vector128<int> left, Vector128<int> right)
+    {
+        return TestZVector(left, right);
+    }
+
+    public static bool TestZ(Vector128<uint> left, Vector128<uint> right)
+    {
+        return TestZVector(left, right);
+    }
+
+    public static bool TestZ(Vector128<long> left, Vector128<long> right)
+    {
+        return TestZVector(left, right);
+    }
+
+    public static bool TestZ(Vector128<ulong> left, Vector128<ulong> right)
+    {
+        return TestZVector(left, right);
+    }
+
+    #endregion
+
+}
\ No newline at end of file
@@ -0,0 +1,85 @@
+using System.Runtime.CompilerServices;
+
+namespace System.Runtime.Intrinsics.X86;
+
+public abstract class Sse42 : Sse41
+{
+
+    internal Sse42()
+    {
+    }
+
+    public static new extern bool IsSupported
+    {
+        [MethodImpl(MethodImplOptions.InternalCall)]
+        get;
+    }
+
+    #region Natives
+
+    [MethodImpl(MethodImplOptions.InternalCall)]
+    private static extern void CompareGreaterThan64<T>(out Vector128<T> result, in Vector128<T> left, in Vector128<T> right) where T : unmanaged;
+
+    [MethodImpl(MethodImplOptions.InternalCall)]
+    private static extern uint Crc32Byte(uint crc, byte data);
+
+    [MethodImpl(MethodImplOptions.InternalCall)]
+    private static extern uint Crc32UInt16(uint crc, ushort data);
+
+    [MethodImpl(MethodImplOptions.InternalCall)]
+    private static extern uint Crc32UInt32(uint crc, uint data);
+
+    [MethodImpl(MethodImplOptions.InternalCall)]
+    private static extern ulong Crc32UInt64(ulong crc, ulong data);
+
+    #endregion
+
+    #region Compare
+
+    public static Vector128<long> CompareGreaterThan(Vector128<long> left, Vector128<long> right)
+    {
+        CompareGreaterThan64(out var result, left, right);
+        return result;
+    }
+
+    #endregion
+
+    #region Crc32
+
+    /// <summary>
+    /// Accumulate the CRC32-C (Castagnoli) of the data, the crc is not inverted
+    /// </summary>
+    public static uint Crc32(uint crc, byte data)
+    {
+        return Crc32Byte(crc, data);
+    }
+
+    public static uint Crc32(uint crc, ushort data)
+    {
+        return Crc32UInt16(crc, data);
+    }
+
+    public static uint Crc32(uint crc, uint data)
+    {
+        return Crc32UInt32(crc, data);
+    }
+
+    #endregion
+
+    public abstract class X64
+    {
+
+        internal X64()
+        {
+        }
+
+        public static bool IsSupported => Sse42.IsSupported;
+
+        public static ulong Crc32(ulong crc, ulong data)
+        {
+            return Crc32UInt64(crc, data);
+        }
+
+    }
+
+}
\ No newline at end of file
@@ -0,0 +1,90 @@
+using System.Runtime.CompilerServices;
+
+namespace System.Runtime.Intrinsics.X86;
+
+/// <summary>
+/// Byte shuffles and horizontal operations, there is no Sse3 class since
+/// nothing in it is useful for integer code
+/// </summary>
+public abstract class Ssse3 : Sse2
+{
+
+    internal Ssse3()
+    {
+    }
+
+    public static new extern bool IsSupported
+    {
+        [MethodImpl(MethodImplOptions.InternalCall)]
+        get;
+    }
+
+    #region Natives
+
+    [MethodImpl(MethodImplOptions.InternalCall)]
+    private static extern void Shuffle8<T>(out Vector128<T> result, in Vector128<T> left, in Vector128<T> right) where T : unmanaged;
+
+    [MethodImpl(MethodImplOptions.InternalCall)]
+    private static extern void Abs8<T>(out Vector128<T> result, in Vector128<T> value) where T : unmanaged;
+
+    [MethodImpl(MethodImplOptions.InternalCall)]
+    private static extern void Abs16<T>(out Vector128<T> result, in Vector128<T> value) where T : unmanaged;
+
+    [MethodImpl(MethodImplOptions.InternalCall)]
+    private static extern void Abs32<T>(out Vector128<T> result, in Vector128<T> value) where T : unmanaged;
+
+    [MethodImpl(MethodImplOptions.InternalCall)]
+    private static extern void HorizontalAdd16<T>(out Vector128<T> result, in Vector128<T> left, in Vector128<T> right) where T : unmanaged;
+
+    [MethodImpl(MethodImplOptions.InternalCall)]
+    private static extern void HorizontalAdd32<T>(out Vector128<T> result, in Vector128<T> left, in Vector128<T> right) where T : unmanaged;
+
+    #endregion
+
+    #region Operations
+
+    public static Vector128<byte> Shuffle(Vector128<byte> left, Vector128<byte> right)
+    {
+        Shuffle8(out var result, left, right);
+        return result;
+    }
+
+    public static Vector128<sbyte> Shuffle(Vector128<sbyte> left, Vector128<sbyte> right)
+    {
+        Shuffle8(out var result, left, right);
+        return result;
+    }
+
+    public static Vector128<byte> Abs(Vector128<sbyte> value)
+    {
+        Abs8(out var result, value);
+        return result.As<sbyte, byte>();
+    }
+
+    public static Vector128<ushort> Abs(Vector128<short> value)
+    {
+        Abs16(out var result, value);
+        return result.As<short, ushort>();
+    }
+
+    public static Vector128<uint> Abs(Vector128<int> value)
+    {
+        Abs32(out var result, value);
+        return result.As<int, uint>();
+    }
+
+    public static Vector128<short> HorizontalAdd(Vector128<short> left, Vector128<short> right)
+    {
+        HorizontalAdd16(out var result, left, right);
+        return result;
+    }
+
+    public static Vector128<int> HorizontalAdd(Vector128<int> left, Vector128<int> right)
+    {
+        HorizontalAdd32(out var result, left, right);
+        return result;
+    }
+
+    #endregion
+
+}
\ No newline at end of file
@@ -2,9 +2,18 @@ using System.Runtime.CompilerServices;
 
 namespace System.Runtime.Intrinsics.X86;
 
-public static class X86Base
+/// <summary>
+/// The base of all the x86 intrinsics classes. The IsSupported of every class is turned into a
+/// constant by the jit, so checking it costs nothing and the unsupported path is removed. Calling
+/// an operation of an unsupported class faults the same as running the instruction would.
+/// </summary>
+public abstract class X86Base
 {
 
+    internal X86Base()
+    {
+    }
+
     public static bool IsSupported => true;
     
     [MethodImpl(MethodImplOptions.InternalCall)]
@@ -1,6 +1,6 @@
 namespace System;
 
-public readonly struct SByte
+public readonly struct SByte : ISpanFormattable
 {
 #pragma warning disable 169
     private readonly sbyte _value;
@@ -22,7 +22,17 @@ public readonly struct SByte
 
     public override string ToString()
     {
-        return "";
+        return Number.SByteToString(_value, null);
+    }
+
+    public string ToString(string format)
+    {
+        return Number.SByteToString(_value, format);
+    }
+
+    public bool TryFormat(Span<char> destination, out int charsWritten, string format = null)
+    {
+        return Number.TryFormatSByte(_value, format, destination, out charsWritten);
     }
 
     
@@ -63,16 +63,22 @@ public readonly ref struct Span<T>
     }
 
     //
-    // TODO: all of these can be optimized with native code, generated specifically
-    //       for each of the types, this can then be used with arrays to make some 
-    //       fast clear/copyto/fill and whatever else
+    // Blittable types go to the native kernels, anything with references has to be done
+    // an element at a time so the stores go through the GC write barrier
     //
-    
+
     public void Clear()
     {
-        for (var i = 0; i < _length; i++)
+        if (RuntimeHelpers.IsReferenceOrContainsReferences<T>())
+        {
+            for (var i = 0; i < _length; i++)
+            {
+                this[i] = default;
+            }
+        }
+        else
         {
-            this[i] = default;
+            Buffer.ZeroMemory(_ptr, (ulong)_length * (ulong)Unsafe.SizeOf<T>());
         }
     }
     
@@ -91,7 +97,11 @@ public readonly ref struct Span<T>
             return false;
         }
 
-        if (_ptr < destination._ptr && destination._ptr < _ptr + (ulong)_length * (ulong)Unsafe.SizeOf<T>())
+        if (!RuntimeHelpers.IsReferenceOrContainsReferences<T>())
+        {
+            Buffer.Memmove(destination._ptr, _ptr, (ulong)_length * (ulong)Unsafe.SizeOf<T>());
+        }
+        else if (_ptr < destination._ptr && destination._ptr < _ptr + (ulong)_length * (ulong)Unsafe.SizeOf<T>())
         {
             for (var i = _length - 1; i >= 0; i--)
             {
@@ -111,9 +121,16 @@ public readonly ref struct Span<T>
 
     public void Fill(T value)
     {
-        for (var i = 0; i < _length; i++)
+        if (RuntimeHelpers.IsReferenceOrContainsReferences<T>())
+        {
+            for (var i = 0; i < _length; i++)
+            {
+                this[i] = value;
+            }
+        }
+        else
         {
-            this[i] = value;
+            Buffer.Fill(_ptr, (ulong)_length, (ulong)Unsafe.SizeOf<T>(), Unsafe.AsPointer(ref value));
         }
     }
 
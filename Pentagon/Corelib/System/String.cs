@@ -6,7 +6,7 @@ using System.Runtime.InteropServices;
 namespace System;
 
 [StructLayout(LayoutKind.Sequential)]
-public class String : IEnumerable<char>
+public class String : IEnumerable<char>, IEquatable<string>
 {
 
     public static readonly string Empty = "";
@@ -49,6 +49,15 @@ public class String : IEnumerable<char>
         chars.AsSpan(startIndex, length).CopyTo(span);
     }
 
+    /// <summary>
+    /// Allocate a string to be filled by the caller, used by the
+    /// formatting code to write the chars straight into the string
+    /// </summary>
+    internal static string FastAllocateString(int length)
+    {
+        return length == 0 ? Empty : new string(length);
+    }
+
     #region Concat
 
     public static string Concat(object arg0)
@@ -58,17 +67,57 @@ public class String : IEnumerable<char>
 
     public static string Concat(object arg0, object arg1)
     {
-        return Concat(Concat(arg0), Concat(arg1));
+        return Concat(arg0?.ToString(), arg1?.ToString());
     }
 
     public static string Concat(string arg0, string arg1)
     {
+        if (IsNullOrEmpty(arg0))
+            return arg1 ?? Empty;
+
+        if (IsNullOrEmpty(arg1))
+            return arg0;
+
         var str = new string(arg0.Length + arg1.Length);
-        var span = new Span<char>(str.GetDataPtr(), str.Length);
+        var span = str.AsSpan();
         arg0.AsSpan().CopyTo(span);
         arg1.AsSpan().CopyTo(span.Slice(arg0.Length));
         return str;
     }
+
+    public static string Concat(string arg0, string arg1, string arg2)
+    {
+        var length = (arg0?.Length ?? 0) + (arg1?.Length ?? 0) + (arg2?.Length ?? 0);
+        if (length == 0)
+            return Empty;
+
+        var str = new string(length);
+        var span = str.AsSpan();
+        arg0.AsSpan().CopyTo(span);
+        span = span.Slice(arg0?.Length ?? 0);
+        arg1.AsSpan().CopyTo(span);
+        span = span.Slice(arg1?.Length ?? 0);
+        arg2.AsSpan().CopyTo(span);
+        return str;
+    }
+
+    public static string Concat(string arg0, string arg1, string arg2, string arg3)
+    {
+        var length = (arg0?.Length ?? 0) + (arg1?.Length ?? 0) + (arg2?.Length ?? 0) + (arg3?.Length ?? 0);
+        if (length == 0)
+            return Empty;
+
+        var str = new string(length);
+        var span = str.AsSpan();
+        arg0.AsSpan().CopyTo(span);
+        span = span.Slice(arg0?.Length ?? 0);
+        arg1.AsSpan().CopyTo(span);
+        span = span.Slice(arg1?.Length ?? 0);
+        arg2.AsSpan().CopyTo(span);
+        span = span.Slice(arg2?.Length ?? 0);
+        arg3.AsSpan().CopyTo(span);
+        return str;
+    }
     
     #endregion
 
@@ -95,10 +144,48 @@ public class String : IEnumerable<char>
         return this;
     }
 
+    #region Equality
+
+    public bool Equals(string value)
+    {
+        if (ReferenceEquals(this, value))
+            return true;
+
+        if (value == null || value.Length != Length)
+            return false;
+
+        return Buffer.SequenceEqual(GetDataPtr(), value.GetDataPtr(), (ulong)Length * sizeof(char));
+    }
+
+    public override bool Equals(object obj)
+    {
+        return obj is string str && Equals(str);
+    }
+
+    public static bool Equals(string a, string b)
+    {
+        if (ReferenceEquals(a, b))
+            return true;
+
+        if (a == null || b == null)
+            return false;
+
+        return a.Equals(b);
+    }
+
     public override int GetHashCode()
     {
-        return base.GetHashCode();
+        // FNV-1a over the characters
+        var hash = 2166136261u;
+        var span = this.AsSpan();
+        for (var i = 0; i < span.Length; i++)
+        {
+            hash = (hash ^ span[i]) * 16777619u;
+        }
+        return (int)hash;
     }
+
+    #endregion
     
     public static bool IsNullOrEmpty(string value)
     {
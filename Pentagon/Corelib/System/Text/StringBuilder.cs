@@ -0,0 +1,413 @@
+using System.Runtime.CompilerServices;
+
+namespace System.Text;
+
+/// <summary>
+/// A mutable string, the chars are kept in a single buffer that doubles when it runs out of
+/// space, so appending is amortized O(1) and ToString is a single copy. Numbers are formatted
+/// straight into the buffer, so nothing but the buffer and the final string is ever allocated.
+/// </summary>
+public sealed class StringBuilder
+{
+
+    private const int DefaultCapacity = 16;
+
+    private char[] _chars;
+    private int _length;
+
+    public StringBuilder()
+        : this(DefaultCapacity)
+    {
+    }
+
+    public StringBuilder(int capacity)
+    {
+        if (capacity < 0) throw new ArgumentOutOfRangeException(nameof(capacity), "Non-negative number required.");
+        _chars = new char[capacity == 0 ? DefaultCapacity : capacity];
+    }
+
+    public StringBuilder(string value)
+        : this(value == null || value.Length < DefaultCapacity ? DefaultCapacity : value.Length)
+    {
+        Append(value);
+    }
+
+    public int Capacity
+    {
+        get => _chars.Length;
+        set
+        {
+            if (value < _length) throw new ArgumentOutOfRangeException(nameof(value), "Capacity cannot be less than the current length.");
+            if (value == _chars.Length)
+                return;
+
+            var chars = new char[value];
+            _chars.AsSpan(0, _length).CopyTo(chars);
+            _chars = chars;
+        }
+    }
+
+    public int Length
+    {
+        get => _length;
+        set
+        {
+            if (value < 0) throw new ArgumentOutOfRangeException(nameof(value), "Non-negative number required.");
+
+            // growing the string pads it with null chars
+            if (value > _length)
+            {
+                EnsureCapacity(value);
+                _chars.AsSpan(_length, value - _length).Clear();
+            }
+
+            _length = value;
+        }
+    }
+
+    [IndexerName("Chars")]
+    public char this[int index]
+    {
+        get
+        {
+            if ((uint)index >= (uint)_length) throw new IndexOutOfRangeException();
+            return _chars[index];
+        }
+        set
+        {
+            if ((uint)index >= (uint)_length) throw new IndexOutOfRangeException();
+            _chars[index] = value;
+        }
+    }
+
+    public int EnsureCapacity(int capacity)
+    {
+        if (capacity < 0) throw new ArgumentOutOfRangeException(nameof(capacity), "Non-negative number required.");
+
+        if (capacity > _chars.Length)
+        {
+            Grow(capacity - _length);
+        }
+
+        return _chars.Length;
+    }
+
+    /// <summary>
+    /// Make room for at least the given amount of chars after the current length
+    /// </summary>
+    private void Grow(int additional)
+    {
+        var required = _length + additional;
+        if ((uint)required > Array.MaxLength)
+            throw new OutOfMemoryException();
+
+        var capacity = _chars.Length * 2;
+        if ((uint)capacity > Array.MaxLength)
+            capacity = Array.MaxLength;
+        if (capacity < required)
+            capacity = required;
+
+        Capacity = capacity;
+    }
+
+    /// <summary>
+    /// The unused part of the buffer, values are formatted into it and then committed by
+    /// advancing the length
+    /// </summary>
+    private Span<char> RemainingSpan => _chars.AsSpan(_length);
+
+    #region Append
+
+    public StringBuilder Append(char value)
+    {
+        if (_length == _chars.Length)
+        {
+            Grow(1);
+        }
+
+        _chars[_length++] = value;
+        return this;
+    }
+
+    public StringBuilder Append(char value, int repeatCount)
+    {
+        if (repeatCount < 0) throw new ArgumentOutOfRangeException(nameof(repeatCount), "Non-negative number required.");
+
+        if (_chars.Length - _length < repeatCount)
+        {
+            Grow(repeatCount);
+        }
+
+        _chars.AsSpan(_length, repeatCount).Fill(value);
+        _length += repeatCount;
+        return this;
+    }
+
+    public StringBuilder Append(Span<char> value)
+    {
+        if (_chars.Length - _length < value.Length)
+        {
+            Grow(value.Length);
+        }
+
+        value.CopyTo(RemainingSpan);
+        _length += value.Length;
+        return this;
+    }
+
+    public StringBuilder Append(string value)
+    {
+        return Append(value.AsSpan());
+    }
+
+    public StringBuilder Append(string value, int startIndex, int count)
+    {
+        if (value == null && (startIndex != 0 || count != 0)) throw new ArgumentNullException(nameof(value));
+        return Append(value.AsSpan().Slice(startIndex, count));
+    }
+
+    public StringBuilder Append(char[] value)
+    {
+        return Append(value.AsSpan());
+    }
+
+    public StringBuilder Append(bool value)
+    {
+        return Append(value ? bool.TrueString : bool.FalseString);
+    }
+
+    public StringBuilder Append(int value)
+    {
+        return Append(value, null);
+    }
+
+    public StringBuilder Append(uint value)
+    {
+        return Append(value, null);
+    }
+
+    public StringBuilder Append(long value)
+    {
+        return Append(value, null);
+    }
+
+    public StringBuilder Append(ulong value)
+    {
+        return Append(value, null);
+    }
+
+    public StringBuilder Append(object value)
+    {
+        if (value is ISpanFormattable formattable)
+            return Append(formattable, null);
+
+        return Append(value?.ToString());
+    }
+
+    // the overloads of the primitives call TryFormat on the value itself, so they don't box
+
+    internal StringBuilder Append(int value, string format)
+    {
+        int charsWritten;
+        while (!value.TryFormat(RemainingSpan, out charsWritten, format))
+        {
+            Grow(RemainingSpan.Length + 1);
+        }
+
+        _length += charsWritten;
+        return this;
+    }
+
+    internal StringBuilder Append(uint value, string format)
+    {
+        int charsWritten;
+        while (!value.TryFormat(RemainingSpan, out charsWritten, format))
+        {
+            Grow(RemainingSpan.Length + 1);
+        }
+
+        _length += charsWritten;
+        return this;
+    }
+
+    internal StringBuilder Append(long value, string format)
+    {
+        int charsWritten;
+        while (!value.TryFormat(RemainingSpan, out charsWritten, format))
+        {
+            Grow(RemainingSpan.Length + 1);
+        }
+
+        _length += charsWritten;
+        return this;
+    }
+
+    internal StringBuilder Append(ulong value, string format)
+    {
+        int charsWritten;
+        while (!value.TryFormat(RemainingSpan, out charsWritten, format))
+        {
+            Grow(RemainingSpan.Length + 1);
+        }
+
+        _length += charsWritten;
+        return this;
+    }
+
+    internal StringBuilder Append(byte value, string format)
+    {
+        int charsWritten;
+        while (!value.TryFormat(RemainingSpan, out charsWritten, format))
+        {
+            Grow(RemainingSpan.Length + 1);
+        }
+
+        _length += charsWritten;
+        return this;
+    }
+
+    internal StringBuilder Append(sbyte value, string format)
+    {
+        int charsWritten;
+        while (!value.TryFormat(RemainingSpan, out charsWritten, format))
+        {
+            Grow(RemainingSpan.Length + 1);
+        }
+
+        _length += charsWritten;
+        return this;
+    }
+
+    internal StringBuilder Append(short value, string format)
+    {
+        int charsWritten;
+        while (!value.TryFormat(RemainingSpan, out charsWritten, format))
+        {
+            Grow(RemainingSpan.Length + 1);
+        }
+
+        _length += charsWritten;
+        return this;
+    }
+
+    internal StringBuilder Append(ushort value, string format)
+    {
+        int charsWritten;
+        while (!value.TryFormat(RemainingSpan, out charsWritten, format))
+        {
+            Grow(RemainingSpan.Length + 1);
+        }
+
+        _length += charsWritten;
+        return this;
+    }
+
+    internal StringBuilder Append(ISpanFormattable value, string format)
+    {
+        int charsWritten;
+        while (!value.TryFormat(RemainingSpan, out charsWritten, format))
+        {
+            Grow(RemainingSpan.Length + 1);
+        }
+
+        _length += charsWritten;
+        return this;
+    }
+
+    public StringBuilder Append([InterpolatedStringHandlerArgument("")] ref AppendInterpolatedStringHandler handler)
+    {
+        return this;
+    }
+
+    public StringBuilder AppendLine()
+    {
+        return Append('\n');
+    }
+
+    public StringBuilder AppendLine(string value)
+    {
+        return Append(value).Append('\n');
+    }
+
+    #endregion
+
+    public StringBuilder Clear()
+    {
+        _length = 0;
+        return this;
+    }
+
+    public void CopyTo(int sourceIndex, Span<char> destination, int count)
+    {
+        _chars.AsSpan(0, _length).Slice(sourceIndex, count).CopyTo(destination);
+    }
+
+    public override string ToString()
+    {
+        return ToString(0, _length);
+    }
+
+    public string ToString(int startIndex, int length)
+    {
+        var source = _chars.AsSpan(0, _length).Slice(startIndex, length);
+        var str = string.FastAllocateString(length);
+        source.CopyTo(str.AsSpan());
+        return str;
+    }
+
+    /// <summary>
+    /// Appends the parts of an interpolated string straight into the builder, so
+    /// <c>builder.Append($"{a} {b}")</c> never creates the intermediate string
+    /// </summary>
+    [InterpolatedStringHandler]
+    public struct AppendInterpolatedStringHandler
+    {
+
+        private readonly StringBuilder _builder;
+
+        public AppendInterpolatedStringHandler(int literalLength, int formattedCount, StringBuilder builder)
+        {
+            _builder = builder;
+        }
+
+        public void AppendLiteral(string value) => _builder.Append(value);
+
+        public void AppendFormatted(string value) => _builder.Append(value);
+
+        public void AppendFormatted(Span<char> value) => _builder.Append(value);
+
+        public void AppendFormatted(char value) => _builder.Append(value);
+
+        public void AppendFormatted(bool value) => _builder.Append(value);
+
+        public void AppendFormatted(int value, string format = null) => _builder.Append(value, format);
+
+        public void AppendFormatted(uint value, string format = null) => _builder.Append(value, format);
+
+        public void AppendFormatted(long value, string format = null) => _builder.Append(value, format);
+
+        public void AppendFormatted(ulong value, string format = null) => _builder.Append(value, format);
+
+        public void AppendFormatted(byte value, string format = null) => _builder.Append(value, format);
+
+        public void AppendFormatted(sbyte value, string format = null) => _builder.Append(value, format);
+
+        public void AppendFormatted(short value, string format = null) => _builder.Append(value, format);
+
+        public void AppendFormatted(ushort value, string format = null) => _builder.Append(value, format);
+
+        public void AppendFormatted<T>(T value, string format = null)
+        {
+            if (value is ISpanFormattable formattable)
+            {
+                _builder.Append(formattable, format);
+            }
+            else
+            {
+                _builder.Append(value?.ToString());
+            }
+        }
+
+    }
+
+}
\ No newline at end of file
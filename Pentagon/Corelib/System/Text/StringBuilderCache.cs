@@ -0,0 +1,48 @@
+using System.Threading;
+
+namespace System.Text;
+
+/// <summary>
+/// Keeps a single small builder around for building short lived strings, so formatting a
+/// string costs only the string itself. Taking the builder is an atomic swap, so when it is
+/// already taken (by another thread, or recursively) we simply make a new one.
+/// </summary>
+internal static class StringBuilderCache
+{
+
+    // large builders are not worth keeping around
+    internal const int MaxBuilderSize = 360;
+
+    private static StringBuilder _cachedInstance;
+
+    public static StringBuilder Acquire(int capacity = 16)
+    {
+        if (capacity <= MaxBuilderSize)
+        {
+            var builder = Interlocked.Exchange(ref _cachedInstance, null);
+            if (builder != null && capacity <= builder.Capacity)
+            {
+                builder.Clear();
+                return builder;
+            }
+        }
+
+        return new StringBuilder(capacity);
+    }
+
+    public static void Release(StringBuilder builder)
+    {
+        if (builder.Capacity <= MaxBuilderSize)
+        {
+            _cachedInstance = builder;
+        }
+    }
+
+    public static string GetStringAndRelease(StringBuilder builder)
+    {
+        var result = builder.ToString();
+        Release(builder);
+        return result;
+    }
+
+}
\ No newline at end of file
@@ -0,0 +1,52 @@
+namespace System.Threading;
+
+/// <summary>
+/// A token is just a view of its source, the default token has no source and can never be canceled
+/// </summary>
+public readonly struct CancellationToken
+{
+
+    private readonly CancellationTokenSource _source;
+
+    public static CancellationToken None => default;
+
+    public bool IsCancellationRequested => _source != null && _source.IsCancellationRequested;
+
+    public bool CanBeCanceled => _source != null;
+
+    internal CancellationToken(CancellationTokenSource source)
+    {
+        _source = source;
+    }
+
+    public CancellationTokenRegistration Register(Action callback)
+    {
+        if (callback == null)
+            throw new ArgumentNullException(nameof(callback));
+
+        return Register(InvokeAction, callback);
+    }
+
+    public CancellationTokenRegistration Register(Action<object> callback, object state)
+    {
+        if (callback == null)
+            throw new ArgumentNullException(nameof(callback));
+
+        if (_source == null)
+            return default;
+
+        return _source.Register(callback, state);
+    }
+
+    private static void InvokeAction(object state)
+    {
+        ((Action)state)();
+    }
+
+    public void ThrowIfCancellationRequested()
+    {
+        if (IsCancellationRequested)
+            throw new OperationCanceledException(this);
+    }
+
+}
\ No newline at end of file
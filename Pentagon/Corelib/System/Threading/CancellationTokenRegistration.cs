@@ -0,0 +1,31 @@
+namespace System.Threading;
+
+public readonly struct CancellationTokenRegistration : IDisposable
+{
+
+    private readonly CancellationTokenSource _source;
+    private readonly CancellationTokenSource.CallbackNode _node;
+
+    public CancellationToken Token => _source == null ? default : _source.Token;
+
+    internal CancellationTokenRegistration(CancellationTokenSource source, CancellationTokenSource.CallbackNode node)
+    {
+        _source = source;
+        _node = node;
+    }
+
+    /// <summary>
+    /// Remove the callback from the source
+    /// </summary>
+    /// <returns>false if the callback already ran (or is running)</returns>
+    public bool Unregister()
+    {
+        return _source != null && _source.Unregister(_node);
+    }
+
+    public void Dispose()
+    {
+        Unregister();
+    }
+
+}
\ No newline at end of file
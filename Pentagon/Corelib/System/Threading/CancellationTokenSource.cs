@@ -0,0 +1,222 @@
+namespace System.Threading;
+
+public class CancellationTokenSource : IDisposable
+{
+
+    /// <summary>
+    /// The registered callbacks are kept in a doubly linked list so a registration
+    /// can remove itself without searching, the node is owned by the registration
+    /// </summary>
+    internal sealed class CallbackNode
+    {
+        public CallbackNode Prev;
+        public CallbackNode Next;
+        public Action<object> Callback;
+        public object State;
+    }
+
+    private const int NotCanceled = 0;
+    private const int Notifying = 1;
+    private const int Notified = 2;
+
+    private int _state;
+    private CallbackNode _callbacks;
+    private SpinLock _lock;
+
+    private TimerQueueTimer _timer;
+    private bool _disposed;
+
+    public bool IsCancellationRequested => _state != NotCanceled;
+
+    public CancellationToken Token
+    {
+        get
+        {
+            ThrowIfDisposed();
+            return new CancellationToken(this);
+        }
+    }
+
+    public CancellationTokenSource()
+    {
+    }
+
+    public CancellationTokenSource(int millisecondsDelay)
+    {
+        if (millisecondsDelay < -1)
+            throw new ArgumentOutOfRangeException(nameof(millisecondsDelay), "Number must be either non-negative and less than or equal to Int32.MaxValue or -1.");
+
+        CancelAfter(millisecondsDelay);
+    }
+
+    public CancellationTokenSource(TimeSpan delay)
+        : this(TimerQueueTimer.ToMilliseconds(delay, nameof(delay)))
+    {
+    }
+
+    #region Cancellation
+
+    public void Cancel()
+    {
+        ThrowIfDisposed();
+        NotifyCancellation();
+    }
+
+    public void CancelAfter(int millisecondsDelay)
+    {
+        ThrowIfDisposed();
+
+        if (millisecondsDelay < -1)
+            throw new ArgumentOutOfRangeException(nameof(millisecondsDelay), "Number must be either non-negative and less than or equal to Int32.MaxValue or -1.");
+
+        if (IsCancellationRequested)
+            return;
+
+        // the timer goes through the timer queue, so thousands of sources
+        // waiting for a timeout only cost a heap entry each
+        if (_timer == null)
+        {
+            var lockTaken = false;
+            _lock.Enter(ref lockTaken);
+            _timer ??= new TimerQueueTimer(OnTimer, this);
+            _lock.Exit();
+        }
+
+        _timer.Change(millisecondsDelay, Timeout.Infinite);
+    }
+
+    public void CancelAfter(TimeSpan delay)
+    {
+        CancelAfter(TimerQueueTimer.ToMilliseconds(delay, nameof(delay)));
+    }
+
+    private static void OnTimer(object state)
+    {
+        ((CancellationTokenSource)state).NotifyCancellation();
+    }
+
+    private void NotifyCancellation()
+    {
+        if (Interlocked.CompareExchange(ref _state, Notifying, NotCanceled) != NotCanceled)
+            return;
+
+        _timer?.Close();
+
+        // take the whole list, no one can register once the state is set
+        var lockTaken = false;
+        _lock.Enter(ref lockTaken);
+        var node = _callbacks;
+        _callbacks = null;
+        _lock.Exit();
+
+        // run all the callbacks even if some of them fail, and report the first failure
+        Exception exception = null;
+        while (node != null)
+        {
+            var next = node.Next;
+            node.Prev = null;
+            node.Next = null;
+
+            try
+            {
+                node.Callback(node.State);
+            }
+            catch (Exception e)
+            {
+                exception ??= e;
+            }
+
+            node = next;
+        }
+
+        _state = Notified;
+
+        if (exception != null)
+            throw exception;
+    }
+
+    #endregion
+
+    #region Registration
+
+    internal CancellationTokenRegistration Register(Action<object> callback, object state)
+    {
+        if (!IsCancellationRequested)
+        {
+            var node = new CallbackNode { Callback = callback, State = state };
+
+            var lockTaken = false;
+            _lock.Enter(ref lockTaken);
+
+            // check again under the lock, the canceling thread takes the
+            // list under the lock after setting the state
+            if (!IsCancellationRequested)
+            {
+                node.Next = _callbacks;
+                if (_callbacks != null)
+                {
+                    _callbacks.Prev = node;
+                }
+                _callbacks = node;
+                _lock.Exit();
+                return new CancellationTokenRegistration(this, node);
+            }
+
+            _lock.Exit();
+        }
+
+        // already canceled, run it right away
+        callback(state);
+        return default;
+    }
+
+    internal bool Unregister(CallbackNode node)
+    {
+        var lockTaken = false;
+        _lock.Enter(ref lockTaken);
+
+        // the node is detached from the list when it is being run
+        var removed = false;
+        if (node.Prev != null || _callbacks == node)
+        {
+            if (node.Prev != null)
+            {
+                node.Prev.Next = node.Next;
+            }
+            else
+            {
+                _callbacks = node.Next;
+            }
+
+            if (node.Next != null)
+            {
+                node.Next.Prev = node.Prev;
+            }
+
+            node.Prev = null;
+            node.Next = null;
+            removed = true;
+        }
+
+        _lock.Exit();
+        return removed;
+    }
+
+    #endregion
+
+    private void ThrowIfDisposed()
+    {
+        if (_disposed)
+            throw new ObjectDisposedException();
+    }
+
+    public void Dispose()
+    {
+        if (_disposed)
+            return;
+
+        _disposed = true;
+        _timer?.Close();
+    }
+
+}
\ No newline at end of file
@@ -2,131 +2,143 @@ using System.Runtime.CompilerServices;
 
 namespace System.Threading;
 
+/// <summary>
+/// All of the operations are lowered by the jit from a handful of generic intrinsics, the
+/// width of the operation is taken from the generic argument, so each overload ends up as a
+/// single locked instruction.
+/// </summary>
 public static class Interlocked
 {
 
-    #region Add
+    #region Intrinsics
+
+    // these all return the original value
     
     [MethodImpl(MethodImplOptions.InternalCall)]
-    public static extern int Add(ref int location1, int value);
+    private static extern T AtomicExchangeAdd<T>(ref T location, T value);
 
     [MethodImpl(MethodImplOptions.InternalCall)]
-    public static extern uint Add(ref uint location1, uint value);
-    
+    private static extern T AtomicExchange<T>(ref T location, T value);
+
     [MethodImpl(MethodImplOptions.InternalCall)]
-    public static extern long Add(ref long location1, long value);
-    
+    private static extern T AtomicCompareExchange<T>(ref T location, T value, T comparand);
+
     [MethodImpl(MethodImplOptions.InternalCall)]
-    public static extern ulong Add(ref ulong location1, ulong value);
+    private static extern T AtomicAnd<T>(ref T location, T value);
+
+    [MethodImpl(MethodImplOptions.InternalCall)]
+    private static extern T AtomicOr<T>(ref T location, T value);
+
+    [MethodImpl(MethodImplOptions.InternalCall)]
+    private static extern void AtomicMemoryBarrier();
+
+    #endregion
+
+    #region Add
+    
+    public static int Add(ref int location1, int value) => AtomicExchangeAdd(ref location1, value) + value;
+
+    public static uint Add(ref uint location1, uint value) => AtomicExchangeAdd(ref location1, value) + value;
+    
+    public static long Add(ref long location1, long value) => AtomicExchangeAdd(ref location1, value) + value;
+    
+    public static ulong Add(ref ulong location1, ulong value) => AtomicExchangeAdd(ref location1, value) + value;
 
     #endregion
     
     #region And
     
-    [MethodImpl(MethodImplOptions.InternalCall)]
-    public static extern int And(ref int location1, int value);
+    public static int And(ref int location1, int value) => AtomicAnd(ref location1, value);
 
-    [MethodImpl(MethodImplOptions.InternalCall)]
-    public static extern uint And(ref uint location1, uint value);
+    public static uint And(ref uint location1, uint value) => AtomicAnd(ref location1, value);
     
-    [MethodImpl(MethodImplOptions.InternalCall)]
-    public static extern long And(ref long location1, long value);
+    public static long And(ref long location1, long value) => AtomicAnd(ref location1, value);
     
-    [MethodImpl(MethodImplOptions.InternalCall)]
-    public static extern ulong And(ref ulong location1, ulong value);
+    public static ulong And(ref ulong location1, ulong value) => AtomicAnd(ref location1, value);
 
     #endregion
 
     #region Compare Exchange
 
-    [MethodImpl(MethodImplOptions.InternalCall)]
-    public static extern int CompareExchange(ref int location1, int value, int comparand);
+    public static int CompareExchange(ref int location1, int value, int comparand) => AtomicCompareExchange(ref location1, value, comparand);
 
-    [MethodImpl(MethodImplOptions.InternalCall)]
-    public static extern uint CompareExchange(ref uint location1, uint value, uint comparand);
+    public static uint CompareExchange(ref uint location1, uint value, uint comparand) => AtomicCompareExchange(ref location1, value, comparand);
 
-    [MethodImpl(MethodImplOptions.InternalCall)]
-    public static extern long CompareExchange(ref long location1, long value, long comparand);
+    public static long CompareExchange(ref long location1, long value, long comparand) => AtomicCompareExchange(ref location1, value, comparand);
 
-    [MethodImpl(MethodImplOptions.InternalCall)]
-    public static extern ulong CompareExchange(ref ulong location1, ulong value, ulong comparand);
+    public static ulong CompareExchange(ref ulong location1, ulong value, ulong comparand) => AtomicCompareExchange(ref location1, value, comparand);
+
+    public static IntPtr CompareExchange(ref IntPtr location1, IntPtr value, IntPtr comparand) => AtomicCompareExchange(ref location1, value, comparand);
+
+    public static object CompareExchange(ref object location1, object value, object comparand) => AtomicCompareExchange(ref location1, value, comparand);
+
+    public static T CompareExchange<T>(ref T location1, T value, T comparand) where T : class => AtomicCompareExchange(ref location1, value, comparand);
 
     #endregion
 
     #region Decrement
 
-    [MethodImpl(MethodImplOptions.InternalCall)]
-    public static extern int Decrement(ref int location);
+    public static int Decrement(ref int location) => Add(ref location, -1);
 
-    [MethodImpl(MethodImplOptions.InternalCall)]
-    public static extern int Decrement(ref long location);
+    public static long Decrement(ref long location) => Add(ref location, -1);
 
-    [MethodImpl(MethodImplOptions.InternalCall)]
-    public static extern int Decrement(ref uint location);
+    public static uint Decrement(ref uint location) => Add(ref location, 0xFFFFFFFFu);
 
-    [MethodImpl(MethodImplOptions.InternalCall)]
-    public static extern int Decrement(ref ulong location);
+    public static ulong Decrement(ref ulong location) => Add(ref location, ~0UL);
 
     #endregion
     
     #region Exchange
 
-    [MethodImpl(MethodImplOptions.InternalCall)]
-    public static extern int Exchange(ref int location1, int value);
+    public static int Exchange(ref int location1, int value) => AtomicExchange(ref location1, value);
 
-    [MethodImpl(MethodImplOptions.InternalCall)]
-    public static extern uint Exchange(ref uint location1, uint value);
+    public static uint Exchange(ref uint location1, uint value) => AtomicExchange(ref location1, value);
 
-    [MethodImpl(MethodImplOptions.InternalCall)]
-    public static extern long Exchange(ref long location1, long value);
+    public static long Exchange(ref long location1, long value) => AtomicExchange(ref location1, value);
 
-    [MethodImpl(MethodImplOptions.InternalCall)]
-    public static extern ulong Exchange(ref ulong location1, ulong value);
+    public static ulong Exchange(ref ulong location1, ulong value) => AtomicExchange(ref location1, value);
+
+    public static IntPtr Exchange(ref IntPtr location1, IntPtr value) => AtomicExchange(ref location1, value);
+
+    public static object Exchange(ref object location1, object value) => AtomicExchange(ref location1, value);
+
+    public static T Exchange<T>(ref T location1, T value) where T : class => AtomicExchange(ref location1, value);
 
     #endregion
 
     #region Increment
 
-    [MethodImpl(MethodImplOptions.InternalCall)]
-    public static extern int Increment(ref int location);
+    public static int Increment(ref int location) => Add(ref location, 1);
 
-    [MethodImpl(MethodImplOptions.InternalCall)]
-    public static extern int Increment(ref long location);
+    public static long Increment(ref long location) => Add(ref location, 1);
 
-    [MethodImpl(MethodImplOptions.InternalCall)]
-    public static extern int Increment(ref uint location);
+    public static uint Increment(ref uint location) => Add(ref location, 1);
 
-    [MethodImpl(MethodImplOptions.InternalCall)]
-    public static extern int Increment(ref ulong location);
+    public static ulong Increment(ref ulong location) => Add(ref location, 1);
 
     #endregion
 
-    [MethodImpl(MethodImplOptions.InternalCall)]
-    public static extern void MemoryBarrier();
+    public static void MemoryBarrier() => AtomicMemoryBarrier();
     
     #region Or
     
-    [MethodImpl(MethodImplOptions.InternalCall)]
-    public static extern int Or(ref int location1, int value);
+    public static int Or(ref int location1, int value) => AtomicOr(ref location1, value);
 
-    [MethodImpl(MethodImplOptions.InternalCall)]
-    public static extern uint Or(ref uint location1, uint value);
+    public static uint Or(ref uint location1, uint value) => AtomicOr(ref location1, value);
     
-    [MethodImpl(MethodImplOptions.InternalCall)]
-    public static extern long Or(ref long location1, long value);
+    public static long Or(ref long location1, long value) => AtomicOr(ref location1, value);
     
-    [MethodImpl(MethodImplOptions.InternalCall)]
-    public static extern ulong Or(ref ulong location1, ulong value);
+    public static ulong Or(ref ulong location1, ulong value) => AtomicOr(ref location1, value);
 
     #endregion
 
     #region Read
     
-    [MethodImpl(MethodImplOptions.InternalCall)]
-    public static extern int Read(ref long location);
+    // aligned 64bit loads are atomic on their own
     
-    [MethodImpl(MethodImplOptions.InternalCall)]
-    public static extern ulong Read(ref ulong location);
+    public static long Read(ref long location) => Volatile.Read(ref location);
+    
+    public static ulong Read(ref ulong location) => Volatile.Read(ref location);
 
     #endregion
     
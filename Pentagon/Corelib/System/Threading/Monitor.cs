@@ -2,9 +2,21 @@ using System.Runtime.CompilerServices;
 
 namespace System.Threading;
 
+/// <summary>
+/// Monitor on top of thin locks, every object has a lock word that holds the owner thread and the
+/// recursion count, taking and releasing a lock that no one else wants is a single compare exchange
+/// on it. Once there is contention (or Wait/Pulse) the kernel inflates the word into a sync block
+/// with a real mutex, and from then on everything goes through the slow path.
+/// </summary>
 public static class Monitor
 {
 
+    // must match monitor.h
+    private const ulong OwnerMask = 0xFFFFFFFF;
+    private const ulong RecursionUnit = 1ul << 32;
+    private const ulong RecursionMax = 0x7FFFFFFF;
+    private const ulong Inflated = 1ul << 63;
+
     public static void Enter(object obj)
     {
         var lockTaken = false;
@@ -19,12 +31,29 @@ public static class Monitor
         if (obj == null)
             throw new ArgumentNullException(nameof(obj));
 
-        switch (EnterInternal(obj, ref lockTaken))
+        var threadId = CurrentThreadId();
+        ref var word = ref GetLockWord(obj);
+
+        // not locked at all
+        if (Interlocked.CompareExchange(ref word, threadId, 0) == 0)
         {
-            case 0: return;
-            case 3: throw new OutOfMemoryException();
-            default: throw new SystemException();
+            lockTaken = true;
+            return;
         }
+
+        // we already own the thin lock
+        var value = word;
+        if ((value & (Inflated | OwnerMask)) == threadId && (value >> 32) < RecursionMax)
+        {
+            if (Interlocked.CompareExchange(ref word, value + RecursionUnit, value) == value)
+            {
+                lockTaken = true;
+                return;
+            }
+        }
+
+        ThrowIfFailed(EnterSlow(obj, threadId));
+        lockTaken = true;
     }
 
     public static void Exit(object obj)
@@ -32,71 +61,81 @@ public static class Monitor
         if (obj == null)
             throw new ArgumentNullException(nameof(obj));
 
-        switch (ExitInternal(obj))
-        {
-            case 0: return;
-            case 3: throw new OutOfMemoryException();
-            case 6: throw new SynchronizationLockException();
-            default: throw new SystemException();
-        }
+        var threadId = CurrentThreadId();
+        ref var word = ref GetLockWord(obj);
+
+        // we own the thin lock without any recursion
+        if (Interlocked.CompareExchange(ref word, 0, threadId) == threadId)
+            return;
+
+        ThrowIfFailed(ExitSlow(obj, threadId));
     }
 
     public static void Pulse(object obj)
     {
         if (obj == null)
             throw new ArgumentNullException(nameof(obj));
-        
-        switch (PulseInternal(obj))
-        {
-            case 0: return;
-            case 3: throw new OutOfMemoryException();
-            case 6: throw new SynchronizationLockException();
-            default: throw new SystemException();
-        }
+
+        ThrowIfFailed(PulseSlow(obj, CurrentThreadId(), false));
     }
 
     public static void PulseAll(object obj)
     {
         if (obj == null)
             throw new ArgumentNullException(nameof(obj));
-        
-        switch (PulseAllInternal(obj))
-        {
-            case 0: return;
-            case 3: throw new OutOfMemoryException();
-            case 6: throw new SynchronizationLockException();
-            default: throw new SystemException();
-        }
+
+        ThrowIfFailed(PulseSlow(obj, CurrentThreadId(), true));
     }
     
-    
     public static bool Wait(object obj)
     {
         if (obj == null)
             throw new ArgumentNullException(nameof(obj));
-        
-        switch (WaitInternal(obj))
+
+        ThrowIfFailed(WaitSlow(obj, CurrentThreadId()));
+        return true;
+    }
+
+    private static void ThrowIfFailed(int error)
+    {
+        switch (error)
         {
-            case 0: return true;
+            case 0: return;
             case 3: throw new OutOfMemoryException();
             case 6: throw new SynchronizationLockException();
             default: throw new SystemException();
         }
     }
 
+    /// <summary>
+    /// The id of the thread as the owner of a lock, ids are never reused so a lock
+    /// left held by a thread that is gone can't be taken over by a new thread
+    /// </summary>
+    private static uint CurrentThreadId()
+    {
+        return GetCurrentThreadId();
+    }
+
+    #region Native
+
     [MethodImpl(MethodImplOptions.InternalCall)]
-    private static extern int EnterInternal(object obj, ref bool lockTaken);
+    private static extern ref ulong GetLockWord(object obj);
 
     [MethodImpl(MethodImplOptions.InternalCall)]
-    private static extern int ExitInternal(object obj);
+    private static extern uint GetCurrentThreadId();
 
     [MethodImpl(MethodImplOptions.InternalCall)]
-    private static extern int PulseInternal(object obj);
+    private static extern int EnterSlow(object obj, uint threadId);
 
     [MethodImpl(MethodImplOptions.InternalCall)]
-    private static extern int PulseAllInternal(object obj);
+    private static extern int ExitSlow(object obj, uint threadId);
 
     [MethodImpl(MethodImplOptions.InternalCall)]
-    private static extern int WaitInternal(object obj);
+    private static extern int PulseSlow(object obj, uint threadId, bool all);
+
+    [MethodImpl(MethodImplOptions.InternalCall)]
+    private static extern int WaitSlow(object obj, uint threadId);
+
+    #endregion
 
 }
\ No newline at end of file
@@ -0,0 +1,50 @@
+using System.Runtime.Intrinsics.X86;
+
+namespace System.Threading;
+
+/// <summary>
+/// A lock that never sleeps, only for very short critical sections. This is a
+/// struct, so it must be stored in a field and never copied.
+/// </summary>
+public struct SpinLock
+{
+
+    private int _taken;
+
+    public bool IsHeld => Volatile.Read(ref _taken) != 0;
+
+    public void Enter(ref bool lockTaken)
+    {
+        if (lockTaken)
+            throw new ArgumentException("Argument must be initialized to false", nameof(lockTaken));
+
+        while (Interlocked.CompareExchange(ref _taken, 1, 0) != 0)
+        {
+            // wait until it looks free before trying again, so we
+            // won't keep bouncing the cache line between the cpus
+            while (Volatile.Read(ref _taken) != 0)
+            {
+                X86Base.Pause();
+            }
+        }
+
+        lockTaken = true;
+    }
+
+    public void TryEnter(ref bool lockTaken)
+    {
+        if (lockTaken)
+            throw new ArgumentException("Argument must be initialized to false", nameof(lockTaken));
+
+        lockTaken = Interlocked.CompareExchange(ref _taken, 1, 0) == 0;
+    }
+
+    public void Exit()
+    {
+        if (Volatile.Read(ref _taken) == 0)
+            throw new SynchronizationLockException();
+
+        Interlocked.Exchange(ref _taken, 0);
+    }
+
+}
\ No newline at end of file
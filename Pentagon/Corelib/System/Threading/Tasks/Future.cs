@@ -6,59 +6,6 @@ using System.Runtime.CompilerServices;
 
 namespace System.Threading.Tasks
 {
-    // lol
-    public class TaskScheduler {
-        internal bool TryRunInline(Task task, bool taskWasPreviouslyQueued)
-        {
-            TaskScheduler? ets = task.ExecutingTaskScheduler;
-
-            if (ets != this && ets != null) return ets.TryRunInline(task, taskWasPreviouslyQueued);
-
-            // TODO: do we really need this?
-            /*if ((ets == null) ||
-                (task.m_action == null) ||
-                task.IsDelegateInvoked ||
-                task.IsCanceled ||
-                !RuntimeHelpers.TryEnsureSufficientExecutionStack())
-            {
-                return false;
-            }*/
-
-            bool inlined = TryExecuteTaskInline(task, taskWasPreviouslyQueued);
-
-            /*if (inlined && !(task.IsDelegateInvoked || task.IsCanceled))
-            {
-                throw new InvalidOperationException(SR.TaskScheduler_InconsistentStateAfterTryExecuteTaskInline);
-            }*/
-
-            return inlined;
-        }
-        protected bool TryExecuteTaskInline(Task task, bool taskWasPreviouslyQueued)
-        {
-            //if (SynchronizationContext.Current == m_synchronizationContext)
-            //{
-                return TryExecuteTask(task);
-            //}
-            //else
-            //{
-            //    return false;
-            //}
-        }
-        protected bool TryExecuteTask(Task task)
-        {
-            if (task.ExecutingTaskScheduler != this)
-            {
-                //throw new InvalidOperationException(SR.TaskScheduler_ExecuteTask_WrongTaskScheduler);
-            }
-
-            return task.ExecuteEntry();
-        }
-    }
-    public class CancellationToken
-    {
-        public bool CanBeCanceled { get => false; }
-    }
-
     // Task<TResult> is here and not in Task.cs. WHYYY?????
     public class Task<TResult> : Task
     {
@@ -147,6 +94,21 @@ namespace System.Threading.Tasks
         {
         }
 
+        internal override void InnerInvoke()
+        {
+            if (m_action is Func<TResult> func)
+            {
+                m_result = func();
+                return;
+            }
+
+            if (m_action is Func<object?, TResult> funcWithState)
+            {
+                m_result = funcWithState(m_stateObject);
+                return;
+            }
+        }
+
 
 
         internal bool TrySetResult(TResult? result)
@@ -42,8 +42,6 @@ namespace System.Threading.Tasks
         }
         private const int CANCELLATION_REQUESTED = 0x1;
 
-        // TODO: [ThreadLocal]
-        internal static Task? t_currentTask;
 
         internal ContingentProperties? m_contingentProperties;
         internal Delegate? m_action;
@@ -303,7 +301,7 @@ namespace System.Threading.Tasks
 
             //if (!IsCancellationRequested & !IsCanceled)
             //{
-                ExecuteWithThreadLocal(ref t_currentTask);
+                ExecuteWithThreadLocal();
             //}
             //else
             //{
@@ -313,15 +311,22 @@ namespace System.Threading.Tasks
             return true;
         }
 
-        // TODO: thread
-        private void ExecuteWithThreadLocal(ref Task? currentTaskSlot)
+        /// <summary>
+        /// Called by the thread pool workers, the task was already marked as started when it was queued
+        /// </summary>
+        internal void ExecuteFromThreadPool()
         {
-            Task? previousTask = currentTaskSlot;
+            ExecuteEntry();
+        }
+
+        private void ExecuteWithThreadLocal()
+        {
+            Task? previousTask = GetNativeCurrentTask();
 
             try
             {
-                // place the current task into TLS.
-                currentTaskSlot = this;
+                // place the current task into the thread control block
+                SetNativeCurrentTask(this);
 
                 // Execute the task body
                 try
@@ -352,7 +357,7 @@ namespace System.Threading.Tasks
             }
             finally
             {
-                currentTaskSlot = previousTask;
+                SetNativeCurrentTask(previousTask);
             }
         }
         internal virtual void InnerInvoke()
@@ -552,6 +557,7 @@ namespace System.Threading.Tasks
         {
             m_action = action;
             m_stateObject = state;
+            m_taskScheduler = scheduler;
 
             // TODO: check option validity
             int tmpFlags = (int)creationOptions | (int)internalOptions;
@@ -593,24 +599,205 @@ namespace System.Threading.Tasks
 
         internal bool TrySetResult()
         {
-            m_stateFlags = (int)TaskStateFlags.CompletionReserved | (int)TaskStateFlags.RanToCompletion;
+            if (!AtomicStateUpdate((int)TaskStateFlags.CompletionReserved | (int)TaskStateFlags.RanToCompletion,
+                    (int)TaskStateFlags.CompletionReserved | (int)TaskStateFlags.RanToCompletion | (int)TaskStateFlags.Faulted | (int)TaskStateFlags.Canceled))
+            {
+                return false;
+            }
+
+            ContingentProperties? props = m_contingentProperties;
+            if (props != null)
+            {
+                NotifyParentIfPotentiallyAttachedTask();
+                props.SetCompleted();
+            }
+            FinishContinuations();
+            return true;
+        }
+
+        internal bool TrySetCanceled(CancellationToken cancellationToken)
+        {
+            if (!AtomicStateUpdate((int)TaskStateFlags.CompletionReserved | (int)TaskStateFlags.Canceled | (int)TaskStateFlags.CancellationAcknowledged,
+                    (int)TaskStateFlags.CompletionReserved | (int)TaskStateFlags.RanToCompletion | (int)TaskStateFlags.Faulted | (int)TaskStateFlags.Canceled))
+            {
+                return false;
+            }
+
+            ContingentProperties props = EnsureContingentPropertiesInitialized();
+            props.m_cancellationToken = cancellationToken;
+            props.m_internalCancellationRequested = CANCELLATION_REQUESTED;
+            NotifyParentIfPotentiallyAttachedTask();
+            props.SetCompleted();
+            FinishContinuations();
             return true;
         }
 
+        #region Delay
+
+        public static Task Delay(int millisecondsDelay)
+        {
+            return Delay(millisecondsDelay, default);
+        }
+
+        public static Task Delay(TimeSpan delay)
+        {
+            return Delay(TimerQueueTimer.ToMilliseconds(delay, nameof(delay)), default);
+        }
+
+        public static Task Delay(TimeSpan delay, CancellationToken cancellationToken)
+        {
+            return Delay(TimerQueueTimer.ToMilliseconds(delay, nameof(delay)), cancellationToken);
+        }
+
+        public static Task Delay(int millisecondsDelay, CancellationToken cancellationToken)
+        {
+            if (millisecondsDelay < -1)
+                throw new ArgumentOutOfRangeException(nameof(millisecondsDelay), "Number must be either non-negative and less than or equal to Int32.MaxValue or -1.");
+
+            if (cancellationToken.IsCancellationRequested)
+                return new Task(true, TaskCreationOptions.None, cancellationToken);
+
+            if (millisecondsDelay == 0)
+                return CompletedTask;
+
+            return new DelayPromise(millisecondsDelay, cancellationToken);
+        }
+
+        /// <summary>
+        /// A task that is completed by a timer of the timer queue, no thread
+        /// waits for it, so any amount of delays can be pending at once
+        /// </summary>
+        private sealed class DelayPromise : Task
+        {
+            private readonly TimerQueueTimer _timer;
+            private readonly CancellationToken _token;
+            private readonly CancellationTokenRegistration _registration;
+
+            internal DelayPromise(int millisecondsDelay, CancellationToken cancellationToken)
+            {
+                _token = cancellationToken;
+
+                // register before starting the timer, if we get canceled in
+                // between the closed timer will refuse to start
+                if (millisecondsDelay != Timeout.Infinite)
+                {
+                    _timer = new TimerQueueTimer(OnTimer, this);
+                }
+
+                if (cancellationToken.CanBeCanceled)
+                {
+                    _registration = cancellationToken.Register(OnCanceled, this);
+                }
+
+                _timer?.Change(millisecondsDelay, Timeout.Infinite);
+            }
+
+            private static void OnTimer(object state)
+            {
+                var promise = (DelayPromise)state;
+                if (promise.TrySetResult())
+                {
+                    promise._registration.Dispose();
+                }
+            }
+
+            private static void OnCanceled(object state)
+            {
+                var promise = (DelayPromise)state;
+                if (promise.TrySetCanceled(promise._token))
+                {
+                    promise._timer?.Close();
+                }
+            }
+        }
+
+        #endregion
+
+        #region Start and Run
+
+        public void Start()
+        {
+            Start(TaskScheduler.Current);
+        }
+
+        public void Start(TaskScheduler scheduler)
+        {
+            if (scheduler == null)
+                throw new ArgumentNullException(nameof(scheduler));
+
+            if (IsCompleted)
+                throw new InvalidOperationException("Start may not be called on a task that has completed.");
+
+            if (m_action == null || (m_stateFlags & (int)InternalTaskOptions.PromiseTask) != 0)
+                throw new InvalidOperationException("Start may not be called on a promise-style task.");
+
+            m_taskScheduler = scheduler;
+            ScheduleAndStart(true);
+        }
+
+        internal void ScheduleAndStart(bool needsProtection)
+        {
+            if (needsProtection)
+            {
+                if (!MarkStarted())
+                    throw new InvalidOperationException("Start may not be called on a task that was already started.");
+            }
+            else
+            {
+                m_stateFlags |= (int)TaskStateFlags.Started;
+            }
+
+            m_taskScheduler!.InternalQueueTask(this);
+        }
+
+        public static Task Run(Action action)
+        {
+            if (action == null)
+                throw new ArgumentNullException(nameof(action));
+
+            var task = new Task(action, null, null, default,
+                TaskCreationOptions.DenyChildAttach, InternalTaskOptions.None, TaskScheduler.Default);
+            task.ScheduleAndStart(false);
+            return task;
+        }
+
+        public static Task<TResult> Run<TResult>(Func<TResult> function)
+        {
+            if (function == null)
+                throw new ArgumentNullException(nameof(function));
+
+            var task = new Task<TResult>(function, null, default,
+                TaskCreationOptions.DenyChildAttach, InternalTaskOptions.None, TaskScheduler.Default);
+            task.ScheduleAndStart(false);
+            return task;
+        }
+
+        #endregion
+
         public static Task<TResult> FromResult<TResult>(TResult result)
         {
             // TODO: default result task
             return new Task<TResult>(result);
         }
 
-        internal static Task? InternalCurrent => t_currentTask;
+        /// <summary>
+        /// The task running on the current thread, every thread has its own
+        /// </summary>
+        internal static Task? InternalCurrent => GetNativeCurrentTask();
+
+        [MethodImpl(MethodImplOptions.InternalCall)]
+        internal static extern Task? GetNativeCurrentTask();
+
+        [MethodImpl(MethodImplOptions.InternalCall)]
+        internal static extern void SetNativeCurrentTask(Task? task);
 
 
         internal sealed class ContingentProperties
         {
             // TODO: ExecutionContext
 
-            internal /*volatile*/ ManualResetEvent? m_completionEvent;
+            // TODO: Wait, nothing creates the completion event until then
+            //internal volatile ManualResetEvent? m_completionEvent;
             //internal volatile TaskExceptionHolder? m_exceptionsHolder;
             internal CancellationToken m_cancellationToken;
             //internal StrongBox<CancellationTokenRegistration>? m_cancellationRegistration;
@@ -622,11 +809,11 @@ namespace System.Threading.Tasks
 
             internal void SetCompleted()
             {
-                ManualResetEvent? mres = m_completionEvent;
-                if (mres != null) SetEvent(mres);
+                /*ManualResetEvent? mres = m_completionEvent;
+                if (mres != null) SetEvent(mres);*/
             }
 
-            internal static void SetEvent(ManualResetEvent mres)
+            /*internal static void SetEvent(ManualResetEvent mres)
             {
                 try
                 {
@@ -635,7 +822,7 @@ namespace System.Threading.Tasks
                 catch (ObjectDisposedException)
                 {
                 }
-            }
+            }*/
 
             internal void UnregisterCancellationCallback()
             {
@@ -42,5 +42,28 @@ namespace System.Threading.Tasks
             }
             return rval;
         }
+
+        public void SetCanceled()
+        {
+            SetCanceled(default);
+        }
+
+        public void SetCanceled(CancellationToken cancellationToken)
+        {
+            if (!TrySetCanceled(cancellationToken))
+            {
+                throw new InvalidOperationException("An attempt was made to transition a task to a final state when it had already completed.");
+            }
+        }
+
+        public bool TrySetCanceled()
+        {
+            return TrySetCanceled(default);
+        }
+
+        public bool TrySetCanceled(CancellationToken cancellationToken)
+        {
+            return _task.TrySetCanceled(cancellationToken);
+        }
     }
 }
\ No newline at end of file
@@ -27,8 +27,7 @@ namespace System.Threading.Tasks
             {
                 if (!task.m_taskScheduler.TryRunInline(task, taskWasPreviouslyQueued: false))
                 {
-                    //TODO:
-                    //task.m_taskScheduler.InternalQueueTask(task);
+                    task.m_taskScheduler.InternalQueueTask(task);
                 }
             }
             catch (Exception e)
@@ -70,21 +69,20 @@ namespace System.Threading.Tasks
         protected static ContextCallback GetInvokeActionCallback() => s_invokeContextCallback;
         internal override void Run(Task task, bool canInlineContinuationTask)
         {
-            //if (canInlineContinuationTask && IsValidLocationForInlining)
-            //{
-                RunCallback(GetInvokeActionCallback(), m_action, ref Task.t_currentTask);
-            //}
-            //else
-            //{
-            //    ThreadPool.UnsafeQueueUserWorkItemInternal(this, preferLocal: true);
-            //}
+            if (canInlineContinuationTask) //&& IsValidLocationForInlining)
+            {
+                RunCallback(GetInvokeActionCallback(), m_action);
+            }
+            else
+            {
+                ThreadPool.UnsafeQueueUserWorkItemInternal(this, preferLocal: true);
+            }
         }
 
         
         void IThreadPoolWorkItem.Execute()
         {
-            // TODO:
-            m_action();
+            RunCallback(GetInvokeActionCallback(), m_action);
         }
 
         /*private static readonly ContextCallback s_invokeContextCallback = static (state) =>
@@ -96,12 +94,12 @@ namespace System.Threading.Tasks
 
         //protected static ContextCallback GetInvokeActionCallback() => s_invokeContextCallback;
 
-        protected void RunCallback(ContextCallback callback, object? state, ref Task? currentTask)
+        protected void RunCallback(ContextCallback callback, object? state)
         {
-            Task? prevCurrentTask = currentTask;
+            Task? prevCurrentTask = Task.GetNativeCurrentTask();
             try
             {
-                if (prevCurrentTask != null) currentTask = null;
+                if (prevCurrentTask != null) Task.SetNativeCurrentTask(null);
 
                 //ExecutionContext? context = m_capturedContext;
                 //if (context == null)
@@ -119,14 +117,13 @@ namespace System.Threading.Tasks
             }
             finally
             {
-                if (prevCurrentTask != null) currentTask = prevCurrentTask;
+                if (prevCurrentTask != null) Task.SetNativeCurrentTask(prevCurrentTask);
             }
         }
 
         internal static void RunOrScheduleAction(Action action, bool allowInlining)
         {
-            ref Task? currentTask = ref Task.t_currentTask;
-            Task? prevCurrentTask = currentTask;
+            Task? prevCurrentTask = Task.GetNativeCurrentTask();
 
             if (!allowInlining) //|| !IsValidLocationForInlining)
             {
@@ -136,7 +133,7 @@ namespace System.Threading.Tasks
 
             try
             {
-                if (prevCurrentTask != null) currentTask = null;
+                if (prevCurrentTask != null) Task.SetNativeCurrentTask(null);
                 action();
             }
             catch (Exception exception)
@@ -145,23 +142,22 @@ namespace System.Threading.Tasks
             }
             finally
             {
-                if (prevCurrentTask != null) currentTask = prevCurrentTask;
+                if (prevCurrentTask != null) Task.SetNativeCurrentTask(prevCurrentTask);
             }
         }
         internal static void RunOrScheduleAction(IAsyncStateMachineBox box, bool allowInlining)
         {
-            ref Task? currentTask = ref Task.t_currentTask;
-            Task? prevCurrentTask = currentTask;
+            Task? prevCurrentTask = Task.GetNativeCurrentTask();
 
             if (!allowInlining) //|| !IsValidLocationForInlining)
             {
-                //ThreadPool.UnsafeQueueUserWorkItemInternal(box, preferLocal: true);
+                ThreadPool.UnsafeQueueUserWorkItemInternal(box, preferLocal: true);
                 return;
             }
 
             try
             {
-                if (prevCurrentTask != null) currentTask = null;
+                if (prevCurrentTask != null) Task.SetNativeCurrentTask(null);
                 box.MoveNext();
             }
             catch (Exception exception)
@@ -170,13 +166,13 @@ namespace System.Threading.Tasks
             }
             finally
             {
-                if (prevCurrentTask != null) currentTask = prevCurrentTask;
+                if (prevCurrentTask != null) Task.SetNativeCurrentTask(prevCurrentTask);
             }
         }
         internal static void UnsafeScheduleAction(Action action, Task? task)
         {
             AwaitTaskContinuation atc = new AwaitTaskContinuation(action, flowExecutionContext: false);
-            //ThreadPool.UnsafeQueueUserWorkItemInternal(atc, preferLocal: true);
+            ThreadPool.UnsafeQueueUserWorkItemInternal(atc, preferLocal: true);
         }
     }
 }
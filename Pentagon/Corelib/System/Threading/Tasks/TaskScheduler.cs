@@ -0,0 +1,74 @@
+﻿using System.Runtime.CompilerServices;
+
+namespace System.Threading.Tasks
+{
+    public abstract class TaskScheduler
+    {
+        private static readonly TaskScheduler s_defaultTaskScheduler = new ThreadPoolTaskScheduler();
+
+        /// <summary>
+        /// The scheduler that runs tasks on the thread pool
+        /// </summary>
+        public static TaskScheduler Default => s_defaultTaskScheduler;
+
+        /// <summary>
+        /// The scheduler of the currently running task, or the default one
+        /// </summary>
+        public static TaskScheduler Current => InternalCurrent ?? Default;
+
+        internal static TaskScheduler InternalCurrent
+        {
+            get
+            {
+                Task currentTask = Task.InternalCurrent;
+                return (currentTask != null && (currentTask.CreationOptions & TaskCreationOptions.HideScheduler) == 0)
+                    ? currentTask.ExecutingTaskScheduler
+                    : null;
+            }
+        }
+
+        protected internal abstract void QueueTask(Task task);
+
+        protected abstract bool TryExecuteTaskInline(Task task, bool taskWasPreviouslyQueued);
+
+        internal void InternalQueueTask(Task task)
+        {
+            QueueTask(task);
+        }
+
+        internal bool TryRunInline(Task task, bool taskWasPreviouslyQueued)
+        {
+            TaskScheduler ets = task.ExecutingTaskScheduler;
+
+            if (ets != this && ets != null) return ets.TryRunInline(task, taskWasPreviouslyQueued);
+
+            return TryExecuteTaskInline(task, taskWasPreviouslyQueued);
+        }
+
+        protected bool TryExecuteTask(Task task)
+        {
+            if (task.ExecutingTaskScheduler != this)
+                throw new InvalidOperationException("ExecuteTask may not be called for a task which was previously queued to a different TaskScheduler.");
+
+            return task.ExecuteEntry();
+        }
+    }
+
+    /// <summary>
+    /// Queues the tasks to the thread pool, tasks queued from a worker go to the
+    /// deque of that worker unless they asked for fairness
+    /// </summary>
+    internal sealed class ThreadPoolTaskScheduler : TaskScheduler
+    {
+        protected internal override void QueueTask(Task task)
+        {
+            bool preferLocal = (task.Options & TaskCreationOptions.PreferFairness) == 0;
+            ThreadPool.UnsafeQueueUserWorkItemInternal(task, preferLocal);
+        }
+
+        protected override bool TryExecuteTaskInline(Task task, bool taskWasPreviouslyQueued)
+        {
+            return TryExecuteTask(task);
+        }
+    }
+}
\ No newline at end of file
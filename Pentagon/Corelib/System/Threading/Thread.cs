@@ -18,6 +18,11 @@ public sealed class Thread
 
     public bool IsAlive => (GetNativeThreadState(_threadHandle) & 0xFFF) < 5;
 
+    /// <summary>
+    /// Is this one of the workers of the thread pool
+    /// </summary>
+    public bool IsThreadPoolThread => ThreadPool.IsWorkerThread(this);
+
     private string _name = null;
     public string Name
     {
@@ -109,6 +114,13 @@ public sealed class Thread
 
     [MethodImpl(MethodImplOptions.InternalCall)]
     public static extern bool Yield();
+
+    /// <summary>
+    /// The id of the cpu we are running on, we may be moved to another cpu right after
+    /// so this can only be used as a hint (like for picking a per-cpu cache)
+    /// </summary>
+    [MethodImpl(MethodImplOptions.InternalCall)]
+    public static extern int GetCurrentProcessorId();
     
     [MethodImpl(MethodImplOptions.InternalCall)]
     private static extern int GetNativeThreadState(ulong thread);
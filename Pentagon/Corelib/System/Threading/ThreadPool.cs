@@ -0,0 +1,74 @@
+using System.Runtime.CompilerServices;
+using System.Threading.Tasks;
+
+namespace System.Threading;
+
+/// <summary>
+/// A pool with a worker thread per cpu, work queued from a worker goes to the
+/// deque of that worker (when preferLocal is set), everything else goes to the
+/// global queue, idle workers steal from the deques of the other workers.
+/// </summary>
+public static class ThreadPool
+{
+
+    private static readonly ThreadPoolWorkQueue s_workQueue = new(Environment.ProcessorCount);
+
+    public static int ThreadCount => Environment.ProcessorCount;
+
+    internal static bool IsWorkerThread(Thread thread) => s_workQueue.IsWorker(thread);
+
+    public static bool QueueUserWorkItem(WaitCallback callBack)
+    {
+        return QueueUserWorkItem(callBack, null);
+    }
+
+    public static bool QueueUserWorkItem(WaitCallback callBack, object state)
+    {
+        if (callBack == null)
+            throw new ArgumentNullException(nameof(callBack));
+
+        s_workQueue.Enqueue(new QueueUserWorkItemCallback(callBack, state), preferLocal: false);
+        return true;
+    }
+
+    public static bool UnsafeQueueUserWorkItem(IThreadPoolWorkItem callBack, bool preferLocal)
+    {
+        if (callBack == null)
+            throw new ArgumentNullException(nameof(callBack));
+
+        // tasks must go through their scheduler
+        if (callBack is Task)
+            throw new ArgumentOutOfRangeException(nameof(callBack));
+
+        s_workQueue.Enqueue(callBack, preferLocal);
+        return true;
+    }
+
+    /// <summary>
+    /// Queue a work item, it must be a Task, an IAsyncStateMachineBox or an IThreadPoolWorkItem
+    /// </summary>
+    internal static void UnsafeQueueUserWorkItemInternal(object callBack, bool preferLocal)
+    {
+        s_workQueue.Enqueue(callBack, preferLocal);
+    }
+
+    private sealed class QueueUserWorkItemCallback : IThreadPoolWorkItem
+    {
+
+        private readonly WaitCallback _callback;
+        private readonly object _state;
+
+        public QueueUserWorkItemCallback(WaitCallback callback, object state)
+        {
+            _callback = callback;
+            _state = state;
+        }
+
+        public void Execute()
+        {
+            _callback(_state);
+        }
+
+    }
+
+}
\ No newline at end of file
@@ -0,0 +1,372 @@
+using System.Collections.Generic;
+using System.Diagnostics;
+using System.Runtime.CompilerServices;
+using System.Threading.Tasks;
+
+namespace System.Threading;
+
+/// <summary>
+/// The queues of the thread pool, there is a global queue for work coming from outside
+/// of the pool, and a deque per worker. A worker pushes and pops its own work from the
+/// tail of its deque (so the newest work, which is still in the cache, runs first), and
+/// when it runs out of work it steals the oldest work from the head of the other deques.
+/// </summary>
+internal sealed class ThreadPoolWorkQueue
+{
+
+    /// <summary>
+    /// A double ended queue, the owner works on the tail while thieves take from the head. The
+    /// critical sections are a few instructions long and the owner is normally the only one
+    /// touching the deque, so a spinlock is enough.
+    /// </summary>
+    internal sealed class WorkStealingQueue
+    {
+
+        private const int InitialSize = 32;
+
+        private object[] _array = new object[InitialSize];
+        private int _mask = InitialSize - 1;
+
+        // head is the oldest item, tail is one after the newest item,
+        // both grow forever and are masked when indexing the array
+        private int _head;
+        private int _tail;
+
+        private SpinLock _lock;
+
+        public bool CanSteal => _head < _tail;
+
+        public void LocalPush(object item)
+        {
+            var lockTaken = false;
+            _lock.Enter(ref lockTaken);
+
+            if (_tail - _head == _array.Length)
+            {
+                Grow();
+            }
+
+            _array[_tail & _mask] = item;
+            _tail++;
+
+            _lock.Exit();
+        }
+
+        private void Grow()
+        {
+            var array = new object[_array.Length * 2];
+            for (var i = 0; i < _array.Length; i++)
+            {
+                array[i] = _array[(_head + i) & _mask];
+            }
+
+            _tail -= _head;
+            _head = 0;
+            _array = array;
+            _mask = array.Length - 1;
+        }
+
+        public object LocalPop()
+        {
+            if (_head >= _tail)
+                return null;
+
+            var lockTaken = false;
+            _lock.Enter(ref lockTaken);
+
+            object item = null;
+            if (_head < _tail)
+            {
+                _tail--;
+                var index = _tail & _mask;
+                item = _array[index];
+                _array[index] = null;
+            }
+
+            _lock.Exit();
+            return item;
+        }
+
+        public object TrySteal()
+        {
+            if (_head >= _tail)
+                return null;
+
+            // don't wait behind the owner, just try the next victim
+            var lockTaken = false;
+            _lock.TryEnter(ref lockTaken);
+            if (!lockTaken)
+                return null;
+
+            object item = null;
+            if (_head < _tail)
+            {
+                var index = _head & _mask;
+                item = _array[index];
+                _array[index] = null;
+                _head++;
+            }
+
+            _lock.Exit();
+            return item;
+        }
+
+    }
+
+    /// <summary>
+    /// The global queue, a ring buffer that is only used for work
+    /// queued from outside the pool or without preferLocal
+    /// </summary>
+    private sealed class GlobalQueue
+    {
+
+        private object[] _array = new object[64];
+        private int _head;
+        private int _count;
+        private SpinLock _lock;
+
+        public int Count => _count;
+
+        public void Enqueue(object item)
+        {
+            var lockTaken = false;
+            _lock.Enter(ref lockTaken);
+
+            if (_count == _array.Length)
+            {
+                var array = new object[_array.Length * 2];
+                for (var i = 0; i < _count; i++)
+                {
+                    array[i] = _array[(_head + i) % _array.Length];
+                }
+                _array = array;
+                _head = 0;
+            }
+
+            _array[(_head + _count) % _array.Length] = item;
+            _count++;
+
+            _lock.Exit();
+        }
+
+        public object TryDequeue()
+        {
+            if (_count == 0)
+                return null;
+
+            var lockTaken = false;
+            _lock.Enter(ref lockTaken);
+
+            object item = null;
+            if (_count != 0)
+            {
+                item = _array[_head];
+                _array[_head] = null;
+                _head = (_head + 1) % _array.Length;
+                _count--;
+            }
+
+            _lock.Exit();
+            return item;
+        }
+
+    }
+
+    private sealed class Worker
+    {
+        public readonly WorkStealingQueue Queue = new();
+        public int Index;
+        public Thread Thread;
+    }
+
+    private readonly GlobalQueue _globalQueue = new();
+    private readonly Worker[] _workers;
+
+    // only written before the workers are started, so it is safe to read without a lock
+    private readonly Dictionary<Thread, Worker> _threadToWorker;
+
+    // the amount of workers that are waiting (or about to wait) on the semaphore
+    private int _idleWorkers;
+    private readonly Semaphore _wakeup;
+
+    public ThreadPoolWorkQueue(int workerCount)
+    {
+        _workers = new Worker[workerCount];
+        _threadToWorker = new Dictionary<Thread, Worker>(workerCount);
+        _wakeup = new Semaphore(0, workerCount);
+
+        for (var i = 0; i < workerCount; i++)
+        {
+            var worker = new Worker { Index = i };
+            worker.Thread = new Thread(WorkerMain);
+            _workers[i] = worker;
+            _threadToWorker.Add(worker.Thread, worker);
+        }
+
+        for (var i = 0; i < workerCount; i++)
+        {
+            _workers[i].Thread.Name = "threadpool/worker";
+            _workers[i].Thread.Start(_workers[i]);
+        }
+    }
+
+    private Worker GetCurrentWorker()
+    {
+        var thread = Thread.CurrentThread;
+        if (thread == null)
+            return null;
+
+        return _threadToWorker.TryGetValue(thread, out var worker) ? worker : null;
+    }
+
+    /// <summary>
+    /// The workers are only added by the constructor, so this doesn't need a lock
+    /// </summary>
+    public bool IsWorker(Thread thread)
+    {
+        return _threadToWorker.ContainsKey(thread);
+    }
+
+    public void Enqueue(object workItem, bool preferLocal)
+    {
+        var worker = preferLocal ? GetCurrentWorker() : null;
+        if (worker != null)
+        {
+            worker.Queue.LocalPush(workItem);
+        }
+        else
+        {
+            _globalQueue.Enqueue(workItem);
+        }
+
+        WakeWorker();
+    }
+
+    #region Idle workers
+
+    private void WakeWorker()
+    {
+        // claim one idle worker, the semaphore count can never be more than
+        // the amount of claimed workers so the release can't overflow it
+        var idle = _idleWorkers;
+        while (idle > 0)
+        {
+            var old = Interlocked.CompareExchange(ref _idleWorkers, idle - 1, idle);
+            if (old == idle)
+            {
+                _wakeup.Release();
+                return;
+            }
+            idle = old;
+        }
+    }
+
+    private bool HasWork()
+    {
+        if (_globalQueue.Count != 0)
+            return true;
+
+        for (var i = 0; i < _workers.Length; i++)
+        {
+            if (_workers[i].Queue.CanSteal)
+                return true;
+        }
+
+        return false;
+    }
+
+    private void WaitForWork()
+    {
+        Interlocked.Increment(ref _idleWorkers);
+
+        // work might have been queued after we last looked and before we
+        // marked ourselves as idle, in which case no one is going to wake us
+        if (HasWork())
+        {
+            var idle = _idleWorkers;
+            while (idle > 0)
+            {
+                var old = Interlocked.CompareExchange(ref _idleWorkers, idle - 1, idle);
+                if (old == idle)
+                    return;
+                idle = old;
+            }
+
+            // someone already claimed us, so there is a wakeup waiting for us
+        }
+
+        _wakeup.WaitOne();
+    }
+
+    #endregion
+
+    #region Dispatch
+
+    private object Dequeue(Worker worker)
+    {
+        var item = worker.Queue.LocalPop();
+        if (item != null)
+            return item;
+
+        item = _globalQueue.TryDequeue();
+        if (item != null)
+            return item;
+
+        // start from our neighbour so not all the workers will hit the same victim
+        for (var i = 1; i < _workers.Length; i++)
+        {
+            var victim = _workers[(worker.Index + i) % _workers.Length];
+            item = victim.Queue.TrySteal();
+            if (item != null)
+                return item;
+        }
+
+        return null;
+    }
+
+    private void WorkerMain(object parameter)
+    {
+        var worker = (Worker)parameter;
+        while (true)
+        {
+            var item = Dequeue(worker);
+            if (item == null)
+            {
+                WaitForWork();
+                continue;
+            }
+
+            Dispatch(item);
+        }
+    }
+
+    private static void Dispatch(object item)
+    {
+        try
+        {
+            // the state machine box is also a task, so it must be checked first
+            switch (item)
+            {
+                case IAsyncStateMachineBox box:
+                    box.MoveNext();
+                    break;
+
+                case Task task:
+                    task.ExecuteFromThreadPool();
+                    break;
+
+                case IThreadPoolWorkItem workItem:
+                    workItem.Execute();
+                    break;
+            }
+        }
+        catch (Exception e)
+        {
+            // report it and keep the worker alive, so the pool won't shrink
+            Debug.Fail(string.Concat("Unhandled exception in a thread pool work item: ", e.Message));
+        }
+    }
+
+    #endregion
+
+}
\ No newline at end of file
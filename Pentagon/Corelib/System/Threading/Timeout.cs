@@ -0,0 +1,10 @@
+namespace System.Threading;
+
+public static class Timeout
+{
+
+    public static readonly TimeSpan InfiniteTimeSpan = new(Infinite * TimeSpan.TicksPerMillisecond);
+
+    public const int Infinite = -1;
+
+}
\ No newline at end of file
@@ -0,0 +1,74 @@
+namespace System.Threading;
+
+public delegate void TimerCallback(object state);
+
+/// <summary>
+/// A timer on the shared timer queue, the callback runs on the thread pool
+/// </summary>
+public sealed class Timer : IDisposable
+{
+
+    private readonly TimerQueueTimer _timer;
+
+    public Timer(TimerCallback callback)
+        : this(callback, null, Timeout.Infinite, Timeout.Infinite)
+    {
+    }
+
+    public Timer(TimerCallback callback, object state, int dueTime, int period)
+    {
+        if (callback == null)
+            throw new ArgumentNullException(nameof(callback));
+
+        ValidateTimes(dueTime, period);
+
+        _timer = new TimerQueueTimer(callback, state);
+        _timer.Change(dueTime, period);
+    }
+
+    public Timer(TimerCallback callback, object state, TimeSpan dueTime, TimeSpan period)
+        : this(callback, state,
+            TimerQueueTimer.ToMilliseconds(dueTime, nameof(dueTime)),
+            TimerQueueTimer.ToMilliseconds(period, nameof(period)))
+    {
+    }
+
+    ~Timer()
+    {
+        // no one can change or dispose it anymore, so stop it
+        _timer.Close();
+    }
+
+    public bool Change(int dueTime, int period)
+    {
+        ValidateTimes(dueTime, period);
+
+        if (!_timer.Change(dueTime, period))
+            throw new ObjectDisposedException();
+
+        return true;
+    }
+
+    public bool Change(TimeSpan dueTime, TimeSpan period)
+    {
+        return Change(
+            TimerQueueTimer.ToMilliseconds(dueTime, nameof(dueTime)),
+            TimerQueueTimer.ToMilliseconds(period, nameof(period)));
+    }
+
+    private static void ValidateTimes(int dueTime, int period)
+    {
+        if (dueTime < -1)
+            throw new ArgumentOutOfRangeException(nameof(dueTime), "Number must be either non-negative and less than or equal to Int32.MaxValue or -1.");
+
+        if (period < -1)
+            throw new ArgumentOutOfRangeException(nameof(period), "Number must be either non-negative and less than or equal to Int32.MaxValue or -1.");
+    }
+
+    public void Dispose()
+    {
+        _timer.Close();
+        GC.SuppressFinalize(this);
+    }
+
+}
\ No newline at end of file
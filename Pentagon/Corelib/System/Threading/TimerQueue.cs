@@ -0,0 +1,332 @@
+using System.Runtime.CompilerServices;
+
+namespace System.Threading;
+
+/// <summary>
+/// A single timer of the queue, this is what Timer, Task.Delay and CancelAfter are built on, when
+/// it expires the callback is queued to the thread pool so a slow callback can't delay other timers
+/// </summary>
+internal sealed class TimerQueueTimer : IThreadPoolWorkItem
+{
+
+    private readonly TimerCallback _callback;
+    private readonly object _state;
+
+    // absolute due time and the period (zero for one shot), in microseconds
+    internal long DueTime;
+    internal long Period;
+
+    // the index in the heap of the queue, -1 when not scheduled
+    internal int HeapIndex = -1;
+
+    internal bool Closed;
+
+    public TimerQueueTimer(TimerCallback callback, object state)
+    {
+        _callback = callback;
+        _state = state;
+    }
+
+    /// <summary>
+    /// Change the timer, the times are in milliseconds and Timeout.Infinite
+    /// disables the timer (dueTime) or makes it one shot (period)
+    /// </summary>
+    /// <returns>false if the timer was already closed</returns>
+    public bool Change(int dueTime, int period)
+    {
+        return TimerQueue.Instance.Change(this,
+            dueTime == Timeout.Infinite ? -1 : dueTime * 1000L,
+            period == Timeout.Infinite ? 0 : period * 1000L);
+    }
+
+    public void Close()
+    {
+        TimerQueue.Instance.Close(this);
+    }
+
+    void IThreadPoolWorkItem.Execute()
+    {
+        // might have been closed while it was waiting in the thread pool
+        if (Closed)
+            return;
+
+        _callback(_state);
+    }
+
+    internal static int ToMilliseconds(TimeSpan time, string paramName)
+    {
+        var milliseconds = time.Ticks / TimeSpan.TicksPerMillisecond;
+        if (milliseconds < -1 || milliseconds > int.MaxValue)
+            throw new ArgumentOutOfRangeException(paramName, "Number must be either non-negative and less than or equal to Int32.MaxValue or -1.");
+        return (int)milliseconds;
+    }
+
+}
+
+/// <summary>
+/// All the managed timers are kept in a single min-heap by due time, with one kernel timer armed
+/// for the earliest of them. The kernel timer callback can't run managed code, so it only signals
+/// a waitable, and a single dispatcher thread pops the expired timers and hands them to the thread
+/// pool. No matter how many timers are pending there is only one kernel timer and one thread.
+/// </summary>
+internal sealed class TimerQueue
+{
+
+    /// <summary>
+    /// The kernel timer is armed on a multiple of this (in microseconds), so all the
+    /// timers that expire in the same slot are handled by a single wakeup
+    /// </summary>
+    private const long Resolution = 1000;
+
+    public static readonly TimerQueue Instance = new();
+
+    private TimerQueueTimer[] _heap = new TimerQueueTimer[32];
+    private int _count;
+    private SpinLock _lock;
+
+    private readonly ulong _waitable;
+    private readonly ulong _nativeTimer;
+
+    // the time the kernel timer is armed for, zero if it is not armed
+    private long _armedTime;
+
+    private TimerQueue()
+    {
+        _waitable = WaitHandle.CreateWaitable(1);
+        _nativeTimer = CreateNativeTimer(_waitable);
+        if (_nativeTimer == 0)
+            throw new OutOfMemoryException();
+
+        var thread = new Thread(DispatcherMain);
+        thread.Name = "timer/dispatcher";
+        thread.Start();
+    }
+
+    #region Timers
+
+    /// <summary>
+    /// Schedule the timer, a negative due time stops it
+    /// </summary>
+    public bool Change(TimerQueueTimer timer, long dueTime, long period)
+    {
+        var now = GetMicrotime();
+
+        var lockTaken = false;
+        _lock.Enter(ref lockTaken);
+
+        if (timer.Closed)
+        {
+            _lock.Exit();
+            return false;
+        }
+
+        if (dueTime < 0)
+        {
+            if (timer.HeapIndex >= 0)
+            {
+                RemoveAt(timer.HeapIndex);
+            }
+        }
+        else
+        {
+            timer.DueTime = now + dueTime;
+            timer.Period = period;
+
+            if (timer.HeapIndex < 0)
+            {
+                Insert(timer);
+            }
+            else
+            {
+                // it can move either way
+                SiftUp(timer.HeapIndex);
+                SiftDown(timer.HeapIndex);
+            }
+
+            EnsureArmed();
+        }
+
+        _lock.Exit();
+        return true;
+    }
+
+    public void Close(TimerQueueTimer timer)
+    {
+        var lockTaken = false;
+        _lock.Enter(ref lockTaken);
+
+        timer.Closed = true;
+        if (timer.HeapIndex >= 0)
+        {
+            // we don't disarm the kernel timer, if this was the earliest
+            // timer the dispatcher will just wake up to find nothing
+            RemoveAt(timer.HeapIndex);
+        }
+
+        _lock.Exit();
+    }
+
+    /// <summary>
+    /// Make sure the kernel timer will fire for the earliest timer, must be called with the lock
+    /// </summary>
+    private void EnsureArmed()
+    {
+        if (_count == 0)
+            return;
+
+        // round up to the resolution, so the timer is never early
+        var time = (_heap[0].DueTime + Resolution - 1) / Resolution * Resolution;
+
+        // already going to wake up in time, an earlier wakeup will rearm it
+        if (_armedTime != 0 && _armedTime <= time)
+            return;
+
+        _armedTime = time;
+        ChangeNativeTimer(_nativeTimer, time);
+    }
+
+    #endregion
+
+    #region Dispatcher
+
+    private void DispatcherMain()
+    {
+        while (true)
+        {
+            // the waitable has a single slot, so any amount of kernel
+            // timer expirations turns into a single wakeup
+            WaitHandle.WaitableWait(_waitable, true);
+
+            var now = GetMicrotime();
+
+            var lockTaken = false;
+            _lock.Enter(ref lockTaken);
+            _armedTime = 0;
+
+            while (_count != 0 && _heap[0].DueTime <= now)
+            {
+                var timer = _heap[0];
+                if (timer.Period > 0)
+                {
+                    // if we fell behind don't try to catch up on the missed periods
+                    timer.DueTime += timer.Period;
+                    if (timer.DueTime <= now)
+                    {
+                        timer.DueTime = now + timer.Period;
+                    }
+                    SiftDown(0);
+                }
+                else
+                {
+                    RemoveAt(0);
+                }
+
+                // queueing is short and never blocks, so it is fine to do under the lock
+                ThreadPool.UnsafeQueueUserWorkItemInternal(timer, preferLocal: false);
+            }
+
+            EnsureArmed();
+            _lock.Exit();
+        }
+    }
+
+    #endregion
+
+    #region Heap
+
+    private void Insert(TimerQueueTimer timer)
+    {
+        if (_count == _heap.Length)
+        {
+            var heap = new TimerQueueTimer[_heap.Length * 2];
+            Array.Copy(_heap, heap, _count);
+            _heap = heap;
+        }
+
+        _heap[_count] = timer;
+        timer.HeapIndex = _count;
+        _count++;
+        SiftUp(timer.HeapIndex);
+    }
+
+    private void RemoveAt(int index)
+    {
+        var timer = _heap[index];
+        timer.HeapIndex = -1;
+
+        _count--;
+        if (index != _count)
+        {
+            // move the last timer to the hole, it can go either way
+            var last = _heap[_count];
+            _heap[_count] = null;
+            _heap[index] = last;
+            SiftUp(index);
+            SiftDown(last.HeapIndex);
+        }
+        else
+        {
+            _heap[_count] = null;
+        }
+    }
+
+    private void SiftUp(int index)
+    {
+        var timer = _heap[index];
+        while (index > 0)
+        {
+            var parent = (index - 1) / 2;
+            if (_heap[parent].DueTime <= timer.DueTime)
+                break;
+
+            _heap[index] = _heap[parent];
+            _heap[index].HeapIndex = index;
+            index = parent;
+        }
+
+        _heap[index] = timer;
+        timer.HeapIndex = index;
+    }
+
+    private void SiftDown(int index)
+    {
+        var timer = _heap[index];
+        while (true)
+        {
+            var child = index * 2 + 1;
+            if (child >= _count)
+                break;
+
+            if (child + 1 < _count && _heap[child + 1].DueTime < _heap[child].DueTime)
+            {
+                child++;
+            }
+
+            if (timer.DueTime <= _heap[child].DueTime)
+                break;
+
+            _heap[index] = _heap[child];
+            _heap[index].HeapIndex = index;
+            index = child;
+        }
+
+        _heap[index] = timer;
+        timer.HeapIndex = index;
+    }
+
+    #endregion
+
+    #region Native
+
+    [MethodImpl(MethodImplOptions.InternalCall)]
+    private static extern ulong CreateNativeTimer(ulong waitable);
+
+    [MethodImpl(MethodImplOptions.InternalCall)]
+    private static extern void ChangeNativeTimer(ulong timer, long due);
+
+    [MethodImpl(MethodImplOptions.InternalCall)]
+    private static extern long GetMicrotime();
+
+    #endregion
+
+}
\ No newline at end of file
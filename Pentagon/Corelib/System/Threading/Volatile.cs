@@ -0,0 +1,76 @@
+using System.Runtime.CompilerServices;
+
+namespace System.Threading;
+
+/// <summary>
+/// Volatile accesses are emitted by the jit as calls to tiny natives that do a single load or
+/// store of the exact width, so the optimizer can't hoist or merge them. x86 doesn't reorder
+/// loads with loads or stores with stores, so these already have acquire and release semantics
+/// without any fence.
+/// </summary>
+public static class Volatile
+{
+
+    [MethodImpl(MethodImplOptions.InternalCall)]
+    private static extern T ReadValue<T>(ref T location);
+
+    [MethodImpl(MethodImplOptions.InternalCall)]
+    private static extern void WriteValue<T>(ref T location, T value);
+
+    #region Read
+
+    public static bool Read(ref bool location) => ReadValue(ref location);
+
+    public static byte Read(ref byte location) => ReadValue(ref location);
+
+    public static sbyte Read(ref sbyte location) => ReadValue(ref location);
+
+    public static short Read(ref short location) => ReadValue(ref location);
+
+    public static ushort Read(ref ushort location) => ReadValue(ref location);
+
+    public static int Read(ref int location) => ReadValue(ref location);
+
+    public static uint Read(ref uint location) => ReadValue(ref location);
+
+    public static long Read(ref long location) => ReadValue(ref location);
+
+    public static ulong Read(ref ulong location) => ReadValue(ref location);
+
+    public static IntPtr Read(ref IntPtr location) => ReadValue(ref location);
+
+    public static UIntPtr Read(ref UIntPtr location) => ReadValue(ref location);
+
+    public static T Read<T>(ref T location) where T : class => ReadValue(ref location);
+
+    #endregion
+
+    #region Write
+
+    public static void Write(ref bool location, bool value) => WriteValue(ref location, value);
+
+    public static void Write(ref byte location, byte value) => WriteValue(ref location, value);
+
+    public static void Write(ref sbyte location, sbyte value) => WriteValue(ref location, value);
+
+    public static void Write(ref short location, short value) => WriteValue(ref location, value);
+
+    public static void Write(ref ushort location, ushort value) => WriteValue(ref location, value);
+
+    public static void Write(ref int location, int value) => WriteValue(ref location, value);
+
+    public static void Write(ref uint location, uint value) => WriteValue(ref location, value);
+
+    public static void Write(ref long location, long value) => WriteValue(ref location, value);
+
+    public static void Write(ref ulong location, ulong value) => WriteValue(ref location, value);
+
+    public static void Write(ref IntPtr location, IntPtr value) => WriteValue(ref location, value);
+
+    public static void Write(ref UIntPtr location, UIntPtr value) => WriteValue(ref location, value);
+
+    public static void Write<T>(ref T location, T value) where T : class => WriteValue(ref location, value);
+
+    #endregion
+
+}
\ No newline at end of file
@@ -1,6 +1,6 @@
 namespace System;
 
-public readonly struct UInt64
+public readonly struct UInt64 : ISpanFormattable
 {
 #pragma warning disable 169
     private readonly ulong _value;
@@ -22,7 +22,17 @@ public readonly struct UInt64
 
     public override string ToString()
     {
-        return "";
+        return Number.UInt64ToString(_value, null);
+    }
+
+    public string ToString(string format)
+    {
+        return Number.UInt64ToString(_value, format);
+    }
+
+    public bool TryFormat(Span<char> destination, out int charsWritten, string format = null)
+    {
+        return Number.TryFormatUInt64(_value, format, destination, out charsWritten);
     }
     
 }
\ No newline at end of file
@@ -1,19 +1,62 @@
+using System.Runtime.CompilerServices;
+
 namespace System;
 
 public abstract class ValueType
 {
+
+    /// <summary>
+    /// Compares the boxed values field by field, the fields which are not references are
+    /// compared by their bits and the references are compared with their own Equals
+    /// </summary>
     public override bool Equals(object obj)
     {
-        return base.Equals(obj);
+        if (!ValueDataEquals(this, obj))
+            return false;
+
+        var count = GetReferenceCount(this);
+        for (var i = 0; i < count; i++)
+        {
+            if (!object.Equals(GetReference(this, i), GetReference(obj, i)))
+                return false;
+        }
+
+        return true;
     }
 
     public override int GetHashCode()
     {
-        return base.GetHashCode();
+        var hash = GetValueDataHashCode(this);
+        var count = GetReferenceCount(this);
+        for (var i = 0; i < count; i++)
+        {
+            hash = hash * 31 + (GetReference(this, i)?.GetHashCode() ?? 0);
+        }
+        return hash;
     }
 
     public override string ToString()
     {
         return base.ToString();
     }
+
+    /// <summary>
+    /// True if both are boxes of the same type and all the bytes
+    /// which are not references are the same
+    /// </summary>
+    [MethodImpl(MethodImplOptions.InternalCall)]
+    internal static extern bool ValueDataEquals(object a, object b);
+
+    /// <summary>
+    /// Hash all the bytes of the boxed value which are not references
+    /// </summary>
+    [MethodImpl(MethodImplOptions.InternalCall)]
+    internal static extern int GetValueDataHashCode(object obj);
+
+    [MethodImpl(MethodImplOptions.InternalCall)]
+    private static extern int GetReferenceCount(object obj);
+
+    [MethodImpl(MethodImplOptions.InternalCall)]
+    private static extern object GetReference(object obj, int index);
+
 }
\ No newline at end of file
@@ -5,46 +5,81 @@ using System.Runtime.InteropServices;
 namespace Pentagon.DriverServices.Acpi;
 
 /// <summary>
-/// ACPI management singleton
+/// ACPI management singleton, the tables are found and validated once by the kernel,
+/// and we share its index of them
 /// </summary>
 public class Acpi
 {
-    internal Region[] _pointers;
-        
+    /// <summary>
+    /// An entry of the kernel table index, must match acpi_table_entry_t
+    /// </summary>
+    [StructLayout(LayoutKind.Sequential)]
+    private struct TableEntry
+    {
+        public uint Signature;
+        public uint Instance;
+        public ulong Address;
+        public uint Length;
+        private uint _0;
+    }
+
+    private const int TableEntrySize = 24;
+
+    private readonly ulong _entries;
+    private readonly int _count;
+
+    // created on first use
+    private readonly Region[] _tables;
+
     public Acpi()
     {
-        var rsdtPhys = GetRsdt();
-        var region = new Region(MemoryServices.Map(rsdtPhys, 8192)); // TODO: allocate as much as Length wants
-        var rsdt = new Rsdt(region);
-        var count = (int)(rsdt.DHdr.Length.Value - 36) / 4;
-        var p = region.AsSpan<uint>(36, count);
-        _pointers = new Region[count];
-        for (int i = 0; i < count; i++)
-        {
-            var rgn = new Region(MemoryServices.Map(p[i], 8192));
-            _pointers[i] = rgn;
-        }
+        _entries = GetTables(out _count);
+        _tables = new Region[_count];
     }
 
-    public Region FindTable(uint signature)
+    /// <summary>
+    /// Find a table by its signature
+    /// </summary>
+    /// <param name="signature">The signature of the table</param>
+    /// <param name="instance">Which of the tables with this signature to get, for tables that may appear more than once</param>
+    /// <returns>The table, or null if there is no such table</returns>
+    public Region FindTable(uint signature, int instance = 0)
     {
-        for (int i = 0; i < _pointers.Length; i++)
+        for (var i = 0; i < _count; i++)
         {
-            var mem = _pointers[i];
-            var sig = MemoryMarshal.Cast<byte, uint>(mem.Span)[0];
-            if (sig == signature)
+            ref var entry = ref MemoryServices.UnsafePtrToRef<TableEntry>(_entries + (ulong)(i * TableEntrySize));
+            if (entry.Signature == signature && entry.Instance == instance)
             {
-                return mem;
+                return GetTable(i, ref entry);
             }
         }
+
         return null;
     }
 
+    private Region GetTable(int index, ref TableEntry entry)
+    {
+        var table = _tables[index];
+        if (table == null)
+        {
+            // the tables are already in the direct map as read-only, so use them
+            // as is and only expose the exact length of the table
+            var memory = Memory<byte>.Empty;
+            MemoryServices.UpdateMemory(ref memory, null, MemoryServices.PhysicalToVirtual(entry.Address), (int)entry.Length);
+            table = new Region(memory);
+
+            // if we race someone else they got the exact same view
+            _tables[index] = table;
+        }
+
+        return table;
+    }
+
 
     #region Native functions
         
     [MethodImpl(MethodImplOptions.InternalCall)]
-    public static extern ulong GetRsdt();
+    private static extern ulong GetTables(out int count);
         
     #endregion
 
@@ -0,0 +1,176 @@
+using System;
+using System.Buffers;
+using System.Threading;
+
+namespace Pentagon.DriverServices;
+
+/// <summary>
+/// A memory pool of page backed buffers for DMA. The pages come from AllocatePages, so they
+/// are never moved by the GC and their physical address can be given to a device with
+/// MemoryServices.GetPhysicalAddress. Freed pages are kept in power of two buckets (counted
+/// in pages), so steady state I/O keeps reusing the same pages.
+/// </summary>
+public sealed class DmaMemoryPool : MemoryPool<byte>
+{
+
+    // 1 page up to 16 pages
+    private const int BucketCount = 5;
+
+    private const int BuffersPerBucket = 16;
+
+    private sealed class Bucket
+    {
+
+        private readonly IMemoryOwner<byte>[] _pages = new IMemoryOwner<byte>[BuffersPerBucket];
+        private int _count;
+        private SpinLock _lock;
+
+        public bool TryPush(IMemoryOwner<byte> pages)
+        {
+            var lockTaken = false;
+            _lock.Enter(ref lockTaken);
+
+            var pushed = false;
+            if (_count < _pages.Length)
+            {
+                _pages[_count++] = pages;
+                pushed = true;
+            }
+
+            _lock.Exit();
+            return pushed;
+        }
+
+        public IMemoryOwner<byte> TryPop()
+        {
+            if (_count == 0)
+                return null;
+
+            var lockTaken = false;
+            _lock.Enter(ref lockTaken);
+
+            IMemoryOwner<byte> pages = null;
+            if (_count > 0)
+            {
+                pages = _pages[--_count];
+                _pages[_count] = null;
+            }
+
+            _lock.Exit();
+            return pages;
+        }
+
+    }
+
+    /// <summary>
+    /// A pool for drivers to share
+    /// </summary>
+    public static new DmaMemoryPool Shared { get; } = new();
+
+    private readonly Bucket[] _buckets = new Bucket[BucketCount];
+
+    public override int MaxBufferSize => int.MaxValue;
+
+    public DmaMemoryPool()
+    {
+        for (var i = 0; i < _buckets.Length; i++)
+        {
+            _buckets[i] = new Bucket();
+        }
+    }
+
+    private static int SelectBucketIndex(int pages)
+    {
+        var index = 0;
+        while ((1 << index) < pages && index < BucketCount)
+        {
+            index++;
+        }
+        return index;
+    }
+
+    public override IMemoryOwner<byte> Rent(int minBufferSize = -1)
+    {
+        if (minBufferSize == -1)
+        {
+            minBufferSize = MemoryServices.PageSize;
+        }
+        else if (minBufferSize < 0)
+        {
+            throw new ArgumentOutOfRangeException(nameof(minBufferSize));
+        }
+
+        var pageCount = (int)(KernelUtils.AlignUp((ulong)minBufferSize, (ulong)MemoryServices.PageSize) / (ulong)MemoryServices.PageSize);
+        if (pageCount == 0)
+        {
+            pageCount = 1;
+        }
+
+        var bucket = SelectBucketIndex(pageCount);
+        IMemoryOwner<byte> pages = null;
+        if (bucket < BucketCount)
+        {
+            pages = _buckets[bucket].TryPop();
+            pageCount = 1 << bucket;
+        }
+
+        return new DmaBuffer(this, pages ?? MemoryServices.AllocatePages(pageCount));
+    }
+
+    private void Return(IMemoryOwner<byte> pages)
+    {
+        var bucket = SelectBucketIndex(pages.Memory.Length / MemoryServices.PageSize);
+        if (bucket >= BucketCount || !_buckets[bucket].TryPush(pages))
+        {
+            pages.Dispose();
+        }
+    }
+
+    protected override void Dispose(bool disposing)
+    {
+        // free all the cached pages, buffers that are still rented
+        // will free their pages once they are returned
+        for (var i = 0; i < _buckets.Length; i++)
+        {
+            IMemoryOwner<byte> pages;
+            while ((pages = _buckets[i].TryPop()) != null)
+            {
+                pages.Dispose();
+            }
+        }
+    }
+
+    /// <summary>
+    /// A rented buffer, disposing it gives the pages back to the pool
+    /// </summary>
+    internal sealed class DmaBuffer : IMemoryOwner<byte>
+    {
+
+        private readonly DmaMemoryPool _pool;
+        private IMemoryOwner<byte> _pages;
+
+        /// <summary>
+        /// The pages that back the buffer, as returned by AllocatePages
+        /// </summary>
+        internal IMemoryOwner<byte> Pages => _pages ?? throw new ObjectDisposedException(nameof(DmaBuffer));
+
+        public Memory<byte> Memory => Pages.Memory;
+
+        public DmaBuffer(DmaMemoryPool pool, IMemoryOwner<byte> pages)
+        {
+            _pool = pool;
+            _pages = pages;
+        }
+
+        public void Dispose()
+        {
+            var pages = Interlocked.Exchange(ref _pages, null);
+            if (pages != null)
+            {
+                _pool.Return(pages);
+            }
+        }
+
+    }
+
+}
\ No newline at end of file
@@ -11,6 +11,11 @@ public class Field<T>
     private ulong _fieldPtr;
 
     public ref T Value => ref MemoryServices.UnsafePtrToRef<T>(_fieldPtr);
+
+    /// <summary>
+    /// The address of the field, for use with <see cref="Mmio"/>
+    /// </summary>
+    public ulong Address => _fieldPtr;
     
     internal Field(Region region, int offset)
     {
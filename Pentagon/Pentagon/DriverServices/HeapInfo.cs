@@ -0,0 +1,28 @@
+namespace Pentagon.DriverServices;
+
+/// <summary>
+/// A snapshot of the object heap, the layout matches the kernel so it can be
+/// filled directly by <see cref="HeapStats.GetHeapInfo"/>.
+/// </summary>
+public struct HeapInfo
+{
+
+    public ulong CommittedBytes;
+    public ulong UsedBytes;
+    public ulong LiveObjects;
+
+    // counters since boot
+    public ulong Allocations;
+    public ulong BumpAllocations;
+    public ulong ReclaimedBytes;
+
+    // collection times, in microseconds
+    public ulong CollectionCount;
+    public ulong LastPause;
+    public ulong MaxPause;
+    public ulong TotalPause;
+    public ulong LastMark;
+    public ulong LastSweep;
+    public ulong LastReclaim;
+
+}
@@ -0,0 +1,14 @@
+namespace Pentagon.DriverServices;
+
+/// <summary>
+/// The stats of a single object size pool of the heap
+/// </summary>
+public struct HeapPoolInfo
+{
+
+    public ulong ObjectSize;
+    public ulong LiveObjects;
+    public ulong FreeObjects;
+    public ulong CommittedBytes;
+
+}
@@ -0,0 +1,48 @@
+using System;
+using System.Runtime.CompilerServices;
+
+namespace Pentagon.DriverServices;
+
+/// <summary>
+/// Exposes the object heap and garbage collector stats, getting the stats
+/// walks the heap so it should not be done on a hot path.
+/// </summary>
+public static class HeapStats
+{
+
+    /// <summary>
+    /// The amount of object size pools, pool 0 has 16 byte objects and
+    /// every pool after it doubles the size
+    /// </summary>
+    public const int PoolCount = 26;
+
+    public static HeapInfo GetInfo()
+    {
+        var info = new HeapInfo();
+        GetHeapInfo(ref info);
+        return info;
+    }
+
+    public static HeapPoolInfo GetPoolInfo(int pool)
+    {
+        if ((uint)pool >= PoolCount)
+            throw new ArgumentOutOfRangeException(nameof(pool));
+
+        var info = new HeapPoolInfo();
+        GetPoolInfo(pool, ref info);
+        return info;
+    }
+
+    /// <summary>
+    /// Print a compact summary of the heap to the kernel log
+    /// </summary>
+    [MethodImpl(MethodImplOptions.InternalCall)]
+    public static extern void Dump();
+
+    [MethodImpl(MethodImplOptions.InternalCall)]
+    private static extern void GetHeapInfo(ref HeapInfo info);
+
+    [MethodImpl(MethodImplOptions.InternalCall)]
+    private static extern void GetPoolInfo(int pool, ref HeapPoolInfo info);
+
+}
@@ -1,4 +1,6 @@
-﻿using System.Runtime.CompilerServices;
+﻿using System;
+using System.Runtime.CompilerServices;
+using System.Threading;
 
 namespace Pentagon.DriverServices;
 
@@ -13,4 +15,203 @@ internal class Log
     [MethodImpl(MethodImplOptions.InternalCall)]
     public static extern void LogString(string s);
 
+    /// <summary>
+    /// Write the chars as a single line to the kernel trace, the same as TRACE
+    /// </summary>
+    [MethodImpl(MethodImplOptions.InternalCall)]
+    private static extern void LogChars(ref char chars, int length);
+
+    public static void Trace(string message)
+    {
+        Trace(message.AsSpan());
+    }
+
+    public static void Trace(Span<char> message)
+    {
+        // the native takes a reference to the first char, so
+        // use a dummy one for an empty message
+        var empty = '\0';
+        LogChars(ref message.IsEmpty ? ref empty : ref message[0], message.Length);
+    }
+
+    /// <summary>
+    /// Trace an interpolated string, the values are formatted into a reused buffer and
+    /// passed to the kernel as is, so tracing never allocates a managed string
+    /// </summary>
+    public static void Trace(ref TraceInterpolatedStringHandler handler)
+    {
+        Trace(handler.Written);
+        handler.Release();
+    }
+
+    [InterpolatedStringHandler]
+    public struct TraceInterpolatedStringHandler
+    {
+
+        private const int DefaultBufferSize = 256;
+
+        // a single buffer is kept around, if it is already taken
+        // by another thread we just allocate a new one
+        private static char[] _cachedBuffer;
+
+        private char[] _buffer;
+        private int _pos;
+
+        internal Span<char> Written => _buffer.AsSpan(0, _pos);
+
+        public TraceInterpolatedStringHandler(int literalLength, int formattedCount)
+        {
+            _buffer = Interlocked.Exchange(ref _cachedBuffer, null);
+            if (_buffer == null || _buffer.Length < literalLength)
+            {
+                _buffer = new char[Math.Max(DefaultBufferSize, literalLength)];
+            }
+            _pos = 0;
+        }
+
+        internal void Release()
+        {
+            if (_buffer.Length == DefaultBufferSize)
+            {
+                _cachedBuffer = _buffer;
+            }
+            _buffer = null;
+        }
+
+        private void Grow()
+        {
+            var buffer = new char[_buffer.Length * 2];
+            _buffer.AsSpan(0, _pos).CopyTo(buffer);
+            _buffer = buffer;
+        }
+
+        public void AppendLiteral(string value) => AppendFormatted(value.AsSpan());
+
+        public void AppendFormatted(string value) => AppendFormatted(value.AsSpan());
+
+        public void AppendFormatted(Span<char> value)
+        {
+            while (_buffer.Length - _pos < value.Length)
+            {
+                Grow();
+            }
+
+            value.CopyTo(_buffer.AsSpan(_pos));
+            _pos += value.Length;
+        }
+
+        public void AppendFormatted(char value)
+        {
+            if (_pos == _buffer.Length)
+            {
+                Grow();
+            }
+
+            _buffer[_pos++] = value;
+        }
+
+        public void AppendFormatted(bool value) => AppendFormatted(value ? bool.TrueString : bool.FalseString);
+
+        public void AppendFormatted(int value, string format = null)
+        {
+            int charsWritten;
+            while (!value.TryFormat(_buffer.AsSpan(_pos), out charsWritten, format))
+            {
+                Grow();
+            }
+            _pos += charsWritten;
+        }
+
+        public void AppendFormatted(uint value, string format = null)
+        {
+            int charsWritten;
+            while (!value.TryFormat(_buffer.AsSpan(_pos), out charsWritten, format))
+            {
+                Grow();
+            }
+            _pos += charsWritten;
+        }
+
+        public void AppendFormatted(long value, string format = null)
+        {
+            int charsWritten;
+            while (!value.TryFormat(_buffer.AsSpan(_pos), out charsWritten, format))
+            {
+                Grow();
+            }
+            _pos += charsWritten;
+        }
+
+        public void AppendFormatted(ulong value, string format = null)
+        {
+            int charsWritten;
+            while (!value.TryFormat(_buffer.AsSpan(_pos), out charsWritten, format))
+            {
+                Grow();
+            }
+            _pos += charsWritten;
+        }
+
+        public void AppendFormatted(byte value, string format = null)
+        {
+            int charsWritten;
+            while (!value.TryFormat(_buffer.AsSpan(_pos), out charsWritten, format))
+            {
+                Grow();
+            }
+            _pos += charsWritten;
+        }
+
+        public void AppendFormatted(sbyte value, string format = null)
+        {
+            int charsWritten;
+            while (!value.TryFormat(_buffer.AsSpan(_pos), out charsWritten, format))
+            {
+                Grow();
+            }
+            _pos += charsWritten;
+        }
+
+        public void AppendFormatted(short value, string format = null)
+        {
+            int charsWritten;
+            while (!value.TryFormat(_buffer.AsSpan(_pos), out charsWritten, format))
+            {
+                Grow();
+            }
+            _pos += charsWritten;
+        }
+
+        public void AppendFormatted(ushort value, string format = null)
+        {
+            int charsWritten;
+            while (!value.TryFormat(_buffer.AsSpan(_pos), out charsWritten, format))
+            {
+                Grow();
+            }
+            _pos += charsWritten;
+        }
+
+        /// <summary>
+        /// Anything that is not one of the primitives above, value types are boxed here
+        /// </summary>
+        public void AppendFormatted<T>(T value, string format = null)
+        {
+            if (value is ISpanFormattable formattable)
+            {
+                int charsWritten;
+                while (!formattable.TryFormat(_buffer.AsSpan(_pos), out charsWritten, format))
+                {
+                    Grow();
+                }
+                _pos += charsWritten;
+            }
+            else
+            {
+                AppendFormatted(value?.ToString());
+            }
+        }
+
+    }
+
 }
\ No newline at end of file
@@ -7,27 +7,27 @@ namespace Pentagon.DriverServices;
 public static class MemoryServices
 {
 
-    /// <summary>
-    /// The base of the kernel's direct map
-    /// </summary>
-    private const ulong DirectMapBase = 0xffff800000000000ul;
-    
     /// <summary>
     /// The size of a page
     /// </summary>
     public static readonly int PageSize = 4096;
 
     /// <summary>
-    /// Get the physical address of memory allocated by AllocatePages, if it was returned
-    /// from other methods this may result in InvalidCastException
+    /// Get the physical address of memory allocated by AllocatePages or rented from a
+    /// DmaMemoryPool, if it was returned from other methods this may result in InvalidCastException
     /// </summary>
     /// <param name="range">The range of memory to get the physical address for</param>
     /// <returns>The physical address</returns>
     public static ulong GetPhysicalAddress(IMemoryOwner<byte> range)
     {
+        if (range is DmaMemoryPool.DmaBuffer buffer)
+        {
+            range = buffer.Pages;
+        }
+
         // note: we don't need to have this as checked because the object can only be
         //       created by a safe function
-        return ((AllocatedMemoryHolder)range)._ptr - 0xffff800000000000ul;
+        return VirtualToPhysical(((AllocatedMemoryHolder)range)._ptr);
     }
 
     /// <summary>
@@ -65,12 +65,14 @@ public static class MemoryServices
     
     /// <summary>
     /// Map a range of memory, this can be unaligned both in pointer and size. It is completely
-    /// safe to call this multiple times on the same or overlapping ranges
+    /// safe to call this multiple times on the same or overlapping ranges, the memory type of
+    /// the last mapping is the one used for the whole pages it covers
     /// </summary>
     /// <param name="ptr">The physical address</param>
     /// <param name="size">The amount of memory to map</param>
+    /// <param name="type">The memory type, uncacheable by default since this is mostly used for device registers</param>
     /// <returns>The Memory object representing the mapped memory</returns>
-    internal static Memory<byte> Map(ulong ptr, int size)
+    internal static Memory<byte> Map(ulong ptr, int size, MemoryType type = MemoryType.Uncacheable)
     {
         if (size < 0)
             throw new ArgumentOutOfRangeException(nameof(size));
@@ -85,7 +87,7 @@ public static class MemoryServices
         // map, we are going to map the whole page range but only give a reference
         // to the range that we want from it 
         var memory = Memory<byte>.Empty;
-        var mapped = MapMemory(rangeStart, pageCount);
+        var mapped = MapMemory(rangeStart, pageCount, (int)type);
         UpdateMemory(ref memory, null, mapped + offset, size);
         return memory;
     }
@@ -133,6 +135,18 @@ public static class MemoryServices
     
     [MethodImpl(MethodImplOptions.InternalCall)]
     internal static extern ref T UnsafePtrToRef<T>(ulong ptr);
+
+    /// <summary>
+    /// Translate a physical address to its direct map address, does not check the address
+    /// </summary>
+    [MethodImpl(MethodImplOptions.InternalCall)]
+    internal static extern ulong PhysicalToVirtual(ulong phys);
+
+    /// <summary>
+    /// Translate a direct map address to its physical address, does not check the address
+    /// </summary>
+    [MethodImpl(MethodImplOptions.InternalCall)]
+    internal static extern ulong VirtualToPhysical(ulong virt);
     
     [MethodImpl(MethodImplOptions.InternalCall)]
     private static extern ulong AllocateMemory(ulong size);
@@ -141,7 +155,7 @@ public static class MemoryServices
     private static extern void FreeMemory(ulong ptr);
     
     [MethodImpl(MethodImplOptions.InternalCall)]
-    private static extern ulong MapMemory(ulong ptr, ulong pages);
+    private static extern ulong MapMemory(ulong ptr, ulong pages, int memoryType);
     
     #endregion
 
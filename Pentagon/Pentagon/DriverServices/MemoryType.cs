@@ -0,0 +1,34 @@
+namespace Pentagon.DriverServices;
+
+/// <summary>
+/// The caching of a mapping, the values match the memory types of the kernel
+/// </summary>
+public enum MemoryType
+{
+    /// <summary>
+    /// Normal memory
+    /// </summary>
+    WriteBack = 0,
+
+    /// <summary>
+    /// Reads are cached, writes go straight to memory
+    /// </summary>
+    WriteThrough = 1,
+
+    /// <summary>
+    /// Uncacheable, but can be overridden to write-combining by the MTRRs
+    /// </summary>
+    UncacheableMinus = 2,
+
+    /// <summary>
+    /// Every access goes to the device in program order, with no speculative reads,
+    /// this is what device registers need
+    /// </summary>
+    Uncacheable = 3,
+
+    /// <summary>
+    /// Uncached, but writes are combined in a buffer and sent as bursts, good for
+    /// buffers which are written in bulk (like a framebuffer), but not for registers
+    /// </summary>
+    WriteCombining = 4,
+}
\ No newline at end of file
@@ -0,0 +1,49 @@
+using System.Runtime.CompilerServices;
+
+namespace Pentagon.DriverServices;
+
+/// <summary>
+/// Raw access to memory mapped device registers. These are intrinsics, the jit emits
+/// each of them as a call to a native doing a single volatile access of the exact width,
+/// so every call results in exactly one access to the device, in program order.
+/// </summary>
+public static class Mmio
+{
+
+    [MethodImpl(MethodImplOptions.InternalCall)]
+    public static extern byte Read8(ulong address);
+
+    [MethodImpl(MethodImplOptions.InternalCall)]
+    public static extern ushort Read16(ulong address);
+
+    [MethodImpl(MethodImplOptions.InternalCall)]
+    public static extern uint Read32(ulong address);
+
+    [MethodImpl(MethodImplOptions.InternalCall)]
+    public static extern ulong Read64(ulong address);
+
+    [MethodImpl(MethodImplOptions.InternalCall)]
+    public static extern void Write8(ulong address, byte value);
+
+    [MethodImpl(MethodImplOptions.InternalCall)]
+    public static extern void Write16(ulong address, ushort value);
+
+    [MethodImpl(MethodImplOptions.InternalCall)]
+    public static extern void Write32(ulong address, uint value);
+
+    [MethodImpl(MethodImplOptions.InternalCall)]
+    public static extern void Write64(ulong address, ulong value);
+
+    /// <summary>
+    /// A single access of the width of T, which must be an integer type, used by <see cref="MmioRegister{T}"/>
+    /// </summary>
+    [MethodImpl(MethodImplOptions.InternalCall)]
+    internal static extern T Read<T>(ulong address)
+        where T : unmanaged;
+
+    /// <inheritdoc cref="Read{T}"/>
+    [MethodImpl(MethodImplOptions.InternalCall)]
+    internal static extern void Write<T>(ulong address, T value)
+        where T : unmanaged;
+
+}
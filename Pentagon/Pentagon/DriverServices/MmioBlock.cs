@@ -0,0 +1,82 @@
+using System;
+using System.Runtime.CompilerServices;
+
+namespace Pentagon.DriverServices;
+
+/// <summary>
+/// A block of device registers, registers are created at constant offsets from
+/// the base of the block.
+/// </summary>
+/// <remarks>
+/// A register map is written as a struct holding the block with a property for each
+/// register, following the [StructLayout] of the device structure. The map checks the
+/// size of the block once when it is created, and then each register is just an add:
+/// <code>
+/// public MmioRegister&lt;uint&gt; DeviceFeature => _block.RegisterUnchecked&lt;uint&gt;(4);
+/// </code>
+/// Nothing is allocated, neither for the block nor for the registers.
+/// </remarks>
+public readonly struct MmioBlock
+{
+
+    private readonly ulong _base;
+    private readonly int _length;
+
+    public int Length => _length;
+
+    /// <summary>
+    /// False for a default constructed block, which has no registers at all
+    /// </summary>
+    public bool IsBound => _base != 0;
+
+    internal MmioBlock(Memory<byte> memory)
+    {
+        var span = memory.Span;
+        _base = MemoryServices.GetSpanPtr(ref span);
+        _length = memory.Length;
+    }
+
+    private MmioBlock(ulong @base, int length)
+    {
+        _base = @base;
+        _length = length;
+    }
+
+    public MmioRegister<T> Register<T>(int offset)
+        where T : unmanaged
+    {
+        if ((uint)offset > (uint)_length || (uint)(_length - offset) < (uint)Unsafe.SizeOf<T>())
+            throw new ArgumentOutOfRangeException(nameof(offset));
+
+        return new MmioRegister<T>(_base + (ulong)offset);
+    }
+
+    /// <summary>
+    /// Create a register without checking the range, the caller must have
+    /// already checked that the block is large enough. An unbound block is
+    /// still rejected, so a default constructed register map can't end up
+    /// accessing the low physical addresses.
+    /// </summary>
+    internal MmioRegister<T> RegisterUnchecked<T>(int offset)
+        where T : unmanaged
+    {
+        if (_base == 0)
+            throw new InvalidOperationException();
+
+        return new MmioRegister<T>(_base + (ulong)offset);
+    }
+
+    public MmioBlock Slice(int offset, int length)
+    {
+        if ((uint)offset > (uint)_length || (uint)length > (uint)(_length - offset))
+            throw new ArgumentOutOfRangeException();
+
+        return new MmioBlock(_base + (ulong)offset, length);
+    }
+
+    public MmioBlock Slice(int offset)
+    {
+        return Slice(offset, _length - offset);
+    }
+
+}
@@ -0,0 +1,39 @@
+namespace Pentagon.DriverServices;
+
+/// <summary>
+/// A single device register, this is only an address so it can be stored
+/// and passed around freely without allocating anything.
+/// </summary>
+/// <remarks>
+/// Every <see cref="Read"/> and <see cref="Write"/> goes through <see cref="Mmio"/>, so each
+/// one is a single access of the width of T in program order, the jit never merges them or
+/// moves them out of a loop. T must be an integer type, for a read-modify-write of a flags
+/// register wrap the register in a property of the enum type.
+/// </remarks>
+public readonly struct MmioRegister<T>
+    where T : unmanaged
+{
+
+    private readonly ulong _address;
+
+    /// <summary>
+    /// The address of the register, for use with <see cref="Mmio"/>
+    /// </summary>
+    public ulong Address => _address;
+
+    internal MmioRegister(ulong address)
+    {
+        _address = address;
+    }
+
+    public T Read()
+    {
+        return Mmio.Read<T>(_address);
+    }
+
+    public void Write(T value)
+    {
+        Mmio.Write(_address, value);
+    }
+
+}
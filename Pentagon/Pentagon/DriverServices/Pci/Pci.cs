@@ -1,6 +1,5 @@
 using System;
 using System.Runtime.InteropServices;
-using Pentagon.Resources;
 
 namespace Pentagon.DriverServices.Pci;
 
@@ -9,78 +8,153 @@ namespace Pentagon.DriverServices.Pci;
 /// </summary>
 public static class Pci
 {
+
     /// <summary>
-    /// Get the slice of the whole ECAM for the single Bus:Device:Function.
-    /// This ensures that the memory slice stored in PciDevice can never access memory 
-    /// the caller doesn't have permission to access
+    /// The ECAM of a single MCFG allocation, the buses are only mapped once the
+    /// scan reaches them, so we never map the ECAM of buses that don't exist
     /// </summary>
-    private static Memory<byte> GetConfigSpaceForDevice(Memory<byte> ecam, byte startBus, byte bus, byte dev, byte fn)
+    private sealed class EcamSegment
     {
-        return ecam.Slice(((bus - startBus) << 20) + (dev << 15) + (fn << 12), 4096);
+
+        public readonly ushort Segment;
+        public readonly byte StartBus;
+        public readonly byte EndBus;
+
+        // the base address is of bus 0, even if the allocation starts at a later bus
+        private readonly ulong _base;
+        private readonly Memory<byte>[] _buses;
+        private readonly bool[] _scanned;
+
+        public EcamSegment(Acpi.Acpi.Mcfg.McfgAllocation allocation)
+        {
+            Segment = allocation.Segment;
+            StartBus = allocation.StartBus;
+            EndBus = allocation.EndBus;
+            _base = allocation.Base;
+
+            // NOTE: McfgAllocation.EndBus is inclusive
+            _buses = new Memory<byte>[EndBus - StartBus + 1];
+            _scanned = new bool[EndBus - StartBus + 1];
+        }
+
+        /// <summary>
+        /// Mark the bus as scanned, fails if the bus is outside of the segment
+        /// or was already scanned (a misconfigured bridge could make a loop)
+        /// </summary>
+        public bool TryBeginScan(byte bus)
+        {
+            if (bus < StartBus || bus > EndBus || _scanned[bus - StartBus])
+                return false;
+
+            _scanned[bus - StartBus] = true;
+            return true;
+        }
+
+        /// <summary>
+        /// Get the slice of the ECAM for the single Bus:Device:Function.
+        /// This ensures that the memory slice stored in PciDevice can never access memory
+        /// the caller doesn't have permission to access
+        /// </summary>
+        public Memory<byte> GetConfigSpace(byte bus, byte device, byte function)
+        {
+            ref var ecam = ref _buses[bus - StartBus];
+            if (ecam.IsEmpty)
+            {
+                ecam = MemoryServices.Map(_base + ((ulong)bus << 20), 1 << 20, MemoryType.Uncacheable);
+            }
+
+            return ecam.Slice((device << 15) + (function << 12), 4096);
+        }
+
     }
 
+    private static EcamSegment[] _segments;
+
     /// <summary>
-    /// Register all PCI devices in the system
-    /// TODO: log some stuff nicely :)
+    /// Register all PCI devices in the system, the buses are found by following the bridges
+    /// from the root bus of every segment, so only buses that exist are ever read.
+    /// This only runs once at boot, hot-plug is not supported yet.
     /// </summary>
     internal static void Scan(Acpi.Acpi acpi)
     {
-        var mcfg = acpi.FindTable(Acpi.Acpi.Mcfg.Signature);
-        var allocs = mcfg.AsSpan<Acpi.Acpi.Mcfg.McfgAllocation>(44, 1);
-
-        // TODO: this ought to be the StartBus and EndBus values from allocs
-        // but if the number of buses is near 256, it doesn't work on my (StaticSaga)'s machine
-        // but I am not sure if the code is at fault
-        byte startBus = 0;
-        byte endBus = 1;
-        
-        // NOTE: McfgAllocation.EndBus is inclusive
-        var phys = allocs[0].Base;
-        var length = (endBus + 1 - startBus) << 20;
-        var ecam = MemoryServices.Map(phys,  length);
-
-        // iterate all the busses
-        // TODO: convert to non-brute-force
-        for (var bus = startBus; bus <= endBus; bus++)
+        var mcfg = new Acpi.Acpi.Mcfg(acpi.FindTable(Acpi.Acpi.Mcfg.Signature));
+        var allocs = mcfg.Allocs.Span;
+
+        _segments = new EcamSegment[allocs.Length];
+        for (var i = 0; i < allocs.Length; i++)
+        {
+            _segments[i] = new EcamSegment(allocs[i]);
+            ScanSegment(_segments[i]);
+        }
+    }
+
+    private static void ScanSegment(EcamSegment segment)
+    {
+        var root = segment.StartBus;
+
+        // a multi-function host bridge means there are multiple host
+        // bridges, each function is the host bridge of the bus with its number
+        var config = segment.GetConfigSpace(root, 0, 0).Span;
+        if (MemoryMarshal.Read<ushort>(config) != 0xFFFF && (config[0x0E] & 0x80) != 0)
         {
-            // Iterate the devices on this bus 
-            for (var device = (byte)0; device < 32; device++)
+            for (byte function = 0; function < 8; function++)
             {
-                // get the slice and check if this is a valid pci device
-                var ecamSlice = GetConfigSpaceForDevice(ecam, startBus, bus, device, 0);
-                var vendorId = MemoryMarshal.Read<ushort>(ecamSlice.Span);
-                if (vendorId == 0xFFFF)
+                config = segment.GetConfigSpace(root, 0, function).Span;
+                if (MemoryMarshal.Read<ushort>(config) == 0xFFFF)
                     continue;
 
-                // the device is valid, create it 
-                var pciDev = new PciDevice(bus, device, 0, ecamSlice);
+                ScanBus(segment, (byte)(root + function));
+            }
+        }
+        else
+        {
+            ScanBus(segment, root);
+        }
+    }
+
+    private static void ScanBus(EcamSegment segment, byte bus)
+    {
+        if (!segment.TryBeginScan(bus))
+            return;
 
-                // the device is valid, add it for drivers to see
-                ResourceManager<PciDevice>.Add(pciDev);
+        for (byte device = 0; device < 32; device++)
+        {
+            if (!ScanFunction(segment, bus, device, 0, out var headerType))
+                continue;
 
-                // Skip functions if there are no functions for the device
-                if ((pciDev.ConfigHeader.HeaderType & 0x80) == 0) 
-                    continue;
+            // Skip functions if there are no functions for the device
+            if ((headerType & 0x80) == 0)
+                continue;
 
-                // iterate the functions on this device
-                for (byte func = 1; func < 8; func++)
-                {
-                    // Same as the main device
-                    ecamSlice = GetConfigSpaceForDevice(ecam, startBus, bus, device, func);
-                    vendorId = MemoryMarshal.Read<ushort>(ecamSlice.Span);
-                    if (vendorId == 0xFFFF)
-                        continue;
-
-                    // valid, create it 
-                    pciDev = new PciDevice(bus, device, func, ecamSlice);
-
-                    // and register...
-                    ResourceManager<PciDevice>.Add(pciDev);
-                }
+            for (byte function = 1; function < 8; function++)
+            {
+                ScanFunction(segment, bus, device, function, out _);
             }
         }
     }
 
+    private static bool ScanFunction(EcamSegment segment, byte bus, byte device, byte function, out byte headerType)
+    {
+        var configSpace = segment.GetConfigSpace(bus, device, function);
+        var config = configSpace.Span;
+        if (MemoryMarshal.Read<ushort>(config) == 0xFFFF)
+        {
+            headerType = 0;
+            return false;
+        }
+
+        headerType = config[0x0E];
+        PciDeviceTable.Add(segment.Segment, bus, device, function, configSpace);
+
+        // a pci-to-pci bridge, continue to the bus behind it
+        if ((headerType & 0x7F) == 0x01)
+        {
+            ScanBus(segment, config[0x19]);
+        }
+
+        return true;
+    }
+
 }
 
 /// <summary>
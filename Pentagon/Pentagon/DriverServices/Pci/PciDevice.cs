@@ -12,6 +12,7 @@ public sealed class PciDevice
 {
 
     /// Add PCI address of the device
+    public readonly ushort Segment;
     public readonly byte Bus;
     public readonly byte Device;
     public readonly byte Function;
@@ -27,15 +28,17 @@ public sealed class PciDevice
     public readonly Region ConfigSpace;
 
     /// <summary>
-    /// The config space of the device
+    /// The config space of the device, accesses through it are plain memory accesses
+    /// which the jit may merge, use <see cref="Mmio"/> for registers that change under
+    /// the device
     /// </summary>
-    public ref PciConfigHeader ConfigHeader => ref _configHeader.Value;
-    private readonly Field<PciConfigHeader> _configHeader;
+    public ref PciConfigHeader ConfigHeader => ref MemoryServices.UnsafePtrToRef<PciConfigHeader>(_configHeader.Address);
+    private readonly MmioRegister<PciConfigHeader> _configHeader;
 
     /// <summary>
     /// Points to the first capability 
     /// </summary>
-    internal readonly Field<byte> CapabilitiesPointer;
+    internal readonly MmioRegister<byte> CapabilitiesPointer;
 
     /// <summary>
     /// The amount of bars this device has 
@@ -48,20 +51,27 @@ public sealed class PciDevice
     public Msix Msix { get; private set; }
 
     public PciDevice(byte bus, byte dev, byte fn, Memory<byte> ecamSlice)
+        : this(0, bus, dev, fn, ecamSlice)
     {
+    }
+
+    public PciDevice(ushort segment, byte bus, byte dev, byte fn, Memory<byte> ecamSlice)
+    {
+        Segment = segment;
         Bus = bus;
         Device = dev;
         Function = fn;
         ConfigSpace = new Region(ecamSlice);
         
-        _configHeader = ConfigSpace.CreateField<PciConfigHeader>(0);
+        var configBlock = ConfigSpace.AsMmioBlock();
+        _configHeader = configBlock.Register<PciConfigHeader>(0);
         
-        IsValid = _configHeader.Value.VendorId != 0xFFFF;
+        IsValid = Mmio.Read16(_configHeader.Address) != 0xFFFF;
         
         if (!IsValid)
             return;
         
-        CapabilitiesPointer = ConfigSpace.CreateField<byte>(0x34);
+        CapabilitiesPointer = configBlock.Register<byte>(0x34);
 
         VendorId = ConfigHeader.VendorId;
         DeviceId = ConfigHeader.DeviceId;
@@ -99,7 +109,14 @@ public sealed class PciDevice
 
     #region Bar mapping
 
-    public Memory<byte> MapBar(int index)
+    /// <summary>
+    /// Map a memory bar, the bar is mapped as uncacheable unless write combining is asked for,
+    /// which is only allowed on prefetchable bars. Even then it is up to the driver, since some
+    /// devices (like virtio) put their registers in prefetchable bars.
+    /// </summary>
+    /// <param name="index">The index of the bar</param>
+    /// <param name="writeCombining">Map the bar as write-combining, for buffers written in bulk</param>
+    public Memory<byte> MapBar(int index, bool writeCombining = false)
     {
         if (index >= _barCount)
             throw new ArgumentOutOfRangeException(nameof(index));
@@ -114,8 +131,12 @@ public sealed class PciDevice
             return null;
         }
 
-        // TODO: map prefetchable nicely
-        
+        // reads of a prefetchable bar have no side effects, so it is
+        // safe to let the cpu combine and reorder accesses to it
+        var prefetchable = (barLow & 0b1000) != 0;
+        if (writeCombining && !prefetchable)
+            throw new InvalidOperationException("Only prefetchable bars can be mapped as write-combining");
+
         // get the addr and size of the bar 
         var type = (barLow >> 1) & 0b11;
         ulong addr = 0;
@@ -146,7 +167,7 @@ public sealed class PciDevice
         }
         
         // TODO: checked cast to int 
-        return MemoryServices.Map(addr, (int)size);
+        return MemoryServices.Map(addr, (int)size, writeCombining ? MemoryType.WriteCombining : MemoryType.Uncacheable);
     }
 
     #endregion
@@ -156,7 +177,7 @@ public sealed class PciDevice
     //
     // Utility functions to read from the config space
     // of pci devices, for optimized code its better to use
-    // the Field<T> mechanism 
+    // the MmioRegister<T> mechanism 
     // 
 
     public byte Read8(int offset)
@@ -227,7 +248,7 @@ public sealed class PciDevice
             if (Current.IsEmpty)
             {
                 // initialize from the base
-                Current = _device.ConfigSpace.CreateMemory<PciCapability>(_device.CapabilitiesPointer.Value, 1);
+                Current = _device.ConfigSpace.CreateMemory<PciCapability>(_device.CapabilitiesPointer.Read(), 1);
             }
             else
             {
@@ -0,0 +1,323 @@
+using System;
+using System.Collections.Generic;
+using System.Threading;
+
+namespace Pentagon.DriverServices.Pci;
+
+/// <summary>
+/// The pci functions of the system. They are kept in a single array of entries, and the
+/// entries are chained by vendor and by class the same way the Dictionary chains its
+/// buckets. Matching a driver only walks the functions of its vendor, and the PciDevice
+/// objects are only created once someone asks for the function.
+/// </summary>
+public static class PciDeviceTable
+{
+
+    private struct Entry
+    {
+        public uint Address;
+        public ushort VendorId;
+        public ushort DeviceId;
+        public byte ClassCode;
+        public byte Subclass;
+        public bool Claimed;
+
+        // the next entry with the same vendor/class, -1 at the end of the chain
+        public int NextByVendor;
+        public int NextByClass;
+
+        public Memory<byte> ConfigSpace;
+
+        // created on first use
+        public PciDevice Device;
+    }
+
+    private static readonly object s_lock = new();
+
+    // entries are only ever added, so an index stays valid forever
+    private static Entry[] s_entries = new Entry[64];
+    private static int s_count;
+
+    private static readonly Dictionary<uint, int> s_byAddress = new();
+    private static readonly Dictionary<ushort, int> s_byVendor = new();
+    private static readonly Dictionary<ushort, int> s_byClass = new();
+
+    private static readonly Dictionary<ushort, List<Predicate<PciDevice>>> s_drivers = new();
+
+    /// <summary>
+    /// The amount of functions found
+    /// </summary>
+    public static int Count => s_count;
+
+    private static uint GetAddress(ushort segment, byte bus, byte device, byte function)
+    {
+        return ((uint)segment << 16) | ((uint)bus << 8) | ((uint)device << 3) | function;
+    }
+
+    private static ushort GetClassKey(byte classCode, byte subclass)
+    {
+        return (ushort)((classCode << 8) | subclass);
+    }
+
+    private static PciDevice GetDevice(int index)
+    {
+        lock (s_lock)
+        {
+            ref var entry = ref s_entries[index];
+            if (entry.Device == null)
+            {
+                var address = entry.Address;
+                entry.Device = new PciDevice((ushort)(address >> 16), (byte)(address >> 8), (byte)((address >> 3) & 0x1F), (byte)(address & 0x7), entry.ConfigSpace);
+            }
+            return entry.Device;
+        }
+    }
+
+    #region Lookup
+
+    /// <summary>
+    /// Find the function at the given address
+    /// </summary>
+    /// <returns>null if there is no such function</returns>
+    public static PciDevice Find(ushort segment, byte bus, byte device, byte function)
+    {
+        int index;
+        lock (s_lock)
+        {
+            if (!s_byAddress.TryGetValue(GetAddress(segment, bus, device, function), out index))
+                return null;
+        }
+
+        return GetDevice(index);
+    }
+
+    /// <summary>
+    /// All the functions of the given vendor
+    /// </summary>
+    public static Enumerator FindByVendor(ushort vendorId)
+    {
+        lock (s_lock)
+        {
+            return new Enumerator(s_byVendor.TryGetValue(vendorId, out var first) ? first : -1, false);
+        }
+    }
+
+    /// <summary>
+    /// All the functions of the given class and subclass
+    /// </summary>
+    public static Enumerator FindByClass(byte classCode, byte subclass)
+    {
+        lock (s_lock)
+        {
+            return new Enumerator(s_byClass.TryGetValue(GetClassKey(classCode, subclass), out var first) ? first : -1, true);
+        }
+    }
+
+    /// <summary>
+    /// Walks a single chain of the table, can be used directly with foreach
+    /// </summary>
+    public struct Enumerator
+    {
+
+        private readonly bool _byClass;
+        private int _next;
+        private int _current;
+
+        internal Enumerator(int first, bool byClass)
+        {
+            _byClass = byClass;
+            _next = first;
+            _current = -1;
+        }
+
+        public PciDevice Current => GetDevice(_current);
+
+        public Enumerator GetEnumerator() => this;
+
+        public bool MoveNext()
+        {
+            if (_next < 0)
+                return false;
+
+            _current = _next;
+
+            // entries never move between chains, so the link can be read without the lock
+            ref var entry = ref s_entries[_current];
+            _next = _byClass ? entry.NextByClass : entry.NextByVendor;
+            return true;
+        }
+
+    }
+
+    #endregion
+
+    #region Drivers
+
+    /// <summary>
+    /// Register a driver for the functions of a vendor. The probe is called for every function
+    /// of the vendor that no driver took yet, and later for every function of the vendor that the
+    /// scan adds after this. The probes of the existing functions run in parallel on the thread pool, and
+    /// this only returns once all of them are done. When called from a worker of the thread pool
+    /// the probes run inline instead, waiting on the pool from inside of it could wait forever.
+    /// </summary>
+    /// <param name="vendorId">The vendor the driver handles</param>
+    /// <param name="probe">Returns true if the driver took the device</param>
+    public static void RegisterDriver(ushort vendorId, Predicate<PciDevice> probe)
+    {
+        if (probe == null)
+            throw new ArgumentNullException(nameof(probe));
+
+        var pending = new List<int>();
+        lock (s_lock)
+        {
+            if (!s_drivers.TryGetValue(vendorId, out var drivers))
+            {
+                drivers = new List<Predicate<PciDevice>>();
+                s_drivers.Add(vendorId, drivers);
+            }
+            drivers.Add(probe);
+
+            if (s_byVendor.TryGetValue(vendorId, out var index))
+            {
+                for (; index >= 0; index = s_entries[index].NextByVendor)
+                {
+                    if (!s_entries[index].Claimed)
+                    {
+                        pending.Add(index);
+                    }
+                }
+            }
+        }
+
+        if (pending.Count == 0)
+            return;
+
+        if (Thread.CurrentThread?.IsThreadPoolThread == true)
+        {
+            foreach (var index in pending)
+            {
+                TryProbe(index, probe);
+            }
+            return;
+        }
+
+        // the functions are independent, so probe them all at once
+        var remaining = pending.Count;
+        var done = new ManualResetEvent(false);
+        foreach (var index in pending)
+        {
+            var entryIndex = index;
+            ThreadPool.QueueUserWorkItem(_ =>
+            {
+                try
+                {
+                    TryProbe(entryIndex, probe);
+                }
+                finally
+                {
+                    if (Interlocked.Decrement(ref remaining) == 0)
+                    {
+                        done.Set();
+                    }
+                }
+            });
+        }
+
+        done.WaitOne();
+    }
+
+    /// <summary>
+    /// The function is reserved before the probe runs, so two drivers never probe the
+    /// same function at once, and released again if the driver didn't take it
+    /// </summary>
+    private static bool TryProbe(int index, Predicate<PciDevice> probe)
+    {
+        lock (s_lock)
+        {
+            if (s_entries[index].Claimed)
+                return false;
+
+            s_entries[index].Claimed = true;
+        }
+
+        var claimed = false;
+        try
+        {
+            claimed = probe(GetDevice(index));
+        }
+        finally
+        {
+            if (!claimed)
+            {
+                lock (s_lock)
+                {
+                    s_entries[index].Claimed = false;
+                }
+            }
+        }
+
+        return claimed;
+    }
+
+    #endregion
+
+    /// <summary>
+    /// Add a function found by the scan, if the function was already added this does nothing.
+    /// Functions that are added after their drivers were registered are probed right away.
+    /// </summary>
+    /// <returns>true if this is a new function</returns>
+    internal static bool Add(ushort segment, byte bus, byte device, byte function, Memory<byte> configSpace)
+    {
+        var address = GetAddress(segment, bus, device, function);
+        var config = configSpace.Span;
+
+        List<Predicate<PciDevice>> drivers;
+        int index;
+        lock (s_lock)
+        {
+            if (s_byAddress.ContainsKey(address))
+                return false;
+
+            if (s_count == s_entries.Length)
+            {
+                Array.Resize(ref s_entries, s_entries.Length * 2);
+            }
+
+            index = s_count;
+            ref var entry = ref s_entries[index];
+            entry.Address = address;
+            entry.VendorId = (ushort)(config[0x00] | (config[0x01] << 8));
+            entry.DeviceId = (ushort)(config[0x02] | (config[0x03] << 8));
+            entry.Subclass = config[0x0A];
+            entry.ClassCode = config[0x0B];
+            entry.ConfigSpace = configSpace;
+
+            // push to the head of the chains
+            entry.NextByVendor = s_byVendor.TryGetValue(entry.VendorId, out var nextByVendor) ? nextByVendor : -1;
+            s_byVendor[entry.VendorId] = index;
+
+            var classKey = GetClassKey(entry.ClassCode, entry.Subclass);
+            entry.NextByClass = s_byClass.TryGetValue(classKey, out var nextByClass) ? nextByClass : -1;
+            s_byClass[classKey] = index;
+
+            s_byAddress.Add(address, index);
+            s_count++;
+
+            s_drivers.TryGetValue(entry.VendorId, out drivers);
+        }
+
+        // a function found after its drivers were registered, only the
+        // drivers of its vendor are asked about it
+        if (drivers != null)
+        {
+            for (var i = 0; i < drivers.Count; i++)
+            {
+                if (TryProbe(index, drivers[i]))
+                    break;
+            }
+        }
+
+        return true;
+    }
+
+}
\ No newline at end of file
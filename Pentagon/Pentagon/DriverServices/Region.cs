@@ -23,6 +23,11 @@ public class Region
         return new Field<T>(this, offset);
     }
 
+    public MmioBlock AsMmioBlock()
+    {
+        return new MmioBlock(_memory);
+    }
+
     public Memory<T> CreateMemory<T>(int offset, int count)
         where T : unmanaged
     {
@@ -1,7 +1,6 @@
 using System;
 using Pentagon.DriverServices;
 using Pentagon.DriverServices.Pci;
-using Pentagon.Resources;
 using System.Runtime.InteropServices;
 using System.Buffers;
 
@@ -29,7 +28,7 @@ public class VirtioDevice
     /// </summary>
     internal static void Register()
     {
-        ResourceManager<PciDevice>.Register(CheckDevice);
+        PciDeviceTable.RegisterDriver(0x1AF4, CheckDevice);
     }
 }
 
@@ -64,10 +63,10 @@ public class VirtioPciDevice
         ushort AddedHeads;
 
         internal ulong DescPhys, AvailPhys, UsedPhys;
-        Field<ushort> Notifier;
+        MmioRegister<ushort> Notifier;
         readonly public Irq Interrupt;
 
-        public QueueInfo(int index, int size, Field<ushort> notifier, Irq interrupt)
+        public QueueInfo(int index, int size, MmioRegister<ushort> notifier, Irq interrupt)
         {
             Index = index;
             Size = size;
@@ -136,7 +135,7 @@ public class VirtioPciDevice
         {
             Avail.DescIdx.Value += AddedHeads;
             AddedHeads = 0;
-            Notifier.Value = (ushort)Index;
+            Notifier.Write((ushort)Index);
         }
 
         /// <summary>
@@ -224,47 +223,73 @@ public class VirtioPciDevice
         }
     }
 
-    public class VirtioPciCommonCfg
+    /// <summary>
+    /// The common configuration structure, registers are at constant
+    /// offsets from the start of the capability
+    /// </summary>
+    public readonly struct VirtioPciCommonCfg
     {
+        // The offsets follow the layout of virtio_pci_common_cfg, every field is
+        // naturally aligned so each one starts right after the previous one
+        private const int DeviceFeatureSelectOffset = 0;
+        private const int DeviceFeatureOffset = DeviceFeatureSelectOffset + sizeof(uint);
+        private const int DriverFeatureSelectOffset = DeviceFeatureOffset + sizeof(uint);
+        private const int DriverFeatureOffset = DriverFeatureSelectOffset + sizeof(uint);
+        private const int MsixConfigOffset = DriverFeatureOffset + sizeof(uint);
+        private const int NumQueuesOffset = MsixConfigOffset + sizeof(ushort);
+        private const int DeviceStatusOffset = NumQueuesOffset + sizeof(ushort);
+        private const int ConfigGenerationOffset = DeviceStatusOffset + sizeof(byte); // DevStatus
+        private const int QueueSelectOffset = ConfigGenerationOffset + sizeof(byte);
+        private const int QueueSizeOffset = QueueSelectOffset + sizeof(ushort);
+        private const int QueueMsixVectorOffset = QueueSizeOffset + sizeof(ushort);
+        private const int QueueEnableOffset = QueueMsixVectorOffset + sizeof(ushort);
+        private const int QueueNotifyOffOffset = QueueEnableOffset + sizeof(ushort);
+        private const int QueueDescOffset = QueueNotifyOffOffset + sizeof(ushort);
+        private const int QueueDriverOffset = QueueDescOffset + sizeof(ulong);
+        private const int QueueDeviceOffset = QueueDriverOffset + sizeof(ulong);
+
+        /// <summary>
+        /// The size of the structure, up to and including QueueDevice
+        /// </summary>
+        private const int Size = QueueDeviceOffset + sizeof(ulong);
+
+        private readonly MmioBlock _block;
+
+        /// <summary>
+        /// False when the device had no common configuration capability
+        /// </summary>
+        public bool IsBound => _block.IsBound;
+
         // Whole device: can be set regardless of the current queue
-        public Field<uint> DeviceFeatureSelect;
-        public Field<uint> DeviceFeature;
-        public Field<uint> DriverFeatureSelect;
-        public Field<uint> DriverFeature;
-        public Field<ushort> MsixConfig;
-        public Field<ushort> NumQueues;
-        public Field<DevStatus> DeviceStatus;
-        public Field<byte> ConfigGeneration;
+        public MmioRegister<uint> DeviceFeatureSelect => _block.RegisterUnchecked<uint>(DeviceFeatureSelectOffset);
+        public MmioRegister<uint> DeviceFeature => _block.RegisterUnchecked<uint>(DeviceFeatureOffset);
+        public MmioRegister<uint> DriverFeatureSelect => _block.RegisterUnchecked<uint>(DriverFeatureSelectOffset);
+        public MmioRegister<uint> DriverFeature => _block.RegisterUnchecked<uint>(DriverFeatureOffset);
+        public MmioRegister<ushort> MsixConfig => _block.RegisterUnchecked<ushort>(MsixConfigOffset);
+        public MmioRegister<ushort> NumQueues => _block.RegisterUnchecked<ushort>(NumQueuesOffset);
+        public DevStatus DeviceStatus
+        {
+            get => (DevStatus)_block.RegisterUnchecked<byte>(DeviceStatusOffset).Read();
+            set => _block.RegisterUnchecked<byte>(DeviceStatusOffset).Write((byte)value);
+        }
+        public MmioRegister<byte> ConfigGeneration => _block.RegisterUnchecked<byte>(ConfigGenerationOffset);
 
         // Queue-specific: put a queue number in QueueSelect to get that queue's regs
-        public Field<ushort> QueueSelect;
-        public Field<ushort> QueueSize;
-        public Field<ushort> QueueMsixVector;
-        public Field<ushort> QueueEnable;
-        public Field<ushort> QueueNotifyOff;
-        public Field<ulong> QueueDesc;
-        public Field<ulong> QueueDriver;
-        public Field<ulong> QueueDevice;
-
-        public VirtioPciCommonCfg(Region r)
+        public MmioRegister<ushort> QueueSelect => _block.RegisterUnchecked<ushort>(QueueSelectOffset);
+        public MmioRegister<ushort> QueueSize => _block.RegisterUnchecked<ushort>(QueueSizeOffset);
+        public MmioRegister<ushort> QueueMsixVector => _block.RegisterUnchecked<ushort>(QueueMsixVectorOffset);
+        public MmioRegister<ushort> QueueEnable => _block.RegisterUnchecked<ushort>(QueueEnableOffset);
+        public MmioRegister<ushort> QueueNotifyOff => _block.RegisterUnchecked<ushort>(QueueNotifyOffOffset);
+        public MmioRegister<ulong> QueueDesc => _block.RegisterUnchecked<ulong>(QueueDescOffset);
+        public MmioRegister<ulong> QueueDriver => _block.RegisterUnchecked<ulong>(QueueDriverOffset);
+        public MmioRegister<ulong> QueueDevice => _block.RegisterUnchecked<ulong>(QueueDeviceOffset);
+
+        public VirtioPciCommonCfg(MmioBlock block)
         {
-            DeviceFeatureSelect = r.CreateField<uint>(0);
-            DeviceFeature = r.CreateField<uint>(4);
-            DriverFeatureSelect = r.CreateField<uint>(8);
-            DriverFeature = r.CreateField<uint>(12);
-            MsixConfig = r.CreateField<ushort>(16);
-            NumQueues = r.CreateField<ushort>(18);
-            DeviceStatus = r.CreateField<DevStatus>(20);
-            ConfigGeneration = r.CreateField<byte>(21);
-
-            QueueSelect = r.CreateField<ushort>(22);
-            QueueSize = r.CreateField<ushort>(24);
-            QueueMsixVector = r.CreateField<ushort>(26);
-            QueueEnable = r.CreateField<ushort>(28);
-            QueueNotifyOff = r.CreateField<ushort>(30);
-            QueueDesc = r.CreateField<ulong>(32);
-            QueueDriver = r.CreateField<ulong>(40);
-            QueueDevice = r.CreateField<ulong>(48);
+            if (!block.IsBound || block.Length < Size)
+                throw new ArgumentOutOfRangeException(nameof(block));
+
+            _block = block;
         }
 
         public enum DevStatus : byte
@@ -279,7 +304,7 @@ public class VirtioPciDevice
     protected PciDevice _pci;
     protected VirtioPciCommonCfg _common;
     protected QueueInfo _queueInfo;
-    protected Region _notify;
+    protected MmioBlock _notify;
     readonly private uint _notifyMultiplier;
 
     [StructLayout(LayoutKind.Sequential)]
@@ -325,54 +350,57 @@ public class VirtioPciDevice
 
                 if (type == Capability.CfgType.CommonCfg)
                 {
-                    _common = new VirtioPciCommonCfg(slice);
+                    _common = new VirtioPciCommonCfg(slice.AsMmioBlock());
                 }
                 else if (type == Capability.CfgType.NotifyCfg)
                 {
-                    _notify = slice;
+                    _notify = slice.AsMmioBlock();
                     _notifyMultiplier = virtioCap.NotifyOffMultiplier;
                 }
             }
         }
 
-        _common.DeviceStatus.Value = 0; // reset, not sure if needed
-        _common.DeviceStatus.Value |= VirtioPciCommonCfg.DevStatus.Acknowledge; // it exists
-        _common.DeviceStatus.Value |= VirtioPciCommonCfg.DevStatus.Driver; // it can be loaded
+        if (!_common.IsBound)
+            throw new InvalidOperationException("virtio device has no common configuration");
+
+        _common.DeviceStatus = 0; // reset, not sure if needed
+        _common.DeviceStatus |= VirtioPciCommonCfg.DevStatus.Acknowledge; // it exists
+        _common.DeviceStatus |= VirtioPciCommonCfg.DevStatus.Driver; // it can be loaded
 
         ulong requiredFeatures = (1ul << 32); // VIRTIO_F_VERSION_1
         ulong optionalFeatures = 0;
         for (int i = 0; i < 2; i++)
         {
-            _common.DeviceFeatureSelect.Value = (uint)i;
-            _common.DeviceFeature.Value = (uint)((requiredFeatures >> (i * 32)) | (optionalFeatures >> (i * 32)));
-            _common.DriverFeatureSelect.Value = (uint)i;
+            _common.DeviceFeatureSelect.Write((uint)i);
+            _common.DeviceFeature.Write((uint)((requiredFeatures >> (i * 32)) | (optionalFeatures >> (i * 32))));
+            _common.DriverFeatureSelect.Write((uint)i);
             // TODO: check that the two are compatible
         }
 
         // features acknowledged
-        _common.DeviceStatus.Value |= VirtioPciCommonCfg.DevStatus.FeaturesOk;
+        _common.DeviceStatus |= VirtioPciCommonCfg.DevStatus.FeaturesOk;
         
         _pci.Msix.Configure(1);
         for (int q = 0; q < 1; q++)
         {
-            _common.QueueSelect.Value = (ushort)q;
-            int size = _common.QueueSize.Value;
+            _common.QueueSelect.Write((ushort)q);
+            int size = _common.QueueSize.Read();
             // if the size is zero, the queue has to be ignored
             if (size == 0) continue;
             // TODO: support packed virtqueues instead
             var msixIdx = q;
 
-            _queueInfo = new(q, size, _notify.CreateField<ushort>(q * (int)_notifyMultiplier), _pci.Msix[msixIdx]);
-            _common.QueueDesc.Value = _queueInfo.DescPhys;
-            _common.QueueDriver.Value = _queueInfo.AvailPhys;
-            _common.QueueDevice.Value = _queueInfo.UsedPhys;
-            _common.QueueMsixVector.Value = (ushort)msixIdx;
+            _queueInfo = new(q, size, _notify.Register<ushort>(q * (int)_notifyMultiplier), _pci.Msix[msixIdx]);
+            _common.QueueDesc.Write(_queueInfo.DescPhys);
+            _common.QueueDriver.Write(_queueInfo.AvailPhys);
+            _common.QueueDevice.Write(_queueInfo.UsedPhys);
+            _common.QueueMsixVector.Write((ushort)msixIdx);
 
             // and finally, enable the queue
-            _common.QueueEnable.Value = 1;
+            _common.QueueEnable.Write(1);
         }
 
         // ready to work
-        _common.DeviceStatus.Value |= VirtioPciCommonCfg.DevStatus.DriverOk;
+        _common.DeviceStatus |= VirtioPciCommonCfg.DevStatus.DriverOk;
     }
 }
\ No newline at end of file
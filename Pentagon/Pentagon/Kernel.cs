@@ -3,6 +3,7 @@ using Pentagon.Drivers.Virtio;
 using Pentagon.DriverServices;
 using Pentagon.DriverServices.Acpi;
 using Pentagon.DriverServices.Pci;
+using Pentagon.Tests;
 
 namespace Pentagon;
 
@@ -10,6 +11,11 @@ public class Kernel
 {
     public static int Main()
     {
+#if DEBUG
+        // quick sanity checks of the runtime, these throw on failure
+        EqualityComparerTests.Run();
+#endif
+
         // setup the basic subsystems
         var acpi = new Acpi();
         Pci.Scan(acpi);
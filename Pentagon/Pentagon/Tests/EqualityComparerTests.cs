@@ -0,0 +1,105 @@
+using System;
+using System.Collections.Generic;
+using Pentagon.DriverServices;
+
+namespace Pentagon.Tests;
+
+/// <summary>
+/// Checks that the default equality comparer treats value keys by their value, boxed enums
+/// and structs used to only compare equal to themselves so they could never be found again
+/// </summary>
+internal static class EqualityComparerTests
+{
+
+    private enum Color
+    {
+        Red,
+        Green,
+        Blue,
+    }
+
+    /// <summary>
+    /// Only has the ValueType Equals and GetHashCode
+    /// </summary>
+    private struct Point
+    {
+        public int X;
+        public int Y;
+
+        public Point(int x, int y)
+        {
+            X = x;
+            Y = y;
+        }
+    }
+
+    /// <summary>
+    /// Has a reference, which must be compared with its own Equals
+    /// </summary>
+    private struct NamedKey
+    {
+        public string Name;
+        public int Id;
+
+        public NamedKey(string name, int id)
+        {
+            Name = name;
+            Id = id;
+        }
+    }
+
+    /// <summary>
+    /// Implements IEquatable, which the comparer should prefer
+    /// </summary>
+    private struct EquatableKey : IEquatable<EquatableKey>
+    {
+        public int Value;
+
+        public EquatableKey(int value)
+        {
+            Value = value;
+        }
+
+        // only the low byte counts, so this is distinguishable from the bitwise equality
+        public bool Equals(EquatableKey other) => (Value & 0xFF) == (other.Value & 0xFF);
+        public override bool Equals(object obj) => obj is EquatableKey other && Equals(other);
+        public override int GetHashCode() => Value & 0xFF;
+    }
+
+    private static void Check(bool condition, string what)
+    {
+        if (!condition)
+            throw new InvalidOperationException(what);
+    }
+
+    public static void Run()
+    {
+        var colors = new Dictionary<Color, int>();
+        colors.Add(Color.Red, 1);
+        colors.Add(Color.Blue, 3);
+        Check(colors.TryGetValue(Color.Blue, out var blue) && blue == 3, "enum key lookup");
+        Check(!colors.ContainsKey(Color.Green), "missing enum key");
+        Check(Color.Red.Equals(Color.Red) && !Color.Red.Equals(Color.Blue), "boxed enum equals");
+        Check(Color.Green.GetHashCode() == Color.Green.GetHashCode(), "boxed enum hash");
+
+        var points = new Dictionary<Point, int>();
+        points.Add(new Point(1, 2), 12);
+        Check(points.TryGetValue(new Point(1, 2), out var point) && point == 12, "struct key lookup");
+        Check(!points.ContainsKey(new Point(2, 1)), "missing struct key");
+        Check(new Point(3, 4).GetHashCode() == new Point(3, 4).GetHashCode(), "struct hash");
+
+        // two different string instances with the same chars
+        var names = new HashSet<NamedKey>();
+        names.Add(new NamedKey(new string(new[] { 'a', 'b' }), 1));
+        Check(names.Contains(new NamedKey(new string(new[] { 'a', 'b' }), 1)), "struct key with a reference");
+        Check(!names.Contains(new NamedKey(new string(new[] { 'a', 'b' }), 2)), "struct key with a different field");
+        Check(!names.Contains(new NamedKey(null, 1)), "struct key with a null reference");
+
+        var equatable = new HashSet<EquatableKey>();
+        equatable.Add(new EquatableKey(0x101));
+        Check(equatable.Contains(new EquatableKey(0x201)), "IEquatable key");
+
+        Log.Trace("EqualityComparer tests passed");
+    }
+
+}
\ No newline at end of file
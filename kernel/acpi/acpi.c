@@ -3,35 +3,149 @@
 #include "kernel.h"
 
 #include "acpi10.h"
+#include "acpi20.h"
 #include "mem/mem.h"
+#include "util/stb_ds.h"
+#include "util/string.h"
+#include "util/trace.h"
 
-struct acpi_descriptor_header* m_rsdt = NULL;
+/**
+ * The index of all the tables, built once on init
+ */
+static acpi_table_entry_t* m_acpi_tables = NULL;
+
+static bool acpi_checksum(const void* ptr, size_t length) {
+    const uint8_t* bytes = ptr;
+    uint8_t sum = 0;
+    for (size_t i = 0; i < length; i++) {
+        sum += bytes[i];
+    }
+    return sum == 0;
+}
+
+/**
+ * Validate the table and add it to the index, a table that fails validation is
+ * ignored instead of failing the boot since there is not much we can do about it
+ */
+static void acpi_add_table(uint64_t address) {
+    if (address == 0) {
+        return;
+    }
+
+    acpi_descriptor_header_t* table = PHYS_TO_DIRECT(address);
+    if (table->length < sizeof(acpi_descriptor_header_t)) {
+        WARN("acpi: table %.4s at %p has an invalid length %d, ignoring",
+             (char*)&table->signature, address, table->length);
+        return;
+    }
+
+    if (!acpi_checksum(table, table->length)) {
+        WARN("acpi: table %.4s at %p has an invalid checksum, ignoring",
+             (char*)&table->signature, address);
+        return;
+    }
+
+    uint32_t instance = 0;
+    for (int i = 0; i < arrlen(m_acpi_tables); i++) {
+        if (m_acpi_tables[i].signature == table->signature) {
+            instance++;
+        }
+    }
+
+    acpi_table_entry_t entry = {
+        .signature = table->signature,
+        .instance = instance,
+        .address = address,
+        .length = table->length,
+    };
+    arrpush(m_acpi_tables, entry);
+
+    TRACE("\t%.4s #%d: %p (%d bytes)", (char*)&table->signature, instance, address, table->length);
+}
 
 err_t init_acpi() {
     err_t err = NO_ERROR;
 
-    // validate the structure
-    // TODO: checksum
-    acpi_1_0_rsdp_t* rsdp = (acpi_1_0_rsdp_t*)g_limine_rsdp.response->address;
+    // validate the structure, the first 20 bytes are the 1.0 rsdp and have
+    // their own checksum, the rest is covered by the extended checksum
+    acpi_2_0_rsdp_t* rsdp = (acpi_2_0_rsdp_t*)g_limine_rsdp.response->address;
     CHECK(rsdp->signature == ACPI_1_0_RSDP_SIGNATURE);
+    CHECK(acpi_checksum(rsdp, sizeof(acpi_1_0_rsdp_t)), "Invalid RSDP checksum");
 
-    // get and validate the rsdt
-    m_rsdt = PHYS_TO_DIRECT(rsdp->rsdt_address);
-    CHECK(m_rsdt->signature == ACPI_1_0_RSDT_SIGNATURE);
-    CHECK(m_rsdt->revision >= ACPI_1_0_RSDT_REVISION);
+    // prefer the xsdt, it is the only one that can point to tables above 4GB
+    acpi_descriptor_header_t* xsdt = NULL;
+    if (rsdp->revision >= ACPI_2_0_RSDP_REVISION && rsdp->xsdt_address != 0) {
+        if (!acpi_checksum(rsdp, rsdp->length)) {
+            WARN("acpi: invalid extended RSDP checksum, falling back to the RSDT");
+        } else {
+            xsdt = PHYS_TO_DIRECT(rsdp->xsdt_address);
+            if (
+                xsdt->signature != ACPI_2_0_XSDT_SIGNATURE ||
+                xsdt->length < sizeof(acpi_descriptor_header_t) ||
+                !acpi_checksum(xsdt, xsdt->length)
+            ) {
+                WARN("acpi: invalid XSDT, falling back to the RSDT");
+                xsdt = NULL;
+            }
+        }
+    }
+
+    TRACE("ACPI Tables:");
+    if (xsdt != NULL) {
+        // the entries are not aligned to 8 bytes
+        size_t entry_count = (xsdt->length - sizeof(acpi_descriptor_header_t)) / sizeof(uint64_t);
+        uint8_t* entries = (uint8_t*)(xsdt + 1);
+        for (int i = 0; i < entry_count; i++) {
+            uint64_t address;
+            memcpy(&address, entries + i * sizeof(uint64_t), sizeof(address));
+            acpi_add_table(address);
+        }
+    } else {
+        // get and validate the rsdt
+        acpi_descriptor_header_t* rsdt = PHYS_TO_DIRECT(rsdp->rsdt_address);
+        CHECK(rsdt->signature == ACPI_1_0_RSDT_SIGNATURE);
+        CHECK(rsdt->revision >= ACPI_1_0_RSDT_REVISION);
+        CHECK(rsdt->length >= sizeof(acpi_descriptor_header_t));
+        CHECK(acpi_checksum(rsdt, rsdt->length), "Invalid RSDT checksum");
+
+        size_t entry_count = (rsdt->length - sizeof(acpi_descriptor_header_t)) / sizeof(uint32_t);
+        uint32_t* entries = (uint32_t*)(rsdt + 1);
+        for (int i = 0; i < entry_count; i++) {
+            acpi_add_table(entries[i]);
+        }
+    }
+
+    // the dsdt is only pointed to from the fadt, add it so it can be found like the rest
+    acpi_1_0_fadt_t* fadt = acpi_get_table(EFI_ACPI_1_0_FADT_SIGNATURE);
+    if (fadt != NULL) {
+        uint64_t dsdt = fadt->dsdt;
+        if (fadt->header.length >= offsetof(acpi_2_0_fadt_t, x_dsdt) + sizeof(uint64_t)) {
+            acpi_2_0_fadt_t* fadt2 = (acpi_2_0_fadt_t*)fadt;
+            if (fadt2->x_dsdt != 0) {
+                dsdt = fadt2->x_dsdt;
+            }
+        }
+        acpi_add_table(dsdt);
+    }
 
 cleanup:
     return err;
 }
 
-void* acpi_get_table(uint32_t signature) {
-    size_t entry_count = (m_rsdt->length - sizeof(acpi_descriptor_header_t)) / sizeof(uint32_t);
-    uint32_t* entries = (uint32_t*)(m_rsdt + 1);
-    for (int i = 0; i < entry_count; i++) {
-        acpi_descriptor_header_t* table = PHYS_TO_DIRECT(entries[i]);
-        if (table->signature == signature) {
-            return table;
+void* acpi_get_table_instance(uint32_t signature, uint32_t instance) {
+    for (int i = 0; i < arrlen(m_acpi_tables); i++) {
+        if (m_acpi_tables[i].signature == signature && m_acpi_tables[i].instance == instance) {
+            return PHYS_TO_DIRECT(m_acpi_tables[i].address);
         }
     }
     return NULL;
 }
+
+void* acpi_get_table(uint32_t signature) {
+    return acpi_get_table_instance(signature, 0);
+}
+
+const acpi_table_entry_t* acpi_get_tables(size_t* count) {
+    *count = arrlen(m_acpi_tables);
+    return m_acpi_tables;
+}
\ No newline at end of file
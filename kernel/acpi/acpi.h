@@ -3,10 +3,25 @@
 #include "util/except.h"
 
 /**
- * Pointer to the RSDT, for use in C#
+ * An entry in the table index, the index is built once on init and is
+ * never modified after, so it can be shared with C# as is
  */
-extern struct acpi_descriptor_header* m_rsdt;
+typedef struct acpi_table_entry {
+    // the signature of the table
+    uint32_t signature;
 
+    // the tables with the same signature are numbered in the order
+    // they appear in the root table, starting from zero
+    uint32_t instance;
+
+    // the physical address of the table
+    uint64_t address;
+
+    // the full length of the table, including the header
+    uint32_t length;
+    uint32_t _reserved;
+} acpi_table_entry_t;
+STATIC_ASSERT(sizeof(acpi_table_entry_t) == 24);
 
 /**
  * Fetches all the tables that we need from ACPI for the kernel itself
@@ -19,8 +34,23 @@ extern struct acpi_descriptor_header* m_rsdt;
 err_t init_acpi();
 
 /**
- * Get a certain acpi table
+ * Get the first acpi table with the given signature
  *
  * @param signature [IN] The signature of the table
  */
-void* acpi_get_table(uint32_t signature);
\ No newline at end of file
+void* acpi_get_table(uint32_t signature);
+
+/**
+ * Get a certain instance of an acpi table, for tables that may appear more than once
+ *
+ * @param signature [IN] The signature of the table
+ * @param instance  [IN] Which of the tables with this signature to get, starting from zero
+ */
+void* acpi_get_table_instance(uint32_t signature, uint32_t instance);
+
+/**
+ * Get the whole table index, for use in C#
+ *
+ * @param count [OUT] The amount of entries in the index
+ */
+const acpi_table_entry_t* acpi_get_tables(size_t* count);
\ No newline at end of file
@@ -0,0 +1,35 @@
+#pragma once
+
+#include "acpi10.h"
+
+#define ACPI_2_0_RSDP_REVISION  0x02
+
+typedef struct acpi_2_0_rsdp {
+    uint64_t signature;
+    uint8_t checksum;
+    uint8_t oem_id[6];
+    uint8_t revision;
+    uint32_t rsdt_address;
+    uint32_t length;
+    uint64_t xsdt_address;
+    uint8_t extended_checksum;
+    uint8_t _reserved[3];
+} PACKED acpi_2_0_rsdp_t;
+
+#define ACPI_2_0_XSDT_SIGNATURE  SIGNATURE_32('X', 'S', 'D', 'T')
+#define ACPI_2_0_XSDT_REVISION  0x01
+
+#define ACPI_1_0_DSDT_SIGNATURE  SIGNATURE_32('D', 'S', 'D', 'T')
+
+/**
+ * The only part of the 2.0 FADT we care about, the 64bit DSDT pointer that
+ * comes after the 1.0 FADT
+ */
+typedef struct acpi_2_0_fadt {
+    acpi_1_0_fadt_t fadt;
+    uint8_t reset_reg[12];
+    uint8_t reset_value;
+    uint8_t _reserved1[3];
+    uint64_t x_firmware_ctrl;
+    uint64_t x_dsdt;
+} PACKED acpi_2_0_fadt_t;
@@ -190,7 +190,7 @@ err_t init_apic() {
         // not mapped, this is BSP
         m_mapped_lapic = true;
         CHECK_AND_RETHROW(vmm_map(DIRECT_TO_PHYS(m_local_apic_base), (void*)m_local_apic_base, 1,
-                                  MAP_WRITE));
+                                  MAP_WRITE | MAP_CACHE_UC));
     }
 
     // enable lapic by configuring the svr
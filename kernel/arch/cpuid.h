@@ -6,6 +6,10 @@
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
+#define CPUID_EXTENDED_FUNCTION 0x80000000
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
 #define CPUID_EXTENDED_CPU_SIG 0x80000001
 
 typedef union cpuid_extended_cpu_sig_edx {
@@ -25,6 +29,19 @@ typedef union cpuid_extended_cpu_sig_edx {
 } PACKED cpuid_extended_cpu_sig_edx_t;
 STATIC_ASSERT(sizeof(cpuid_extended_cpu_sig_edx_t) == sizeof(uint32_t));
 
+typedef union cpuid_extended_cpu_sig_ecx {
+    struct {
+        uint32_t LAHF_SAHF : 1;
+        uint32_t _reserved : 4;
+        uint32_t LZCNT : 1;
+        uint32_t _reserved1 : 2;
+        uint32_t PREFETCHW : 1;
+        uint32_t _reserved2 : 23;
+    };
+    uint32_t packed;
+} PACKED cpuid_extended_cpu_sig_ecx_t;
+STATIC_ASSERT(sizeof(cpuid_extended_cpu_sig_ecx_t) == sizeof(uint32_t));
+
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
 #define CPUID_EXTENDED_TIME_STAMP_COUNTER  0x80000007
@@ -148,6 +165,40 @@ STATIC_ASSERT(sizeof(cpuid_version_info_edx_t) == sizeof(uint32_t));
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
+#define CPUID_STRUCTURED_EXTENDED_FEATURE_FLAGS 0x07
+
+typedef union cpuid_structured_extended_feature_flags_ebx {
+    struct {
+        uint32_t FSGSBASE : 1;
+        uint32_t TSC_ADJUST : 1;
+        uint32_t SGX : 1;
+        uint32_t BMI1 : 1;
+        uint32_t HLE : 1;
+        uint32_t AVX2 : 1;
+        uint32_t FDP_EXCPTN_ONLY : 1;
+        uint32_t SMEP : 1;
+        uint32_t BMI2 : 1;
+        uint32_t ERMS : 1;
+        uint32_t INVPCID : 1;
+        uint32_t RTM : 1;
+        uint32_t _reserved : 20;
+    };
+    uint32_t packed;
+} PACKED cpuid_structured_extended_feature_flags_ebx_t;
+STATIC_ASSERT(sizeof(cpuid_structured_extended_feature_flags_ebx_t) == sizeof(uint32_t));
+
+typedef union cpuid_structured_extended_feature_flags_edx {
+    struct {
+        uint32_t _reserved : 4;
+        uint32_t FSRM : 1;
+        uint32_t _reserved1 : 27;
+    };
+    uint32_t packed;
+} PACKED cpuid_structured_extended_feature_flags_edx_t;
+STATIC_ASSERT(sizeof(cpuid_structured_extended_feature_flags_edx_t) == sizeof(uint32_t));
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
 #include "intrin.h"
 
 static inline void cpuid(uint32_t info_type, uint32_t* eax, uint32_t* ebx, uint32_t* ecx, uint32_t* edx) {
@@ -158,3 +209,12 @@ static inline void cpuid(uint32_t info_type, uint32_t* eax, uint32_t* ebx, uint3
     if (ecx) *ecx = regs[2];
     if (edx) *edx = regs[3];
 }
+
+static inline void cpuidex(uint32_t info_type, uint32_t sub_leaf, uint32_t* eax, uint32_t* ebx, uint32_t* ecx, uint32_t* edx) {
+    int regs[4];
+    __cpuidex(regs, info_type, sub_leaf);
+    if (eax) *eax = regs[0];
+    if (ebx) *ebx = regs[1];
+    if (ecx) *ecx = regs[2];
+    if (edx) *edx = regs[3];
+}
@@ -760,6 +760,11 @@ void common_interrupt_handler(interrupt_context_t* ctx) {
             lapic_eoi();
         } break;
 
+        case IRQ_TLB_SHOOTDOWN: {
+            vmm_on_tlb_shootdown();
+            lapic_eoi();
+        } break;
+
         case IRQ_ALLOC_BASE ... IRQ_ALLOC_END: {
             irq_dispatch(ctx);
             lapic_eoi();
@@ -870,7 +875,7 @@ void init_idt() {
     set_idt_entry(0x2e, interrupt_handle_0x2e, 0);
     set_idt_entry(0x2f, interrupt_handle_0x2f, 0);
     set_idt_entry(IRQ_WAKEUP, interrupt_handle_0x30, 0);
-    set_idt_entry(0x31, interrupt_handle_0x31, 0);
+    set_idt_entry(IRQ_TLB_SHOOTDOWN, interrupt_handle_0x31, 0);
     set_idt_entry(0x32, interrupt_handle_0x32, 0);
     set_idt_entry(0x33, interrupt_handle_0x33, 0);
     set_idt_entry(0x34, interrupt_handle_0x34, 0);
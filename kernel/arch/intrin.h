@@ -109,6 +109,10 @@ static inline INTRIN_ATTR void __cpuid(int CPUInfo[], const int InfoType) {
     __asm__ __volatile__("cpuid" : "=a"(CPUInfo[0]), "=b"(CPUInfo[1]), "=c"(CPUInfo[2]), "=d"(CPUInfo[3]) : "a"(InfoType));
 }
 
+static inline INTRIN_ATTR void __cpuidex(int CPUInfo[], const int InfoType, const int ECXValue) {
+    __asm__ __volatile__("cpuid" : "=a"(CPUInfo[0]), "=b"(CPUInfo[1]), "=c"(CPUInfo[2]), "=d"(CPUInfo[3]) : "a"(InfoType), "c"(ECXValue));
+}
+
 static  inline INTRIN_ATTR void __halt(void) {
     __asm__ ("hlt");
 }
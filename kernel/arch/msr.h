@@ -22,6 +22,14 @@ STATIC_ASSERT(sizeof(msr_efer_t) == sizeof(uint64_t));
 
 #define MSR_IA32_PAT  0x00000277
 
+// the memory types that can be set in a PAT entry
+#define PAT_UC          0
+#define PAT_WC          1
+#define PAT_WT          4
+#define PAT_WP          5
+#define PAT_WB          6
+#define PAT_UC_MINUS    7
+
 typedef union msr_pat {
     struct {
         uint64_t pa0 : 3;
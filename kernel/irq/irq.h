@@ -32,6 +32,11 @@ typedef enum irq {
      */
     IRQ_WAKEUP      = 0x30,
 
+    /**
+     * Flush the whole TLB of the core, sent by vmm_tlb_shootdown
+     */
+    IRQ_TLB_SHOOTDOWN = 0x31,
+
     // TODO: we need some space for legacy PIC irqs
     //       mostly for stuff like PS2
 
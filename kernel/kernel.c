@@ -19,6 +19,8 @@
 #include <util/string.h>
 #include <util/defs.h>
 
+#include <mem/code_heap.h>
+#include <mem/stack.h>
 #include <mem/malloc.h>
 #include <mem/mem.h>
 #include <mem/vmm.h>
@@ -101,9 +103,16 @@ static void enable_cpu_features() {
 }
 
 /**
- * How many cpus have started
+ * How many of the other cpus are done with their own init, the bsp
+ * waits on this before it lets anyone start scheduling
  */
-static _Atomic(int) m_startup_count = 0;
+static _Atomic(int) m_cpus_ready = 0;
+
+/**
+ * How many cpus are about to leave the bootloader supplied stack,
+ * the bootloader memory can't be reclaimed before all of them did
+ */
+static _Atomic(int) m_cpus_left_boot_stack = 0;
 
 /**
  * Set to true if we got an error on smp setup
@@ -121,10 +130,17 @@ int get_cpu_count() {
     return m_cpu_count;
 }
 
+static void wait_for_cpus(_Atomic(int)* counter, int count) {
+    while (atomic_load_explicit(counter, memory_order_acquire) != count) {
+        __builtin_ia32_pause();
+    }
+}
+
 static void per_cpu_start(struct limine_smp_info* info) {
     err_t err = NO_ERROR;
 
-    // just like the bsp setup all the cpu stuff
+    // just like the bsp setup all the cpu stuff, this runs in
+    // parallel to the rest of the kernel init on the bsp
     enable_cpu_features();
     init_gdt();
     init_idt();
@@ -143,21 +159,21 @@ cleanup:
     if (IS_ERROR(err)) {
         // set that we got an error
         atomic_store(&m_smp_error, true);
-        TRACE("\tError on CPU #%d");
+        TRACE("\tError on CPU #%d", info->lapic_id);
     }
 
     // we done with this CPU
-    atomic_fetch_add(&m_startup_count, 1);
+    atomic_fetch_add_explicit(&m_cpus_ready, 1, memory_order_release);
 
     // wait until the kernel wakes us
     // up to start scheduling
-    while (!atomic_load_explicit(&m_start_scheduler, memory_order_relaxed)) {
+    while (!atomic_load_explicit(&m_start_scheduler, memory_order_acquire)) {
         __builtin_ia32_pause();
     }
 
     // start scheduling!
     TRACE("\tCPU #%d", info->lapic_id);
-    atomic_fetch_add(&m_startup_count, 1);
+    atomic_fetch_add_explicit(&m_cpus_left_boot_stack, 1, memory_order_release);
     scheduler_startup();
 
     // we should not have reached here
@@ -167,6 +183,33 @@ cleanup:
         __halt();
 }
 
+/**
+ * Send all the other cpus to per_cpu_start, they only need the memory
+ * subsystem and the cpu locals of the bsp to be ready
+ */
+static err_t start_smp() {
+    err_t err = NO_ERROR;
+
+    TRACE("SMP Startup");
+    for (int i = 0; i < g_limine_smp.response->cpu_count; i++) {
+
+        // right now we assume that the apic id is always less than the cpu count
+        CHECK(g_limine_smp.response->cpus[i]->lapic_id < g_limine_smp.response->cpu_count);
+
+        if (g_limine_smp.response->cpus[i]->lapic_id == g_limine_smp.response->bsp_lapic_id) {
+            TRACE("\tCPU #%d - BSP", g_limine_smp.response->bsp_lapic_id);
+            CHECK(g_limine_smp.response->bsp_lapic_id == get_apic_id());
+            continue;
+        }
+
+        // go to it
+        g_limine_smp.response->cpus[i]->goto_address = per_cpu_start;
+    }
+
+cleanup:
+    return err;
+}
+
 /**
  * The corelib file
  */
@@ -188,20 +231,29 @@ static inline void self_test() {
     scheduler_self_test();
     semaphore_self_test();
     mutex_self_test();
+    string_benchmark();
     TRACE("self-test finished");
 }
 
-static void kernel_startup() {
+/**
+ * Give the bootloader memory back to the allocator, this is a thread of its own so it
+ * will run on one of the other cpus while the kernel thread initializes the runtime
+ */
+static void kernel_reclaim() {
     err_t err = NO_ERROR;
 
     // wait for all the cores to exit the preboot stuff
-    while (atomic_load_explicit(&m_startup_count, memory_order_relaxed) != g_limine_smp.response->cpu_count) {
-        __asm__ ("pause");
-    }
+    wait_for_cpus(&m_cpus_left_boot_stack, get_cpu_count());
 
-    // reclaim bootloader memory
     CHECK_AND_RETHROW(palloc_reclaim());
 
+cleanup:
+    ASSERT(!IS_ERROR(err));
+}
+
+static void kernel_startup() {
+    err_t err = NO_ERROR;
+
     // uncomment if you want to debug some stuff and
     // make sure that the kernel passes self-tests
 //    self_test();
@@ -239,6 +291,9 @@ void _start(void) {
     // we don't compile without support for it
     enable_cpu_features();
 
+    // select the mem* variants, the features are the same on all the cpus
+    init_string();
+
     // now setup idt/gdt
     init_gdt();
     init_idt();
@@ -257,6 +312,10 @@ void _start(void) {
     // check the bootloader behaved as expected
     CHECK_AND_RETHROW(validate_limine_modules());
 
+    // if we have the smp tag then we are SMP, set the cpu count, this must be
+    // done before any of the per-cpu init so it can size per-cpu structures
+    m_cpu_count = g_limine_smp.response->cpu_count;
+
     // for debugging
     TRACE("Kernel address map:");
     TRACE("\t%p-%p (%S): Kernel direct map", DIRECT_MAP_START, DIRECT_MAP_END, DIRECT_MAP_SIZE);
@@ -265,6 +324,9 @@ void _start(void) {
     heap_dump_mapping();
     TRACE("\t%p-%p (%S): Recursive paging", RECURSIVE_PAGING_START, RECURSIVE_PAGING_END, RECURSIVE_PAGING_SIZE);
     TRACE("\t%p-%p (%S): Kernel heap", KERNEL_HEAP_START, KERNEL_HEAP_END, KERNEL_HEAP_SIZE);
+    TRACE("\t%p-%p (%S): Code heap", CODE_HEAP_START, CODE_HEAP_END, CODE_HEAP_SIZE);
+    TRACE("\t%p-%p (%S): Code heap (writable alias)", CODE_HEAP_ALIAS_START, CODE_HEAP_ALIAS_END, CODE_HEAP_SIZE);
+    TRACE("\t%p-%p (%S): Card table", CARD_TABLE_START, CARD_TABLE_END, CARD_TABLE_SIZE);
 
     // initialize the whole memory subsystem for the current CPU,
     // will initialize the rest afterwards, init_vmm also initializes
@@ -273,8 +335,14 @@ void _start(void) {
     CHECK_AND_RETHROW(init_palloc());
     CHECK_AND_RETHROW(init_cpu_locals());
     CHECK_AND_RETHROW(init_tss());
+
+    // the other cpus only need the memory subsystem for their own init, so
+    // start them now and let them work in parallel to the rest of the init
+    CHECK_AND_RETHROW(start_smp());
+
     vmm_switch_allocator();
     CHECK_AND_RETHROW(init_malloc());
+    CHECK_AND_RETHROW(init_code_heap());
 
     // load symbols for nicer debugging
     // NOTE: must be done after allocators are done
@@ -285,44 +353,10 @@ void _start(void) {
     CHECK_AND_RETHROW(init_delay());
     CHECK_AND_RETHROW(init_rsc());
 
-    //
-    // Do SMP startup
-    //
-
-    // if we have the smp tag then we are SMP, set the cpu count
-    m_cpu_count = g_limine_smp.response->cpu_count;
-
     // initialize per cpu variables
     CHECK_AND_RETHROW(init_scheduler());
     CHECK_AND_RETHROW(init_tls());
 
-    // now actually do smp startup
-    TRACE("SMP Startup");
-    for (int i = 0; i < g_limine_smp.response->cpu_count; i++) {
-
-        // right now we assume that the apic id is always less than the cpu count
-        CHECK(g_limine_smp.response->cpus[i]->lapic_id < g_limine_smp.response->cpu_count);
-
-        if (g_limine_smp.response->cpus[i]->lapic_id == g_limine_smp.response->bsp_lapic_id) {
-            TRACE("\tCPU #%d - BSP", g_limine_smp.response->bsp_lapic_id);
-            CHECK(g_limine_smp.response->bsp_lapic_id == get_apic_id());
-            continue;
-        }
-
-        // go to it
-        g_limine_smp.response->cpus[i]->goto_address = per_cpu_start;
-    }
-
-    // wait for all the cores to start
-    while (atomic_load_explicit(&m_startup_count, memory_order_relaxed) != g_limine_smp.response->cpu_count - 1) {
-        __asm__ ("pause");
-    }
-
-    // make sure we got no SMP errors
-    CHECK(!atomic_load_explicit(&m_smp_error, memory_order_relaxed));
-
-    TRACE("Done CPU startup");
-
     // load the corelib module
     TRACE("Boot modules:");
     for (int i = 0; i < g_limine_module.response->module_count; i++) {
@@ -341,6 +375,14 @@ void _start(void) {
     TRACE("Corelib: %S", m_corelib_file.size);
     TRACE("Kernel: %S", m_kernel_file.size);
 
+    // wait for the rest of the cpus to finish their init
+    wait_for_cpus(&m_cpus_ready, get_cpu_count() - 1);
+
+    // make sure we got no SMP errors
+    CHECK(!atomic_load_explicit(&m_smp_error, memory_order_relaxed));
+
+    TRACE("Done CPU startup");
+
     TRACE("Kernel init done");
 
     // create the kernel start thread
@@ -348,15 +390,19 @@ void _start(void) {
     CHECK(thread != NULL);
     scheduler_ready_thread(thread);
 
-    // we are going to use this counter again to know when all
-    // cpus exited the bootlaoder supplied stack
-    m_startup_count = 0;
+    // the stacks of threads that went deep are reclaimed in the background
+    CHECK_AND_RETHROW(init_stack_reclaim());
+
+    // and the reclaim thread, it will be picked up by another cpu
+    thread_t* reclaim = create_thread(kernel_reclaim, NULL, "kernel/reclaim");
+    CHECK(reclaim != NULL);
+    scheduler_ready_thread(reclaim);
 
     TRACE("Starting up the scheduler");
     atomic_store_explicit(&m_start_scheduler, true, memory_order_release);
     TRACE("\tCPU #%d - BSP", get_apic_id());
 
-    atomic_fetch_add(&m_startup_count, 1);
+    atomic_fetch_add_explicit(&m_cpus_left_boot_stack, 1, memory_order_release);
     scheduler_startup();
 
 cleanup:
@@ -0,0 +1,14 @@
+#pragma once
+
+//
+// Force included into the MIR sources, MIR writes its generated code
+// directly to the address it is going to run from, so we redirect its
+// copies to the writable alias of the code heap instead of flipping the
+// permissions of the executable view
+//
+
+#include <string.h>
+#include <sys/mman.h>
+
+#undef memcpy
+#define memcpy(dest, src, n) mman_code_memcpy(dest, src, n)
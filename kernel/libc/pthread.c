@@ -4,29 +4,119 @@
 
 #include <string.h>
 
+#include <mem/malloc.h>
+
+#include <stdatomic.h>
+
+/**
+ * The state of a pthread, shared between the thread itself and whoever
+ * is going to join it. The thread holds one reference until it exits,
+ * and a joinable thread holds another one until it is joined or detached.
+ */
+struct pthread {
+    void* (*start_routine)(void*);
+    void* arg;
+
+    // the value returned from the start routine
+    void* retval;
+
+    // released once the thread has finished
+    semaphore_t done;
+
+    atomic_int ref_count;
+};
+
 static int m_pthread_unique_name_gen = 0;
 
+static void pthread_release(struct pthread* pthread) {
+    if (atomic_fetch_sub(&pthread->ref_count, 1) == 1) {
+        free(pthread);
+    }
+}
+
+static void pthread_entry(struct pthread* pthread) {
+    pthread->retval = pthread->start_routine(pthread->arg);
+
+    // wake the joiner and drop our reference
+    semaphore_release(&pthread->done, false);
+    pthread_release(pthread);
+}
+
+int pthread_attr_init(pthread_attr_t* attr) {
+    attr->detach_state = PTHREAD_CREATE_JOINABLE;
+    return 0;
+}
+
+int pthread_attr_destroy(pthread_attr_t* attr) {
+    return 0;
+}
+
+int pthread_attr_setdetachstate(pthread_attr_t* attr, int detach_state) {
+    if (detach_state != PTHREAD_CREATE_JOINABLE && detach_state != PTHREAD_CREATE_DETACHED) {
+        return -1;
+    }
+    attr->detach_state = detach_state;
+    return 0;
+}
+
+int pthread_attr_getdetachstate(const pthread_attr_t* attr, int* detach_state) {
+    *detach_state = attr->detach_state;
+    return 0;
+}
+
 int pthread_create(pthread_t *restrict thread,
                    const pthread_attr_t *restrict attr,
                    void *(*start_routine)(void *),
                    void *restrict arg) {
+    bool detached = attr != NULL && attr->detach_state == PTHREAD_CREATE_DETACHED;
+
+    struct pthread* pthread = malloc(sizeof(struct pthread));
+    if (pthread == NULL) {
+        return -1;
+    }
+    memset(pthread, 0, sizeof(*pthread));
+    pthread->start_routine = start_routine;
+    pthread->arg = arg;
+    pthread->ref_count = detached ? 1 : 2;
+
     // create the thread
-    thread_t* new_thread = create_thread((void*)start_routine, arg, "pthread-%d", m_pthread_unique_name_gen++);
+    thread_t* new_thread = create_thread((void*)pthread_entry, pthread, "pthread-%d", m_pthread_unique_name_gen++);
     if (new_thread == NULL) {
+        free(pthread);
         return -1;
     }
 
     // ready the thread
     scheduler_ready_thread(new_thread);
 
-    // give it out
-    *thread = new_thread;
+    // give it out, a detached thread may already be gone
+    // so don't give out a dangling pointer
+    *thread = detached ? NULL : pthread;
 
     return 0;
 }
 
 int pthread_join(pthread_t thread, void **retval) {
-    ASSERT(!"pthread_join: not implemented");
+    if (thread == NULL) {
+        return -1;
+    }
+
+    // wait for the thread to finish
+    semaphore_acquire(&thread->done, false);
+
+    if (retval != NULL) {
+        *retval = thread->retval;
+    }
+
+    pthread_release(thread);
+    return 0;
+}
+
+int pthread_detach(pthread_t thread) {
+    if (thread == NULL) {
+        return -1;
+    }
+    pthread_release(thread);
     return 0;
 }
 
@@ -7,21 +7,33 @@
 #include <sync/mutex.h>
 #include <sync/conditional.h>
 
+#define PTHREAD_CREATE_JOINABLE 0
+#define PTHREAD_CREATE_DETACHED 1
+
 // typedefs
 typedef mutex_t pthread_mutex_t;
 typedef conditional_t pthread_cond_t;
-typedef thread_t* pthread_t;
+typedef struct pthread* pthread_t;
+
+typedef struct pthread_attr {
+    int detach_state;
+} pthread_attr_t;
 
 // dummy
-typedef void* pthread_attr_t;
 typedef void* pthread_mutexattr_t;
 typedef void* pthread_condattr_t;
 
+int pthread_attr_init(pthread_attr_t* attr);
+int pthread_attr_destroy(pthread_attr_t* attr);
+int pthread_attr_setdetachstate(pthread_attr_t* attr, int detach_state);
+int pthread_attr_getdetachstate(const pthread_attr_t* attr, int* detach_state);
+
 int pthread_create(pthread_t *restrict thread,
                    const pthread_attr_t *restrict attr,
                    void *(*start_routine)(void *),
                    void *restrict arg);
 int pthread_join(pthread_t thread, void **retval);
+int pthread_detach(pthread_t thread);
 
 int pthread_mutex_init(pthread_mutex_t *restrict mutex, const pthread_mutexattr_t *restrict attr);
 int pthread_mutex_destroy(pthread_mutex_t *mutex);
@@ -1,15 +1,48 @@
 #include "mman.h"
 
+#include <mem/code_heap.h>
 #include <mem/mem.h>
+#include <util/string.h>
 
 int mprotect(void *addr, size_t len, int prot) {
+    // the code heap view is always read-execute and its permissions
+    // are never changed, MIR writes its code through the writable
+    // alias (see mman_code_memcpy) so there is nothing to do here
+    if (code_heap_contains(addr)) {
+        return 0;
+    }
+
     return IS_ERROR(vmm_set_perms(addr, ALIGN_UP(len, PAGE_SIZE) / PAGE_SIZE, prot)) ? -1 : 0;
 }
 
+void* mman_code_memcpy(void* restrict dest, const void* restrict src, size_t n) {
+    if (!code_heap_contains(dest)) {
+        return memcpy(dest, src, n);
+    }
+
+    // write the code through the alias, the executable view stays
+    // executable so other threads can keep running code from the
+    // same pages while we are writing
+    memcpy(code_heap_get_writable(dest), src, n);
+    code_heap_flush();
+    return dest;
+}
+
 void* mmap(void* addr, size_t len, int prot, int flags, int fildes, off_t off) {
     ASSERT(off == 0);
     ASSERT(fildes < 0);
     ASSERT(flags == (MAP_PRIVATE | MAP_ANONYMOUS));
+
+    // executable memory comes from the code heap, this keeps all the
+    // jitted code packed in a single region instead of the direct map
+    if (prot & PROT_EXEC) {
+        void* ptr = code_heap_alloc_pages(ALIGN_UP(len, PAGE_SIZE) / PAGE_SIZE);
+        if (ptr == NULL) {
+            return MAP_FAILED;
+        }
+        return ptr;
+    }
+
     void* ptr = palloc(ALIGN_UP(len, PAGE_SIZE));
     if (ptr == NULL) {
         return MAP_FAILED;
@@ -19,9 +52,14 @@ void* mmap(void* addr, size_t len, int prot, int flags, int fildes, off_t off) {
 }
 
 int munmap(void* addr, size_t len) {
+    if (code_heap_contains(addr)) {
+        code_heap_free_pages(addr, ALIGN_UP(len, PAGE_SIZE) / PAGE_SIZE);
+        return 0;
+    }
+
     if (mprotect(addr, len, PROT_READ | PROT_WRITE) != 0) {
         return -1;
     }
     pfree(addr);
     return 0;
-}
\ No newline at end of file
+}
@@ -17,6 +17,12 @@
 
 int mprotect(void* addr, size_t len, int prot);
 
+/**
+ * memcpy for MIR, writes that target the code heap are redirected to
+ * the writable alias of the code, everything else is a normal memcpy
+ */
+void* mman_code_memcpy(void* restrict dest, const void* restrict src, size_t n);
+
 typedef size_t off_t;
 
 void* mmap(void* addr, size_t len, int prot, int flags, int fildes, off_t off);
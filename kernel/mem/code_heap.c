@@ -0,0 +1,169 @@
+#include "code_heap.h"
+
+#include "mem.h"
+
+#include <sync/spinlock.h>
+#include <util/string.h>
+#include <util/stb_ds.h>
+#include <arch/intrin.h>
+
+//
+// The code heap is a single virtual range which is committed in chunks, each chunk
+// is physically contiguous and is mapped twice, once as read-execute in the code heap
+// and once as read-write in the alias range. Permissions are never changed after the
+// mapping is created, which means we never need to do any TLB shootdown for jitted
+// code, and we never have a direct map page that is executable.
+//
+// Memory is handed out in whole pages, MIR packs the method bodies into those pages
+// itself, freed page ranges are kept on a list so they can be reused by a later
+// allocation.
+//
+
+/**
+ * How much we commit at a time, each commit is physically contiguous
+ */
+#define CODE_HEAP_COMMIT_SIZE   SIZE_64KB
+
+/**
+ * The alias offset from the executable view
+ */
+#define CODE_HEAP_ALIAS_OFFSET  (CODE_HEAP_ALIAS_START - CODE_HEAP_START)
+
+typedef struct code_heap_free_pages {
+    void* base;
+    size_t page_count;
+} code_heap_free_pages_t;
+
+/**
+ * Protects the code heap
+ */
+static spinlock_t m_code_heap_lock = INIT_SPINLOCK();
+
+/**
+ * The next free address of the bump allocator
+ */
+static uintptr_t m_code_heap_bump = CODE_HEAP_START;
+
+/**
+ * The end of the committed range
+ */
+static uintptr_t m_code_heap_committed = CODE_HEAP_START;
+
+/**
+ * Freed page ranges
+ */
+static code_heap_free_pages_t* m_code_heap_free_pages = NULL;
+
+/**
+ * Commit more memory so the bump allocator can allocate the given size,
+ * must be called with the lock held
+ */
+static err_t commit_code_heap(size_t size) {
+    err_t err = NO_ERROR;
+    void* chunk = NULL;
+
+    if (m_code_heap_bump + size <= m_code_heap_committed) {
+        goto cleanup;
+    }
+
+    size_t commit_size = ALIGN_UP(m_code_heap_bump + size - m_code_heap_committed, CODE_HEAP_COMMIT_SIZE);
+    CHECK_ERROR(m_code_heap_committed + commit_size <= CODE_HEAP_END, ERROR_OUT_OF_MEMORY);
+
+    chunk = palloc(commit_size);
+    CHECK_ERROR(chunk != NULL, ERROR_OUT_OF_MEMORY);
+    uintptr_t phys = DIRECT_TO_PHYS(chunk);
+
+    // fill with int3 so jumping into uninitialized code will trap nicely, must
+    // be done before we remove it from the direct map
+    memset(chunk, 0xCC, commit_size);
+
+    // map it twice, the executable view also removes it from the direct map so we
+    // won't have another writable alias for it
+    CHECK_AND_RETHROW(vmm_map(phys, (void*)CODE_HEAP_ALIAS_START + (m_code_heap_committed - CODE_HEAP_START),
+                              commit_size / PAGE_SIZE, MAP_WRITE));
+    CHECK_AND_RETHROW(vmm_map(phys, (void*)m_code_heap_committed,
+                              commit_size / PAGE_SIZE, MAP_EXEC | MAP_UNMAP_DIRECT));
+    chunk = NULL;
+
+    m_code_heap_committed += commit_size;
+
+cleanup:
+    if (chunk != NULL) {
+        pfree(chunk);
+    }
+    return err;
+}
+
+err_t init_code_heap() {
+    err_t err = NO_ERROR;
+
+    spinlock_lock(&m_code_heap_lock);
+    CHECK_AND_RETHROW(commit_code_heap(CODE_HEAP_COMMIT_SIZE));
+
+cleanup:
+    spinlock_unlock(&m_code_heap_lock);
+    return err;
+}
+
+void* code_heap_alloc_pages(size_t page_count) {
+    void* ptr = NULL;
+
+    spinlock_lock(&m_code_heap_lock);
+
+    // first fit from the freed ranges
+    for (int i = 0; i < arrlen(m_code_heap_free_pages); i++) {
+        code_heap_free_pages_t* range = &m_code_heap_free_pages[i];
+        if (range->page_count < page_count) {
+            continue;
+        }
+
+        ptr = range->base;
+        range->base += page_count * PAGE_SIZE;
+        range->page_count -= page_count;
+        if (range->page_count == 0) {
+            arrdelswap(m_code_heap_free_pages, i);
+        }
+        goto cleanup;
+    }
+
+    if (IS_ERROR(commit_code_heap(page_count * PAGE_SIZE))) {
+        goto cleanup;
+    }
+    ptr = (void*)m_code_heap_bump;
+    m_code_heap_bump += page_count * PAGE_SIZE;
+
+cleanup:
+    spinlock_unlock(&m_code_heap_lock);
+
+    return ptr;
+}
+
+void code_heap_free_pages(void* code, size_t page_count) {
+    if (code == NULL) {
+        return;
+    }
+    ASSERT(code_heap_contains(code));
+    ASSERT(((uintptr_t)code % PAGE_SIZE) == 0);
+
+    spinlock_lock(&m_code_heap_lock);
+    code_heap_free_pages_t range = { .base = code, .page_count = page_count };
+    arrpush(m_code_heap_free_pages, range);
+    spinlock_unlock(&m_code_heap_lock);
+}
+
+void* code_heap_get_writable(void* code) {
+    ASSERT(code_heap_contains(code));
+    return code + CODE_HEAP_ALIAS_OFFSET;
+}
+
+bool code_heap_contains(void* ptr) {
+    return CODE_HEAP_START <= (uintptr_t)ptr && (uintptr_t)ptr < CODE_HEAP_END;
+}
+
+void code_heap_flush() {
+    // x86 keeps the instruction cache coherent with stores even through a different
+    // linear address, and since the permissions never change there is no TLB state to
+    // invalidate, we only need to make sure all the stores done through the alias are
+    // visible before anyone gets the pointer to the code
+    _mm_mfence();
+}
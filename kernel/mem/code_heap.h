@@ -0,0 +1,47 @@
+#pragma once
+
+#include <util/except.h>
+
+#include <stdbool.h>
+#include <stddef.h>
+
+/**
+ * Initialize the code heap, commits the first chunk
+ */
+err_t init_code_heap();
+
+/**
+ * Allocate whole pages from the code heap, the returned address is
+ * the executable view, the code should be written through the address
+ * returned from code_heap_get_writable. Used by the mmap shim for MIR,
+ * which packs the method bodies into the pages itself.
+ *
+ * @param page_count    [IN] The amount of pages to allocate
+ */
+void* code_heap_alloc_pages(size_t page_count);
+
+/**
+ * Free pages allocated with code_heap_alloc_pages
+ *
+ * @param code          [IN] The executable address of the pages
+ * @param page_count    [IN] The amount of pages
+ */
+void code_heap_free_pages(void* code, size_t page_count);
+
+/**
+ * Get the writable alias of the given code address
+ *
+ * @param code  [IN] The executable address
+ */
+void* code_heap_get_writable(void* code);
+
+/**
+ * Check if the given address is inside of the code heap
+ */
+bool code_heap_contains(void* ptr);
+
+/**
+ * Publish code written through the writable alias so it can be
+ * executed, writes can be batched and published with a single call.
+ */
+void code_heap_flush();
@@ -37,11 +37,18 @@ STATIC_ASSERT(BUDDY_TREE_END < STACK_POOL_START);
 #define OBJECT_HEAP_END                 (0xffff810000000000 + SIZE_1TB * 13)
 STATIC_ASSERT(STACK_POOL_END < OBJECT_HEAP_START);
 
+// The monitor lock words of the object heap, every slot of the heap has
+// its own word, the pages are committed on demand by the page fault handler
+#define LOCK_TABLE_SIZE                 ((OBJECT_HEAP_END - OBJECT_HEAP_START) / 2)
+#define LOCK_TABLE_START                (OBJECT_HEAP_END + SIZE_1TB)
+#define LOCK_TABLE_END                  (LOCK_TABLE_START + LOCK_TABLE_SIZE)
+STATIC_ASSERT(OBJECT_HEAP_END < LOCK_TABLE_START);
+
 // This is the area the recursive paging exist on
 #define RECURSIVE_PAGING_SIZE           (SIZE_512GB)
 #define RECURSIVE_PAGING_START          (0xFFFFFF0000000000ull)
 #define RECURSIVE_PAGING_END            (RECURSIVE_PAGING_START + RECURSIVE_PAGING_SIZE)
-STATIC_ASSERT(OBJECT_HEAP_END < RECURSIVE_PAGING_START);
+STATIC_ASSERT(LOCK_TABLE_END < RECURSIVE_PAGING_START);
 
 // The kernel heap area
 #define KERNEL_HEAP_SIZE                (SIZE_4GB)
@@ -49,9 +56,29 @@ STATIC_ASSERT(OBJECT_HEAP_END < RECURSIVE_PAGING_START);
 #define KERNEL_HEAP_END                 (KERNEL_HEAP_START + KERNEL_HEAP_SIZE)
 STATIC_ASSERT(RECURSIVE_PAGING_END < KERNEL_HEAP_START);
 
+// The code heap, this is where jitted code lives, it is mapped twice, once as
+// read-execute for running it and once as read-write so the jit can write to
+// it, this way we never have a page which is both writable and executable
+#define CODE_HEAP_SIZE                  (SIZE_1GB)
+#define CODE_HEAP_START                 (KERNEL_HEAP_END + SIZE_1GB)
+#define CODE_HEAP_END                   (CODE_HEAP_START + CODE_HEAP_SIZE)
+STATIC_ASSERT(KERNEL_HEAP_END < CODE_HEAP_START);
+
+// The writable alias of the code heap
+#define CODE_HEAP_ALIAS_START           (CODE_HEAP_END + SIZE_1GB)
+#define CODE_HEAP_ALIAS_END             (CODE_HEAP_ALIAS_START + CODE_HEAP_SIZE)
+STATIC_ASSERT(CODE_HEAP_END < CODE_HEAP_ALIAS_START);
+
+// The card table of the object heap, a byte for every 512 bytes of the
+// object heap, committed together with the object heap
+#define CARD_TABLE_SIZE                 ((OBJECT_HEAP_END - OBJECT_HEAP_START) / 512)
+#define CARD_TABLE_START                (CODE_HEAP_ALIAS_END + SIZE_1GB)
+#define CARD_TABLE_END                  (CARD_TABLE_START + CARD_TABLE_SIZE)
+STATIC_ASSERT(CODE_HEAP_ALIAS_END < CARD_TABLE_START);
+
 // This is where the kernel virtual address is
 #define KERNEL_BASE                     (0xffffffff80000000)
-STATIC_ASSERT(KERNEL_HEAP_END < KERNEL_BASE);
+STATIC_ASSERT(CARD_TABLE_END < KERNEL_BASE);
 
 #define PHYS_TO_DIRECT(x) \
     ({ \
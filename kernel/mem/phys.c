@@ -142,12 +142,15 @@ err_t palloc_reclaim() {
         }
     }
 
-    // now actually reclaim them
+    // now actually reclaim them, the rest of the kernel is already
+    // running at this point so we must take the lock
     TRACE("Reclaiming memory");
     for (int i = 0; i < arrlen(to_reclaim); i++) {
         struct limine_memmap_entry* entry = &to_reclaim[i];
         TRACE("\t%p-%p: %S", entry->base, entry->base + entry->length, entry->length);
+        irq_spinlock_lock(&m_palloc_lock);
         buddy_unsafe_release_range(m_buddy, PHYS_TO_DIRECT(entry->base), entry->length);
+        irq_spinlock_unlock(&m_palloc_lock);
     }
 
 cleanup:
@@ -11,7 +11,8 @@
 err_t init_palloc();
 
 /**
- * Reclaim bootloader memory
+ * Reclaim bootloader memory, can run in parallel to other allocations but only
+ * once no cpu uses the bootloader supplied stack anymore
  */
 err_t palloc_reclaim();
 
@@ -1,14 +1,63 @@
 #include "stack.h"
 
 #include "mem.h"
+#include "phys.h"
+#include "vmm.h"
 
-#include <sync/spinlock.h>
+#include <thread/cpu_local.h>
+#include <thread/scheduler.h>
+#include <thread/waitable.h>
+#include <thread/thread.h>
+#include <sync/irq_spinlock.h>
+#include <arch/intrin.h>
 #include <util/string.h>
+#include <util/stb_ds.h>
+#include <time/tsc.h>
 
 /**
- * Protects the stack allocator
+ * The top pages of a stack that are kept mapped when the stack is freed, most
+ * threads never go deeper than this so there is no point in releasing them
  */
-static spinlock_t m_stack_alloc_lock = INIT_SPINLOCK();
+#define STACK_WARM_SIZE             SIZE_16KB
+
+/**
+ * The amount of free stacks every cpu keeps for itself
+ */
+#define STACK_CPU_CACHE_SIZE        8
+
+/**
+ * Wake the reclaim thread early once this many deep stacks are waiting
+ */
+#define STACK_RECLAIM_THRESHOLD     16
+
+/**
+ * How often the reclaim thread looks for deep stacks on its own
+ */
+#define STACK_RECLAIM_INTERVAL      (MICROSECONDS_PER_SECOND / 10)
+
+/**
+ * The amount of slots in the stack pool
+ */
+#define STACK_SLOT_COUNT            (STACK_POOL_SIZE / STACK_SLOT_SIZE)
+
+/**
+ * The amount of pages kept when a stack is freed
+ */
+#define STACK_WARM_PAGES            (STACK_WARM_SIZE / PAGE_SIZE)
+
+/**
+ * The depth of the lowest page that was faulted in, in pages from the top of the
+ * stack, per stack slot. Only the thread that owns the stack faults on it, and the
+ * depth is only read once the thread is dead, so it needs no lock.
+ */
+static uint16_t m_stack_depth[STACK_SLOT_COUNT] = { 0 };
+STATIC_ASSERT(STACK_SIZE / PAGE_SIZE <= UINT16_MAX);
+
+/**
+ * Protects the stack allocator, the stacks are freed from the scheduler
+ * when a thread dies so this must be an irq spinlock
+ */
+static irq_spinlock_t m_stack_alloc_lock = INIT_IRQ_SPINLOCK();
 
 /**
  * This points to the next stack that we can allocate
@@ -16,16 +65,87 @@ static spinlock_t m_stack_alloc_lock = INIT_SPINLOCK();
 static void* m_next_stack = (void*)STACK_POOL_START;
 
 /**
- * A list of free stacks
+ * A list of free stacks, only the warm pages of these are mapped
  */
 static list_t m_stack_free_list = INIT_LIST(m_stack_free_list);
 
+/**
+ * A list of free stacks that still have pages mapped below the warm
+ * pages, waiting for the reclaim thread to release them
+ */
+static list_t m_stack_deep_list = INIT_LIST(m_stack_deep_list);
+static _Atomic(int) m_stack_deep_count = 0;
+
+/**
+ * The stacks cached on the current cpu, taken with interrupts disabled
+ */
+static void* CPU_LOCAL m_stack_cache[STACK_CPU_CACHE_SIZE];
+static int CPU_LOCAL m_stack_cache_len = 0;
+
+/**
+ * Used to wake the reclaim thread early
+ */
+static waitable_t* m_stack_reclaim_wakeup = NULL;
+
+/**
+ * Get the slot index of the stack
+ */
+static size_t get_stack_slot(void* stack) {
+    return ((uintptr_t)stack - 1 - STACK_POOL_START) / STACK_SLOT_SIZE;
+}
+
+void stack_record_fault(uintptr_t address) {
+    // the slot size is not a power of two, so it can't be aligned down, the
+    // top is at the same offset in the slot as the one alloc_stack returns
+    size_t slot = (address - STACK_POOL_START) / STACK_SLOT_SIZE;
+    uintptr_t top = STACK_POOL_START + slot * STACK_SLOT_SIZE + SIZE_2MB;
+    if (address >= top) {
+        return;
+    }
+
+    // a large frame can skip pages, so we keep the lowest page and not
+    // the amount of pages that were faulted
+    uint16_t depth = (top - ALIGN_DOWN(address, PAGE_SIZE)) / PAGE_SIZE;
+    if (depth > m_stack_depth[slot]) {
+        m_stack_depth[slot] = depth;
+    }
+}
+
+bool stack_is_deep(void* stack) {
+    return m_stack_depth[get_stack_slot(stack)] > STACK_WARM_PAGES;
+}
+
 void* alloc_stack() {
     void* ret = NULL;
 
-    spinlock_lock(&m_stack_alloc_lock);
+    // try the cache of the current cpu first
+    bool ints = __readeflags() & BIT9 ? true : false;
+    _disable();
+    if (m_stack_cache_len > 0) {
+        ret = m_stack_cache[--m_stack_cache_len];
+        m_stack_cache[m_stack_cache_len] = NULL;
+    }
+    if (ints) {
+        _enable();
+    }
+
+    if (ret != NULL) {
+        // the warm pages of a cached stack are always mapped
+        return ret;
+    }
+
+    irq_spinlock_lock(&m_stack_alloc_lock);
 
+    // prefer the stacks that were already reclaimed, but a deep
+    // stack is still better than taking a new slot
     list_entry_t* stack = list_pop(&m_stack_free_list);
+    if (stack == NULL) {
+        stack = list_pop(&m_stack_deep_list);
+        if (stack != NULL) {
+            m_stack_deep_count--;
+        }
+    }
+
     if (stack != NULL) {
         // we got a stack from the cache, we need to get the end of the
         // list entry struct to get the actual base of the stack
@@ -34,7 +154,7 @@ void* alloc_stack() {
     }
 
     // we need to allocate a new one, check that we have space for that
-    if (((uintptr_t)m_next_stack + (SIZE_1MB * 3)) >= STACK_POOL_END) {
+    if (((uintptr_t)m_next_stack + STACK_SLOT_SIZE) >= STACK_POOL_END) {
         goto cleanup;
     }
 
@@ -43,13 +163,13 @@ void* alloc_stack() {
 
     // increment it by 3mb to account for guard page
     // and the stack space
-    m_next_stack += SIZE_1MB * 3;
+    m_next_stack += STACK_SLOT_SIZE;
 
     // move by 2mb to get to the base of the stack
     ret += SIZE_2MB;
 
 cleanup:
-    spinlock_unlock(&m_stack_alloc_lock);
+    irq_spinlock_unlock(&m_stack_alloc_lock);
 
     if (ret != NULL) {
         // access the first page just so we can
@@ -57,15 +177,146 @@ cleanup:
         memset(ret - 1, 0, 1);
     }
 
+    // we are allocating so it is a good time to check if we should
+    // reclaim, this is not possible from free_stack since it runs
+    // from the scheduler
+    if (m_stack_reclaim_wakeup != NULL && atomic_load(&m_stack_deep_count) >= STACK_RECLAIM_THRESHOLD) {
+        waitable_send(m_stack_reclaim_wakeup, false);
+    }
+
     return ret;
 }
 
-void free_stack(void* stack) {
-    spinlock_lock(&m_stack_alloc_lock);
-
+void free_stack(void* stack, bool deep) {
     // get the entry from the end of the stack
     list_entry_t* entry = (list_entry_t*)stack - 1;
+
+    // deep stacks go to the reclaim thread
+    if (deep) {
+        irq_spinlock_lock(&m_stack_alloc_lock);
+        list_add(&m_stack_deep_list, entry);
+        m_stack_deep_count++;
+        irq_spinlock_unlock(&m_stack_alloc_lock);
+        return;
+    }
+
+    // try to keep it on the current cpu
+    bool ints = __readeflags() & BIT9 ? true : false;
+    _disable();
+    bool cached = false;
+    if (m_stack_cache_len < STACK_CPU_CACHE_SIZE) {
+        m_stack_cache[m_stack_cache_len++] = stack;
+        cached = true;
+    }
+    if (ints) {
+        _enable();
+    }
+
+    if (cached) {
+        return;
+    }
+
+    irq_spinlock_lock(&m_stack_alloc_lock);
     list_add(&m_stack_free_list, entry);
+    irq_spinlock_unlock(&m_stack_alloc_lock);
+}
+
+void stack_reclaim() {
+    void** stacks = NULL;
+    uintptr_t* pages = NULL;
+
+    // we can't allocate under the lock so reserve up front, whatever
+    // doesn't fit will be reclaimed on the next round
+    arrsetcap(stacks, atomic_load(&m_stack_deep_count) + STACK_CPU_CACHE_SIZE);
+
+    // take the deep stacks, nothing else can touch them until
+    // we put them back on the free list
+    irq_spinlock_lock(&m_stack_alloc_lock);
+    list_entry_t* entry;
+    while (arrlenu(stacks) < arrcap(stacks) && (entry = list_pop(&m_stack_deep_list)) != NULL) {
+        m_stack_deep_count--;
+        arrput(stacks, (void*)(entry + 1));
+    }
+    irq_spinlock_unlock(&m_stack_alloc_lock);
+
+    if (arrlenu(stacks) == 0) {
+        goto cleanup;
+    }
+
+    // unmap everything below the warm pages, nothing was mapped
+    // below the lowest page that was faulted in
+    for (int i = 0; i < arrlen(stacks); i++) {
+        uint16_t* depth = &m_stack_depth[get_stack_slot(stacks[i])];
+        uintptr_t lowest = (uintptr_t)stacks[i] - *depth * PAGE_SIZE;
+        uintptr_t warm = (uintptr_t)stacks[i] - STACK_WARM_SIZE;
+        for (uintptr_t va = lowest; va < warm; va += PAGE_SIZE) {
+            if (!vmm_is_mapped(va)) {
+                continue;
+            }
+
+            uintptr_t phys;
+            vmm_unmap((void*)va, 1, &phys);
+            __invlpg((void*)va);
+            arrput(pages, phys);
+        }
+
+        // only the warm pages are left
+        *depth = STACK_WARM_PAGES;
+    }
+
+    // the stacks might have ran on any of the cpus, make sure no
+    // one has the pages in the TLB before we free them
+    vmm_tlb_shootdown();
+
+    for (int i = 0; i < arrlen(pages); i++) {
+        // the pages were taken out of the direct map when they
+        // were mapped, the allocator needs them back in it
+        if (IS_ERROR(vmm_remap_direct_page(pages[i]))) {
+            WARN("stack: failed to map %p back to the direct map, leaking it", pages[i]);
+            continue;
+        }
+        pfree(PHYS_TO_DIRECT(pages[i]));
+    }
+
+    // and now they are normal free stacks
+    irq_spinlock_lock(&m_stack_alloc_lock);
+    for (int i = 0; i < arrlen(stacks); i++) {
+        list_add(&m_stack_free_list, (list_entry_t*)stacks[i] - 1);
+    }
+    irq_spinlock_unlock(&m_stack_alloc_lock);
 
-    spinlock_unlock(&m_stack_alloc_lock);
+cleanup:
+    arrfree(stacks);
+    arrfree(pages);
+}
+
+static void stack_reclaim_thread(void* arg) {
+    while (true) {
+        waitable_t* timeout = after(STACK_RECLAIM_INTERVAL);
+        if (timeout != NULL) {
+            waitable_t* ws[] = { m_stack_reclaim_wakeup, timeout };
+            waitable_select(ws, 0, 2, true);
+            release_waitable(timeout);
+        } else {
+            waitable_wait(m_stack_reclaim_wakeup, true);
+        }
+
+        if (atomic_load(&m_stack_deep_count) != 0) {
+            stack_reclaim();
+        }
+    }
+}
+
+err_t init_stack_reclaim() {
+    err_t err = NO_ERROR;
+
+    m_stack_reclaim_wakeup = create_waitable(1);
+    CHECK_ERROR(m_stack_reclaim_wakeup != NULL, ERROR_OUT_OF_MEMORY);
+
+    thread_t* thread = create_thread(stack_reclaim_thread, NULL, "stack/reclaim");
+    CHECK_ERROR(thread != NULL, ERROR_OUT_OF_MEMORY);
+    scheduler_ready_thread(thread);
+
+cleanup:
+    return err;
 }
@@ -1,7 +1,12 @@
 #pragma once
 
+#include <util/except.h>
+
 #define STACK_SIZE SIZE_2MB
 
+// every stack takes a slot of the stack pool, a 1MB guard followed by the stack
+#define STACK_SLOT_SIZE (SIZE_1MB * 3)
+
 #define PUSH(type, stack, value) \
     ({ \
         stack -= sizeof(type); \
@@ -19,6 +24,38 @@
 void* alloc_stack();
 
 /**
- * Free an allocated stack
+ * Free an allocated stack, can be called from the scheduler
+ *
+ * @remark
+ * A stack that went deep keeps its pages until the reclaim thread releases
+ * them, everything but the few top pages goes back to the page allocator
+ *
+ * @param stack [IN] The top of the stack
+ * @param deep  [IN] The result of stack_is_deep on the stack
+ */
+void free_stack(void* stack, bool deep);
+
+/**
+ * Check if the stack went deeper than the few top pages that are kept when it is freed,
+ * this only looks at the depth recorded by stack_record_fault so it is cheap
+ */
+bool stack_is_deep(void* stack);
+
+/**
+ * Record that a page of the stack pool was faulted in, called from the page fault
+ * handler so we know how deep each stack went without walking its page tables
+ *
+ * @param address   [IN] The faulting address
+ */
+void stack_record_fault(uintptr_t address);
+
+/**
+ * Release the pages of the freed stacks that went deep, must be called from a thread
+ * since it needs to do a TLB shootdown
+ */
+void stack_reclaim();
+
+/**
+ * Start the thread that reclaims the freed stacks in the background
  */
-void free_stack(void* stack);
+err_t init_stack_reclaim();
@@ -12,9 +12,14 @@
 
 #include "mem.h"
 #include "early.h"
+#include "stack.h"
 
 #include "arch/intrin.h"
 #include "sync/irq_spinlock.h"
+#include "sync/mutex.h"
+#include "thread/cpu_local.h"
+#include "thread/scheduler.h"
+#include "irq/irq.h"
 
 // The recursive page table addresses
 #define PAGE_TABLE_PML1            ((page_entry_t*)0xFFFFFF0000000000ull)
@@ -102,6 +107,12 @@ err_t init_vmm() {
                 perms = MAP_WRITE;
             }
 
+            if (type == LIMINE_MEMMAP_FRAMEBUFFER) {
+                // the framebuffer is only ever written in bulk, let the
+                // writes combine instead of going out one by one
+                perms |= MAP_CACHE_WC;
+            }
+
             if (name != NULL) {
                 TRACE("\t%p-%p (%08p-%08p) [r%c-]: %s",
                       entry->base, entry->base + entry->length,
@@ -190,6 +201,22 @@ void init_vmm_per_cpu() {
     efer.SCE = 0;
     __writemsr(MSR_IA32_EFER, efer.packed);
 
+    // program the PAT, it must be the same on all the cpus. The first four entries are the
+    // power-on defaults so the bootloader mappings keep their types, and the fifth is WC, the
+    // order matches the MAP_CACHE_* values. The new entries are not used by any mapping yet
+    // so there is nothing to flush from the caches, and the cr3 write flushes the TLB
+    msr_pat_t pat = {
+        .pa0 = PAT_WB,
+        .pa1 = PAT_WT,
+        .pa2 = PAT_UC_MINUS,
+        .pa3 = PAT_UC,
+        .pa4 = PAT_WC,
+        .pa5 = PAT_WT,
+        .pa6 = PAT_UC_MINUS,
+        .pa7 = PAT_UC,
+    };
+    __writemsr(MSR_IA32_PAT, pat.packed);
+
     // set the phys table for the current CPU
     __writecr3(m_pml4_pa);
 }
@@ -268,6 +295,17 @@ static bool vmm_setup_level(page_entry_t* pml, page_entry_t* next_pml, size_t in
     return true;
 }
 
+/**
+ * Set the memory type of a 4k page entry, the PAT index is made of the
+ * PAT bit (which is bit 7, the huge page bit in the higher levels), PCD and PWT
+ */
+static void set_memory_type(page_entry_t* entry, map_perm_t perms) {
+    size_t index = (perms & MAP_CACHE_MASK) >> 3;
+    entry->write_through = (index & 1) ? 1 : 0;
+    entry->no_cache = (index & 2) ? 1 : 0;
+    entry->huge_page = (index & 4) ? 1 : 0;
+}
+
 static err_t do_map(uintptr_t pa, void* va, size_t page_count, map_perm_t perms) {
     err_t err = NO_ERROR;
 
@@ -293,6 +331,7 @@ static err_t do_map(uintptr_t pa, void* va, size_t page_count, map_perm_t perms)
             .writeable = (perms & MAP_WRITE) ? 1 : 0,
             .no_execute = (perms & MAP_EXEC) ? 0 : 1,
         };
+        set_memory_type(&PAGE_TABLE_PML1[pml1i], perms);
 
         // invalidate the new mapped address
         __invlpg((void*)cva);
@@ -330,10 +369,11 @@ err_t vmm_set_perms(void* va, size_t page_count, map_perm_t perms) {
     for (int i = 0; i < page_count; i++, va += PAGE_SIZE) {
         size_t pml1i = ((uintptr_t)va >> 12) & 0xFFFFFFFFFull;
 
-        // make sure the page is mapped and change the write/exec perms
+        // make sure the page is mapped and change the write/exec perms and the memory type
         CHECK(PAGE_TABLE_PML1[pml1i].present);
         PAGE_TABLE_PML1[pml1i].writeable = (perms & MAP_WRITE) ? 1 : 0;
         PAGE_TABLE_PML1[pml1i].no_execute = (perms & MAP_EXEC) ? 0 : 1;
+        set_memory_type(&PAGE_TABLE_PML1[pml1i], perms);
 
         // unmap if needed
         if (perms & MAP_UNMAP_DIRECT) {
@@ -393,6 +433,58 @@ void vmm_unmap(void* va, size_t page_count, uintptr_t* phys) {
 
 }
 
+err_t vmm_remap_direct_page(uintptr_t pa) {
+    err_t err = NO_ERROR;
+
+    irq_spinlock_lock(&m_vmm_spinlock);
+    CHECK_AND_RETHROW(do_map(pa, PHYS_TO_DIRECT(pa), 1, MAP_WRITE));
+
+cleanup:
+    irq_spinlock_unlock(&m_vmm_spinlock);
+    return err;
+}
+
+/**
+ * Only a single shootdown can be in flight, since they share the counter
+ */
+static mutex_t m_tlb_shootdown_lock = { 0 };
+
+/**
+ * The amount of cpus that did not flush their TLB yet
+ */
+static _Atomic(int) m_tlb_shootdown_pending = 0;
+
+void vmm_tlb_shootdown() {
+    mutex_lock(&m_tlb_shootdown_lock);
+
+    // don't move to another cpu while we are sending the IPIs
+    scheduler_preempt_disable();
+
+    int current_cpu = get_cpu_id();
+    atomic_store(&m_tlb_shootdown_pending, get_cpu_count() - 1);
+    for (int cpu = 0; cpu < get_cpu_count(); cpu++) {
+        if (cpu != current_cpu) {
+            lapic_send_ipi(IRQ_TLB_SHOOTDOWN, cpu);
+        }
+    }
+
+    // flush our own while the rest are doing it
+    __writecr3(__readcr3());
+
+    while (atomic_load(&m_tlb_shootdown_pending) != 0) {
+        __builtin_ia32_pause();
+    }
+
+    scheduler_preempt_enable();
+
+    mutex_unlock(&m_tlb_shootdown_lock);
+}
+
+INTERRUPT void vmm_on_tlb_shootdown() {
+    __writecr3(__readcr3());
+    atomic_fetch_sub(&m_tlb_shootdown_pending, 1);
+}
+
 bool vmm_is_mapped(uintptr_t ptr) {
     // make sure it is present
     if (!PAGE_TABLE_PML4[PML4_INDEX(ptr)].present) return false;
@@ -402,6 +494,27 @@ bool vmm_is_mapped(uintptr_t ptr) {
     return true;
 }
 
+/**
+ * Map a new page at the address, unless it was already mapped by another cpu
+ * that faulted on it at the same time
+ */
+static err_t vmm_alloc_if_unmapped(void* va, map_perm_t perms) {
+    err_t err = NO_ERROR;
+
+    irq_spinlock_lock(&m_vmm_spinlock);
+
+    if (!vmm_is_mapped((uintptr_t)va)) {
+        uintptr_t page = vmm_alloc_page();
+        CHECK(page != INVALID_PHYS_ADDR);
+        CHECK_AND_RETHROW(do_map(page, va, 1, perms));
+    }
+
+cleanup:
+    irq_spinlock_unlock(&m_vmm_spinlock);
+
+    return err;
+}
+
 err_t vmm_page_fault_handler(uintptr_t fault_address, bool write, bool present) {
     err_t err = NO_ERROR;
 
@@ -423,6 +536,18 @@ err_t vmm_page_fault_handler(uintptr_t fault_address, bool write, bool present)
 
         // we are good, map the page
         CHECK_AND_RETHROW(vmm_alloc((void*) ALIGN_DOWN(fault_address, PAGE_SIZE), 1, MAP_WRITE | MAP_UNMAP_DIRECT));
+
+        // remember how deep the stack went, so freeing it won't need to walk it
+        stack_record_fault(fault_address);
+
+    } else if (LOCK_TABLE_START <= fault_address && fault_address < LOCK_TABLE_END) {
+        // make sure this happens only for non-present page
+        CHECK(!present);
+
+        // the monitor lock words, a page is only committed once an object
+        // that has its word in the page is locked for the first time
+        CHECK_AND_RETHROW(vmm_alloc_if_unmapped((void*) ALIGN_DOWN(fault_address, PAGE_SIZE), MAP_WRITE));
+
     } else {
         CHECK_FAIL("Invalid paging request at %p", fault_address);
     }
@@ -77,6 +77,14 @@ bool vmm_setup_level(page_entry_t* pml, page_entry_t* next_pml, size_t index);
  */
 void vmm_unmap_direct_page(uintptr_t pa);
 
+/**
+ * Map a single page back into the direct map, must be done before
+ * freeing a page that was allocated with vmm_alloc
+ *
+ * @param pa    [IN] the physical page to map
+ */
+err_t vmm_remap_direct_page(uintptr_t pa);
+
 typedef enum map_perm {
     /**
      * Map the page as writable
@@ -92,7 +100,19 @@ typedef enum map_perm {
      * While mapping the physical memory remove it from the direct
      * memory map.
      */
-    MAP_UNMAP_DIRECT = (1 << 2)
+    MAP_UNMAP_DIRECT = (1 << 2),
+
+    /*
+     * The memory type of the mapping, the value is the index of the type in
+     * the PAT we program, so it translates directly to the PAT/PCD/PWT bits.
+     * Write-back is the default so normal memory doesn't need to specify it.
+     */
+    MAP_CACHE_WB = (0 << 3),
+    MAP_CACHE_WT = (1 << 3),
+    MAP_CACHE_UC_MINUS = (2 << 3),
+    MAP_CACHE_UC = (3 << 3),
+    MAP_CACHE_WC = (4 << 3),
+    MAP_CACHE_MASK = (7 << 3),
 } map_perm_t;
 
 /**
@@ -141,6 +161,21 @@ err_t vmm_alloc(void* va, size_t page_count, map_perm_t perms);
  */
 void vmm_unmap(void* va, size_t page_count, uintptr_t* phys);
 
+/**
+ * Flush the TLB of all the cpus and wait until they are done, needed before
+ * reusing physical pages that were unmapped with vmm_unmap.
+ *
+ * @remark
+ * Must be called from a thread with interrupts enabled and no spinlocks held,
+ * since the other cpus must be able to take the IPI
+ */
+void vmm_tlb_shootdown();
+
+/**
+ * Called on the IRQ_TLB_SHOOTDOWN IPI
+ */
+void vmm_on_tlb_shootdown();
+
 /**
  * Checks if the given address is mapped
  */
@@ -0,0 +1,60 @@
+#include "card_table.h"
+
+err_t card_table_commit(uintptr_t ptr, size_t size) {
+    err_t err = NO_ERROR;
+
+    uintptr_t start = ALIGN_DOWN((uintptr_t)card_table_get_card(ptr), PAGE_SIZE);
+    uintptr_t end = ALIGN_UP((uintptr_t)card_table_get_card(ptr + size - 1) + 1, PAGE_SIZE);
+    for (uintptr_t page = start; page < end; page += PAGE_SIZE) {
+        if (!vmm_is_mapped(page)) {
+            CHECK_AND_RETHROW(vmm_alloc((void*)page, 1, MAP_WRITE));
+        }
+    }
+
+cleanup:
+    return err;
+}
+
+void card_table_mark_range(uintptr_t ptr, size_t size) {
+    ASSERT((ptr % (CARD_SIZE * 8)) == 0);
+    ASSERT((size % (CARD_SIZE * 8)) == 0);
+
+    // go 8 cards at a time
+    _Atomic(uint64_t)* cards = (_Atomic(uint64_t)*)card_table_get_card(ptr);
+    for (size_t i = 0; i < (size >> CARD_SHIFT) / sizeof(uint64_t); i++) {
+        atomic_store_explicit(&cards[i], CARD_DIRTY * 0x0101010101010101ull, memory_order_relaxed);
+    }
+}
+
+bool card_table_test_and_clear(uintptr_t ptr, size_t size) {
+    size_t count = size >> CARD_SHIFT;
+    bool dirty = false;
+
+    ASSERT(count != 0);
+    ASSERT((ptr % CARD_SIZE) == 0);
+
+    if ((count % sizeof(uint64_t)) == 0) {
+        // the common case, go a word at a time
+        _Atomic(uint64_t)* cards = (_Atomic(uint64_t)*)card_table_get_card(ptr);
+        for (size_t i = 0; i < count / sizeof(uint64_t); i++) {
+            if (atomic_load_explicit(&cards[i], memory_order_relaxed) != 0) {
+                atomic_exchange_explicit(&cards[i], 0, memory_order_relaxed);
+                dirty = true;
+            }
+        }
+    } else {
+        _Atomic(uint8_t)* cards = card_table_get_card(ptr);
+        for (size_t i = 0; i < count; i++) {
+            if (atomic_load_explicit(&cards[i], memory_order_relaxed) != CARD_CLEAN) {
+                atomic_exchange_explicit(&cards[i], CARD_CLEAN, memory_order_relaxed);
+                dirty = true;
+            }
+        }
+    }
+
+    // the cards must be clean before anyone looks at the objects, so a
+    // write that happens during the scan will mark the card again
+    atomic_thread_fence(memory_order_seq_cst);
+
+    return dirty;
+}
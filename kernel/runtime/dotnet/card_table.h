@@ -0,0 +1,72 @@
+#pragma once
+
+#include <util/except.h>
+#include <mem/mem.h>
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+//
+// The card table tracks writes of references into the object heap, every 512 bytes
+// of the heap have a single byte in the table which is set whenever a reference is
+// written into that range. The concurrent gc uses it to find the objects it needs
+// to rescan, the hardware dirty bits of the heap pages are folded into it before
+// every scan (see heap.c).
+//
+
+#define CARD_SHIFT      9
+#define CARD_SIZE       (1ull << CARD_SHIFT)
+
+#define CARD_CLEAN      0
+#define CARD_DIRTY      1
+
+/**
+ * Get the card of the given heap address
+ */
+static inline _Atomic(uint8_t)* card_table_get_card(uintptr_t ptr) {
+    return (_Atomic(uint8_t)*)(CARD_TABLE_START + ((ptr - OBJECT_HEAP_START) >> CARD_SHIFT));
+}
+
+/**
+ * The write barrier, must be called after a reference was written to the given
+ * address, the address does not need to be inside of the object heap.
+ *
+ * The card is only written if it is clean, so hot objects won't keep bouncing
+ * the card line between cpus.
+ */
+static inline void card_table_mark(void* ptr) {
+    if (OBJECT_HEAP_START <= (uintptr_t)ptr && (uintptr_t)ptr < OBJECT_HEAP_END) {
+        _Atomic(uint8_t)* card = card_table_get_card((uintptr_t)ptr);
+        if (atomic_load_explicit(card, memory_order_relaxed) == CARD_CLEAN) {
+            atomic_store_explicit(card, CARD_DIRTY, memory_order_relaxed);
+        }
+    }
+}
+
+/**
+ * Mark all the cards of the given heap range as dirty, the range must be aligned
+ * to 8 cards
+ *
+ * @param ptr   [IN] The start of the heap range
+ * @param size  [IN] The size of the range
+ */
+void card_table_mark_range(uintptr_t ptr, size_t size);
+
+/**
+ * Make sure the cards of the given heap range are committed, must be
+ * called before the heap range is mapped
+ *
+ * @param ptr   [IN] The start of the heap range
+ * @param size  [IN] The size of the range
+ */
+err_t card_table_commit(uintptr_t ptr, size_t size);
+
+/**
+ * Clear the cards of the given heap range, returns true if any of the
+ * cards was dirty. The range must be aligned to a card.
+ *
+ * @param ptr   [IN] The start of the heap range
+ * @param size  [IN] The size of the range
+ */
+bool card_table_test_and_clear(uintptr_t ptr, size_t size);
@@ -2,6 +2,13 @@
 
 #include <dotnet/gc/gc.h>
 
+#include <runtime/dotnet/heap_stats.h>
+#include <runtime/dotnet/card_table.h>
+#include <runtime/dotnet/monitor.h>
+
+#include <thread/work_pool.h>
+#include <thread/scheduler.h>
+#include <time/tsc.h>
 #include <thread/cpu_local.h>
 #include <thread/thread.h>
 #include <arch/intrin.h>
@@ -50,11 +57,28 @@
 // per object size pool we are going to have N regions, where the N is (512 / CpuCount),
 // each core is not going to lock by itself
 //
+// objects of up to 512 bytes are first bump allocated from a per-cpu region, which is the
+// start of the last subpool of the lock range that matches the cpu id, so the cpu is not
+// going to contend with anyone on it, the rest of the allocator skips these subpools. This
+// is only an allocation fast path, the objects are collected like any other object.
+//
+// dirty objects are tracked with a software card table (see card_table.h), the cards of a
+// range are committed before the range can have objects, and are cleared when it is freed.
+// Not every reference store goes through a barrier that marks the cards yet, so before the
+// cards are scanned the hardware dirty bits of the heap pages are cleared and every page
+// that was dirty has all of its cards marked. A single TLB shootdown after that makes sure
+// no cpu keeps a cached dirty entry that would let its next store skip the dirty bit.
+//
+// the walks that don't call back into the collector (folding the dirty bits, reclaiming
+// free memory and counting the stats) run on all the cpus through the gc workers, one heap
+// unit at a time. The walks that call the collector for every object stay on the calling
+// thread, since the collector callbacks are not safe to run concurrently.
+//
 
 /**
  * The amount of top-level pools we have
  */
-#define POOL_COUNT 26
+#define POOL_COUNT HEAP_POOL_COUNT
 
 /**
  * The amount of subpools we have over each object size pool
@@ -66,11 +90,121 @@
  */
 #define SUBPOOLS_PER_LOCK (512 / get_cpu_count())
 
+/**
+ * How many locks each top-level pool has
+ */
+#define LOCKS_PER_POOL ((SUBPOOLS_COUNT + SUBPOOLS_PER_LOCK - 1) / SUBPOOLS_PER_LOCK)
+
 /**
  * Locks, cpu_count per top-level pool
  */
 static spinlock_t* m_heap_locks;
 
+/**
+ * Get the lock of the given subpool
+ */
+static spinlock_t* get_heap_lock(int pool_idx, int subpool_idx) {
+    return &m_heap_locks[pool_idx * LOCKS_PER_POOL + subpool_idx / SUBPOOLS_PER_LOCK];
+}
+
+/**
+ * The amount of heap units, each unit is the range of subpools protected
+ * by a single lock, and is the unit of work when walking the heap in parallel
+ */
+#define HEAP_UNIT_COUNT (POOL_COUNT * LOCKS_PER_POOL)
+
+typedef struct heap_unit {
+    int pool_idx;
+    int first_subpool;
+    int last_subpool;
+} heap_unit_t;
+
+static heap_unit_t get_heap_unit(size_t lock_idx) {
+    int first_subpool = (lock_idx % LOCKS_PER_POOL) * SUBPOOLS_PER_LOCK;
+    return (heap_unit_t){
+        .pool_idx = lock_idx / LOCKS_PER_POOL,
+        .first_subpool = first_subpool,
+        .last_subpool = MIN(first_subpool + SUBPOOLS_PER_LOCK, SUBPOOLS_COUNT),
+    };
+}
+
+typedef struct heap_walk {
+    object_callback_t callback;
+} heap_walk_t;
+
+/**
+ * The pools that have a bump region, up to 512 byte objects
+ */
+#define BUMP_POOL_COUNT 6
+
+/**
+ * The size of each bump region, the bump pointer wraps around inside of it
+ * so a cpu never commits more than this per pool for its bump allocations
+ */
+#define BUMP_REGION_SIZE SIZE_2MB
+
+/**
+ * How many slots the bump allocator will skip over before giving up,
+ * this is a page worth of the smallest objects
+ */
+#define BUMP_SCAN_LIMIT (SIZE_4KB / 16)
+
+/**
+ * The next slot to try in each of the bump regions of the cpu
+ */
+static uintptr_t CPU_LOCAL m_bump_next[BUMP_POOL_COUNT];
+
+/**
+ * Get the subpool that holds the bump region of the given cpu
+ */
+static int get_bump_subpool(int cpu_id) {
+    return cpu_id * SUBPOOLS_PER_LOCK + SUBPOOLS_PER_LOCK - 1;
+}
+
+static bool is_bump_subpool(int subpool_idx) {
+    return (subpool_idx % SUBPOOLS_PER_LOCK) == SUBPOOLS_PER_LOCK - 1 &&
+            (subpool_idx / SUBPOOLS_PER_LOCK) < get_cpu_count();
+}
+
+/**
+ * The workers used for walking the heap in parallel, on a single cpu
+ * there are no workers and the caller does all of the work
+ */
+static work_pool_t* m_heap_work_pool = NULL;
+
+/**
+ * Allocation counters, kept per-cpu so the allocation path
+ * does not need to share a cache line
+ */
+static uint64_t CPU_LOCAL m_heap_allocations = 0;
+static uint64_t CPU_LOCAL m_heap_bump_allocations = 0;
+
+/**
+ * The amount of bytes returned to the physical allocator
+ */
+static atomic_size_t m_heap_reclaimed_bytes = 0;
+
+/**
+ * Protects the collection timing stats
+ */
+static spinlock_t m_heap_stats_lock = INIT_SPINLOCK();
+static heap_time_stats_t m_heap_pause_stats = { 0 };
+static heap_time_stats_t m_heap_phase_stats[HEAP_GC_PHASE_MAX] = { 0 };
+
+/**
+ * The collection in progress, the heap sees a collection as the walks the collector
+ * does over it, the dirty object scans are the mark, the object walks are the sweep,
+ * and the reclaim ends the collection
+ */
+static uint64_t m_heap_cycle_phase_us[HEAP_GC_PHASE_MAX] = { 0 };
+static uint64_t m_heap_cycle_pause_us = 0;
+
+/**
+ * When the collector stopped the world, only the collector
+ * stops the world so this needs no lock
+ */
+static uint64_t m_heap_pause_start = 0;
+
 err_t init_heap() {
     err_t err = NO_ERROR;
 
@@ -78,8 +212,14 @@ err_t init_heap() {
     CHECK(get_cpu_count() < 512);
 
     // allocate all the locks
-    m_heap_locks = malloc(POOL_COUNT * SUBPOOLS_PER_LOCK * sizeof(spinlock_t));
+    m_heap_locks = malloc(POOL_COUNT * LOCKS_PER_POOL * sizeof(spinlock_t));
     CHECK(m_heap_locks != NULL);
+    memset(m_heap_locks, 0, POOL_COUNT * LOCKS_PER_POOL * sizeof(spinlock_t));
+
+    // the workers for walking the heap, on a single cpu this
+    // will have no workers and all the work is done inline
+    m_heap_work_pool = create_work_pool(get_cpu_count() - 1, "gc/worker");
+    CHECK_ERROR(m_heap_work_pool != NULL, ERROR_OUT_OF_MEMORY);
 
     // setup the top levels
     for (pml_index_t pml4i = PML4_INDEX(OBJECT_HEAP_START); pml4i < PML4_INDEX(OBJECT_HEAP_START) + POOL_COUNT; pml4i++) {
@@ -146,6 +286,110 @@ System_Object heap_find_fast(void* ptr) {
     return NULL;
 }
 
+/**
+ * Make sure the page of a bump region slot is mapped, must be called with the lock
+ * of the region held
+ */
+static bool bump_map_page(uintptr_t ptr) {
+    pml_index_t pml2i = PML2_INDEX(ptr);
+    if (!PAGE_TABLE_PML2[pml2i].present) {
+        if (IS_ERROR(card_table_commit(PML2_BASE(pml2i), SIZE_2MB))) {
+            WARN("heap: out of memory allocating cards for bump region");
+            return false;
+        }
+
+        if (!vmm_setup_level(PAGE_TABLE_PML2, PAGE_TABLE_PML1, pml2i)) {
+            WARN("heap: out of memory trying to setup PML2 for bump region");
+            return false;
+        }
+    }
+
+    pml_index_t pml1i = PML1_INDEX(ptr);
+    if (!PAGE_TABLE_PML1[pml1i].present) {
+        void* page = palloc(SIZE_4KB);
+        if (page == NULL) {
+            WARN("heap: out of memory allocating bump region page");
+            return false;
+        }
+
+        // setup the page table entry
+        PAGE_TABLE_PML1[pml1i] = (page_entry_t){
+            .present = 1,
+            .writeable = 1,
+            .frame = DIRECT_TO_PHYS(page) >> 12
+        };
+
+        // unmap the physical page
+        vmm_unmap_direct_page(DIRECT_TO_PHYS(page));
+    }
+
+    return true;
+}
+
+/**
+ * Bump allocate from the region of the current cpu, the pointer wraps around the
+ * region skipping over slots that are still alive, returns NULL if there was no
+ * free slot close enough
+ */
+static System_Object bump_alloc(int pool_idx, size_t aligned_size, size_t size, int color) {
+    System_Object allocated = NULL;
+
+    // we must stay on the same cpu while we use the region
+    scheduler_preempt_disable();
+
+    int subpool_idx = get_bump_subpool(get_cpu_id());
+    pml_index_t pml3i = ((PML4_INDEX(OBJECT_HEAP_START) + pool_idx) << 9) + subpool_idx;
+    uintptr_t base = PML3_BASE(pml3i);
+
+    // the lock is only contended with the collector
+    spinlock_t* lock = get_heap_lock(pool_idx, subpool_idx);
+    spinlock_lock(lock);
+
+    if (!PAGE_TABLE_PML3[pml3i].present) {
+        if (!vmm_setup_level(PAGE_TABLE_PML3, PAGE_TABLE_PML2, pml3i)) {
+            WARN("heap: out of memory trying to setup bump region");
+            goto cleanup;
+        }
+    }
+
+    uintptr_t next = m_bump_next[pool_idx];
+    if (next == 0) {
+        next = base;
+    }
+
+    for (int i = 0; i < BUMP_SCAN_LIMIT; i++) {
+        uintptr_t ptr = next;
+        next += aligned_size;
+        if (next == base + BUMP_REGION_SIZE) {
+            next = base;
+        }
+
+        // the page might have been reclaimed since we last used it
+        if (!bump_map_page(ptr)) {
+            break;
+        }
+
+        System_Object object = (System_Object)ptr;
+        if (object->color == COLOR_BLUE) {
+            memset(object, 0, size);
+            monitor_reset(object);
+            object->color = color;
+            allocated = object;
+            m_heap_bump_allocations++;
+            m_heap_allocations++;
+            break;
+        }
+    }
+
+    m_bump_next[pool_idx] = next;
+
+cleanup:
+    spinlock_unlock(lock);
+    scheduler_preempt_enable();
+
+    return allocated;
+}
+
 System_Object heap_alloc(size_t size, int color) {
     // check if we support this allocation
     if (size > SIZE_512MB) {
@@ -160,6 +404,14 @@ System_Object heap_alloc(size_t size, int color) {
     // now get the pool index from the size by using log2
     int pool_idx = (64 - __builtin_clzll(aligned_size - 1)) - 4;
 
+    // small objects come from the bump region first
+    if (pool_idx < BUMP_POOL_COUNT) {
+        System_Object object = bump_alloc(pool_idx, aligned_size, size, color);
+        if (object != NULL) {
+            return object;
+        }
+    }
+
     // the last taken lock, for easier lock management
     spinlock_t* last_lock_taken = NULL;
 
@@ -183,7 +435,7 @@ System_Object heap_alloc(size_t size, int color) {
             }
 
             // now take a new lock
-            last_lock_taken = &m_heap_locks[pool_idx * POOL_COUNT + subpool_idx / SUBPOOLS_PER_LOCK];
+            last_lock_taken = get_heap_lock(pool_idx, subpool_idx);
 
             if (!spinlock_try_lock(last_lock_taken)) {
                 // we didn't lock it
@@ -197,6 +449,11 @@ System_Object heap_alloc(size_t size, int color) {
             }
         }
 
+        // leave the bump regions to their cpus
+        if (pool_idx < BUMP_POOL_COUNT && is_bump_subpool(subpool_idx)) {
+            continue;
+        }
+
         if (!PAGE_TABLE_PML3[pml3i].present) {
             // allocate this
             if (!vmm_setup_level(PAGE_TABLE_PML3, PAGE_TABLE_PML2, pml3i)) {
@@ -214,6 +471,12 @@ System_Object heap_alloc(size_t size, int color) {
                 pml_index_t pml2i = PML2_INDEX(ptr);
 
                 if (!PAGE_TABLE_PML2[PML2_INDEX(ptr)].present) {
+                    // make sure the object has cards
+                    if (IS_ERROR(card_table_commit(ptr, aligned_size))) {
+                        WARN("heap: out of memory allocating cards for %S object", aligned_size);
+                        continue;
+                    }
+
                     // allocate the whole object
 
                     bool allocated_it = true;
@@ -265,6 +528,12 @@ System_Object heap_alloc(size_t size, int color) {
             // so iterate it
             for (pml_index_t pml2i = pml3i << 9; pml2i < (pml3i << 9) + 512; pml2i++) {
                 if (!PAGE_TABLE_PML2[pml2i].present) {
+                    // make sure the range has cards before it can have objects
+                    if (IS_ERROR(card_table_commit(PML2_BASE(pml2i), SIZE_2MB))) {
+                        WARN("heap: out of memory allocating cards for 4KB pools");
+                        continue;
+                    }
+
                     if (!vmm_setup_level(PAGE_TABLE_PML2, PAGE_TABLE_PML1, pml2i)) {
                         WARN("heap: out of memory trying to setup PML2 for 4KB pools");
                         continue;
@@ -361,7 +630,9 @@ exit:
     // set the color of the allocation
     if (allocated != NULL) {
         memset(allocated, 0, size);
+        monitor_reset(allocated);
         allocated->color = color;
+        m_heap_allocations++;
     }
 
     // if we still have a taken lock then free it now
@@ -400,6 +671,7 @@ static void heap_free_pml(page_entry_t* pml, pml_index_t index, size_t page_size
 
         // remove the current mapping
         pml[index + i] = (page_entry_t){ 0 };
+        atomic_fetch_add_explicit(&m_heap_reclaimed_bytes, page_size, memory_order_relaxed);
 
         // invalidate the page from the heap
         // TODO: invalidate on other cores
@@ -413,277 +685,575 @@ static void heap_free_pml(page_entry_t* pml, pml_index_t index, size_t page_size
     }
 }
 
-void heap_reclaim() {
-    spinlock_t* last_lock_taken = NULL;
+/**
+ * Reclaim the free memory of all the subpools protected by a single lock
+ */
+static void reclaim_heap_unit(void* ctx, size_t lock_idx) {
+    heap_unit_t unit = get_heap_unit(lock_idx);
 
-    // iterate over all the top-level pools, each having 512 sub-pools
-    for (int pool_idx = 0; pool_idx < POOL_COUNT; pool_idx++) {
-        pml_index_t pml4i = pool_idx + PML4_INDEX(OBJECT_HEAP_START);
-        size_t pool_object_size = 2 << (3 + pool_idx);
-
-        // go over each 1GB region in the pool, making sure that each of the pools
-        // actually exists
-        for (int subpool_idx = 0; subpool_idx < SUBPOOLS_COUNT; subpool_idx++) {
-            pml_index_t pml3i = (pml4i << 9) + subpool_idx;
-
-            // we got to the first pool in the subpool region, lock the region
-            if ((subpool_idx % SUBPOOLS_PER_LOCK) == 0) {
-                // unlock the last lock taken
-                if (last_lock_taken != NULL) {
-                    spinlock_unlock(last_lock_taken);
+    pml_index_t pml4i = unit.pool_idx + PML4_INDEX(OBJECT_HEAP_START);
+    size_t pool_object_size = 2 << (3 + unit.pool_idx);
+
+    spinlock_t* lock = &m_heap_locks[lock_idx];
+    spinlock_lock(lock);
+
+    for (int subpool_idx = unit.first_subpool; subpool_idx < unit.last_subpool; subpool_idx++) {
+        pml_index_t pml3i = (pml4i << 9) + subpool_idx;
+
+        if (!PAGE_TABLE_PML3[pml3i].present) continue;
+
+        bool can_remove_pml3 = true;
+        if (pool_object_size >= SIZE_2MB) {
+            // the objects are larger than 2MB, so we can skip at the object size and simply check
+            // the PML2 per object to check if it is present
+            for (uintptr_t ptr = PML3_BASE(pml3i); ptr < PML3_BASE(pml3i) + SIZE_1GB; ptr += pool_object_size) {
+                pml_index_t pml2i = PML2_INDEX(ptr);
+                if (!PAGE_TABLE_PML2[pml2i].present) continue;
+
+                // check if the object is free
+                System_Object object = (System_Object) ptr;
+                if (object->color != COLOR_BLUE) {
+                    can_remove_pml3 = false;
+                    continue;
                 }
 
-                // now take a new lock
-                last_lock_taken = &m_heap_locks[pool_idx * POOL_COUNT + subpool_idx / SUBPOOLS_PER_LOCK];
-                spinlock_lock(last_lock_taken);
+                // we can free all the memory it takes, the cards must be clean
+                // in case the memory is going to be reused
+                card_table_test_and_clear(ptr, pool_object_size);
+                heap_free_pml(PAGE_TABLE_PML2, pml2i, SIZE_2MB, pool_object_size, true);
             }
+        } else {
+            // the objects are smaller than 2MB, meaning each PML2 has multiple objects,
+            // so iterate it
+            for (pml_index_t pml2i = pml3i << 9; pml2i < (pml3i << 9) + 512; pml2i++) {
+                if (!PAGE_TABLE_PML2[pml2i].present) continue;
 
-            if (!PAGE_TABLE_PML3[pml3i].present) continue;
+                int can_remove_pml2 = true;
+                if (pool_object_size >= SIZE_4KB) {
+                    // the objects are larger than 4KB, so we can skip at the object size
+                    // and simply check the PML1 per object to check if it is present
+                    for (uintptr_t ptr = PML2_BASE(pml2i); ptr < PML2_BASE(pml2i) + SIZE_2MB; ptr += pool_object_size) {
+                        pml_index_t pml1i = PML1_INDEX(ptr);
+                        if (!PAGE_TABLE_PML1[pml1i].present) continue;
 
-            bool can_remove_pml3 = true;
-            if (pool_object_size >= SIZE_2MB) {
-                // the objects are larger than 2MB, so we can skip at the object size and simply check
-                // the PML2 per object to check if it is present
-                for (uintptr_t ptr = PML3_BASE(pml3i); ptr < PML3_BASE(pml3i) + SIZE_1GB; ptr += pool_object_size) {
-                    pml_index_t pml2i = PML2_INDEX(ptr);
-                    if (!PAGE_TABLE_PML2[pml2i].present) continue;
-
-                    // check if the object is free
-                    System_Object object = (System_Object) ptr;
-                    if (object->color != COLOR_BLUE) {
-                        can_remove_pml3 = false;
-                        continue;
+                        // check if the object is free
+                        System_Object object = (System_Object) ptr;
+                        if (object->color != COLOR_BLUE) {
+                            can_remove_pml2 = false;
+                            can_remove_pml3 = false;
+                            continue;
+                        }
+
+                        // we can free all the memory it takes
+                        card_table_test_and_clear(ptr, pool_object_size);
+                        heap_free_pml(PAGE_TABLE_PML1, pml1i, PAGE_SIZE, pool_object_size, true);
                     }
+                } else {
+                    // the objects are smaller than 4KB, meaning each PML1 has multiple
+                    // objects, so iterate it
+                    for (pml_index_t pml1i = pml2i << 9; pml1i < (pml2i << 9) + 512; pml1i++) {
+                        if (!PAGE_TABLE_PML1[pml1i].present) continue;
 
-                    // we can free all the memory it takes
-                    heap_free_pml(PAGE_TABLE_PML2, pml2i, SIZE_2MB, pool_object_size, true);
-                }
-            } else {
-                // the objects are smaller than 2MB, meaning each PML2 has multiple objects,
-                // so iterate it
-                for (pml_index_t pml2i = pml3i << 9; pml2i < (pml3i << 9) + 512; pml2i++) {
-                    if (!PAGE_TABLE_PML2[pml2i].present) continue;
-
-                    int can_remove_pml2 = true;
-                    if (pool_object_size >= SIZE_4KB) {
-                        // the objects are larger than 4KB, so we can skip at the object size
-                        // and simply check the PML1 per object to check if it is present
-                        for (uintptr_t ptr = PML2_BASE(pml2i); ptr < PML2_BASE(pml2i) + SIZE_2MB; ptr += pool_object_size) {
-                            pml_index_t pml1i = PML1_INDEX(ptr);
-                            if (!PAGE_TABLE_PML1[pml1i].present) continue;
-
-                            // check if the object is free
+                        // iterate all the objects and check if the pool is empty completely
+                        bool can_remove_pml1 = true;
+                        for (uintptr_t ptr = PML1_BASE(pml1i); ptr < PML1_BASE(pml1i) + SIZE_4KB; ptr += pool_object_size) {
                             System_Object object = (System_Object) ptr;
                             if (object->color != COLOR_BLUE) {
+                                can_remove_pml1 = false;
                                 can_remove_pml2 = false;
                                 can_remove_pml3 = false;
-                                continue;
                             }
-
-                            // we can free all the memory it takes
-                            heap_free_pml(PAGE_TABLE_PML1, pml1i, PAGE_SIZE, pool_object_size, true);
                         }
-                    } else {
-                        // the objects are smaller than 4KB, meaning each PML1 has multiple
-                        // objects, so iterate it
-                        for (pml_index_t pml1i = pml2i << 9; pml1i < (pml2i << 9) + 512; pml1i++) {
-                            if (!PAGE_TABLE_PML1[pml1i].present) continue;
-
-                            // iterate all the objects and check if the pool is empty completely
-                            bool can_remove_pml1 = true;
-                            for (uintptr_t ptr = PML1_BASE(pml1i); ptr < PML1_BASE(pml1i) + SIZE_4KB; ptr += pool_object_size) {
-                                System_Object object = (System_Object) ptr;
-                                if (object->color != COLOR_BLUE) {
-                                    can_remove_pml1 = false;
-                                    can_remove_pml2 = false;
-                                    can_remove_pml3 = false;
-                                }
-                            }
 
-                            // no items, free it
-                            if (can_remove_pml1) {
-                                heap_free_pml(PAGE_TABLE_PML1, pml1i, PAGE_SIZE, PAGE_SIZE, true);
-                            }
+                        // no items, free it
+                        if (can_remove_pml1) {
+                            card_table_test_and_clear(PML1_BASE(pml1i), PAGE_SIZE);
+                            heap_free_pml(PAGE_TABLE_PML1, pml1i, PAGE_SIZE, PAGE_SIZE, true);
                         }
                     }
+                }
 
-                    if (can_remove_pml2) {
-                        // we can remove the top-level entry, which is a single page
-                        heap_free_pml(PAGE_TABLE_PML2, pml2i, PAGE_SIZE, PAGE_SIZE, false);
-                    }
+                if (can_remove_pml2) {
+                    // we can remove the top-level entry, which is a single page
+                    heap_free_pml(PAGE_TABLE_PML2, pml2i, PAGE_SIZE, PAGE_SIZE, false);
                 }
             }
+        }
+
+        if (can_remove_pml3) {
+            // we can remove the top-level entry, which is a single page
+            heap_free_pml(PAGE_TABLE_PML3, pml3i, PAGE_SIZE, PAGE_SIZE, false);
+        }
+    }
+
+    spinlock_unlock(lock);
+}
+
+void heap_reclaim() {
+    uint64_t start = microtime();
+    work_pool_parallel_for(m_heap_work_pool, HEAP_UNIT_COUNT, reclaim_heap_unit, NULL);
+    heap_stats_record_phase(HEAP_GC_PHASE_RECLAIM, microtime() - start);
+    heap_stats_finish_collection();
+}
+
+/**
+ * The dirty bit of a page entry
+ */
+#define PAGE_ENTRY_DIRTY (1ull << 6)
+
+/**
+ * Clear the hardware dirty bit of a heap page and mark all of its cards if it was set,
+ * returns true if it was set. The TLB must be flushed on all cpus before the cards
+ * are scanned.
+ */
+static bool page_fold_dirty(page_entry_t* entry, uintptr_t page, size_t page_size) {
+    if (!entry->dirty) return false;
+    atomic_fetch_and_explicit((_Atomic(uint64_t)*)entry, ~PAGE_ENTRY_DIRTY, memory_order_relaxed);
+    card_table_mark_range(page, page_size);
+    return true;
+}
+
+/**
+ * Fold the dirty bits of all the pages of the subpools protected by a single lock
+ * into the cards, the context is a bool that is set if any page was dirty
+ */
+static void fold_unit_dirty_pages(void* ctx, size_t lock_idx) {
+    atomic_bool* folded = ctx;
+    heap_unit_t unit = get_heap_unit(lock_idx);
+
+    pml_index_t pml4i = unit.pool_idx + PML4_INDEX(OBJECT_HEAP_START);
+    size_t pool_object_size = 2 << (3 + unit.pool_idx);
+    bool dirty = false;
 
-            if (can_remove_pml3) {
-                // we can remove the top-level entry, which is a single page
-                heap_free_pml(PAGE_TABLE_PML3, pml3i, PAGE_SIZE, PAGE_SIZE, false);
+    spinlock_t* lock = &m_heap_locks[lock_idx];
+    spinlock_lock(lock);
+
+    for (int subpool_idx = unit.first_subpool; subpool_idx < unit.last_subpool; subpool_idx++) {
+        pml_index_t pml3i = (pml4i << 9) + subpool_idx;
+        if (!PAGE_TABLE_PML3[pml3i].present) continue;
+
+        for (pml_index_t pml2i = pml3i << 9; pml2i < (pml3i << 9) + 512; pml2i++) {
+            if (!PAGE_TABLE_PML2[pml2i].present) continue;
+
+            if (pool_object_size >= SIZE_2MB) {
+                // mapped with 2MB pages
+                dirty |= page_fold_dirty(&PAGE_TABLE_PML2[pml2i], PML2_BASE(pml2i), SIZE_2MB);
+            } else {
+                for (pml_index_t pml1i = pml2i << 9; pml1i < (pml2i << 9) + 512; pml1i++) {
+                    if (!PAGE_TABLE_PML1[pml1i].present) continue;
+                    dirty |= page_fold_dirty(&PAGE_TABLE_PML1[pml1i], PML1_BASE(pml1i), SIZE_4KB);
+                }
             }
         }
     }
 
-    // if we still have a taken lock then free it now
-    if (last_lock_taken != NULL) {
-        spinlock_unlock(last_lock_taken);
+    spinlock_unlock(lock);
+
+    if (dirty) {
+        atomic_store_explicit(folded, true, memory_order_relaxed);
     }
 }
 
-void heap_iterate_dirty_objects(object_callback_t callback) {
-    spinlock_t* last_lock_taken = NULL;
+/**
+ * Fold the dirty bits of the whole heap into the cards, and flush the TLBs once if any
+ * bit was cleared, a cpu that still has the entry cached as dirty would not set the
+ * bit on its next store. A store made before the flush is caught by the marked cards.
+ */
+static void fold_dirty_pages() {
+    atomic_bool folded = false;
+    work_pool_parallel_for(m_heap_work_pool, HEAP_UNIT_COUNT, fold_unit_dirty_pages, &folded);
 
-    // iterate over all the top-level pools, each having 512 sub-pools
-    for (int pool_idx = 0; pool_idx < POOL_COUNT; pool_idx++) {
-        pml_index_t pml4i = pool_idx + PML4_INDEX(OBJECT_HEAP_START);
-        size_t pool_object_size = 2 << (3 + pool_idx);
-
-        // go over each 1GB region in the pool, making sure that each of the pools
-        // actually exists
-        for (int subpool_idx = 0; subpool_idx < SUBPOOLS_COUNT; subpool_idx++) {
-            pml_index_t pml3i = (pml4i << 9) + subpool_idx;
-
-            // we got to the first pool in the subpool region, lock the region
-            if ((subpool_idx % SUBPOOLS_PER_LOCK) == 0) {
-                // unlock the last lock taken
-                if (last_lock_taken != NULL) {
-                    spinlock_unlock(last_lock_taken);
-                }
+    // outside of the heap locks, the shootdown waits for all the other cpus
+    if (atomic_load_explicit(&folded, memory_order_relaxed)) {
+        vmm_tlb_shootdown();
+    }
+}
 
-                // now take a new lock
-                last_lock_taken = &m_heap_locks[pool_idx * POOL_COUNT + subpool_idx / SUBPOOLS_PER_LOCK];
-                spinlock_lock(last_lock_taken);
+/**
+ * Scan a 2MB range of a pool with objects smaller than 2MB, calling the callback
+ * on every object that has a dirty card
+ */
+static void scan_range_cards(uintptr_t range, size_t object_size, object_callback_t callback) {
+    if (object_size >= SIZE_4KB) {
+        // multiple cards and pages per object
+        for (uintptr_t obj = range; obj < range + SIZE_2MB; obj += object_size) {
+            if (!PAGE_TABLE_PML1[PML1_INDEX(obj)].present) continue;
+
+            if (card_table_test_and_clear(obj, object_size) && callback != NULL) {
+                callback((System_Object)obj);
             }
+        }
+        return;
+    }
 
-            // if it is not present skip
-            if (!PAGE_TABLE_PML3[pml3i].present) continue;
+    // multiple objects per page
+    for (uintptr_t page = range; page < range + SIZE_2MB; page += SIZE_4KB) {
+        if (!PAGE_TABLE_PML1[PML1_INDEX(page)].present) continue;
+
+        if (object_size <= CARD_SIZE) {
+            // multiple objects per card, a page is exactly 8 cards so
+            // we can check and clear all of them at once
+            STATIC_ASSERT(SIZE_4KB == CARD_SIZE * 8);
+            _Atomic(uint64_t)* cards = (_Atomic(uint64_t)*)card_table_get_card(page);
+            uint64_t dirty = 0;
+            if (atomic_load_explicit(cards, memory_order_relaxed) != 0) {
+                dirty = atomic_exchange_explicit(cards, 0, memory_order_seq_cst);
+            }
 
-            // iterate all the 2mb ranges in the pool
-            for (pml_index_t pml2i = pml3i << 9; pml2i < (pml3i << 9) + 512; pml2i++) {
-                if (!PAGE_TABLE_PML2[pml2i].present) continue;
+            if (callback == NULL || dirty == 0) continue;
 
-                if (pool_object_size >= SIZE_2MB) {
-                    // for 2MB+ objects we only have up to PML2, so we can start doing
-                    // the iteration here
+            for (int i = 0; i < 8; i++) {
+                if (((dirty >> (i * 8)) & 0xFF) == CARD_CLEAN) continue;
 
-                    // if not dirty continue
-                    if (!PAGE_TABLE_PML2[pml2i].dirty) {
-                        continue;
-                    }
+                uintptr_t card = page + i * CARD_SIZE;
+                for (uintptr_t obj = card; obj < card + CARD_SIZE; obj += object_size) {
+                    callback((System_Object)obj);
+                }
+            }
+        } else {
+            // multiple cards per object
+            for (uintptr_t obj = page; obj < page + SIZE_4KB; obj += object_size) {
+                if (card_table_test_and_clear(obj, object_size) && callback != NULL) {
+                    callback((System_Object)obj);
+                }
+            }
+        }
+    }
+}
 
-                    // iterate the objects in the card if we have a callback
-                    if (callback != NULL) {
-                        // get the object base and iterate it until the pool end
-                        uintptr_t object_base = ALIGN_DOWN(PML2_BASE(pml2i), pool_object_size);
-                        for (uintptr_t obj = object_base; obj < PML2_BASE(pml2i + 1); obj += pool_object_size) {
-                            System_Object object = (System_Object)obj;
-                            callback(object);
-                        }
-                    }
+/**
+ * Scan the cards of all the subpools that are protected by a single lock
+ */
+static void scan_lock_cards(void* ctx, size_t lock_idx) {
+    heap_walk_t* walk = ctx;
+    heap_unit_t unit = get_heap_unit(lock_idx);
 
-                    // clear the dirty bit, must be done after we touch
-                    // all the objects
-                    PAGE_TABLE_PML1[pml2i].dirty = 0;
-                } else {
-                    // iterate all the PML1s of the 2MB pages
-                    for (pml_index_t pml1i = pml2i << 9; pml1i < (pml2i << 9) + 512; pml1i++) {
-                        if (!PAGE_TABLE_PML1[pml1i].present) continue;
+    pml_index_t pml4i = unit.pool_idx + PML4_INDEX(OBJECT_HEAP_START);
+    size_t pool_object_size = 2 << (3 + unit.pool_idx);
 
-                        // if not dirty continue
-                        if (!PAGE_TABLE_PML1[pml1i].dirty) {
-                            continue;
-                        }
+    spinlock_t* lock = &m_heap_locks[lock_idx];
+    spinlock_lock(lock);
 
-                        // iterate the objects in the card if we have a callback
-                        if (callback != NULL) {
-                            // get the object base and iterate it until the pool end
-                            uintptr_t object_base = ALIGN_DOWN(PML1_BASE(pml1i), pool_object_size);
-                            for (uintptr_t obj = object_base; obj < PML1_BASE(pml1i + 1); obj += pool_object_size) {
-                                System_Object object = (System_Object)obj;
-                                callback(object);
-                            }
-                        }
+    for (int subpool_idx = unit.first_subpool; subpool_idx < unit.last_subpool; subpool_idx++) {
+        pml_index_t pml3i = (pml4i << 9) + subpool_idx;
+
+        // if it is not present skip
+        if (!PAGE_TABLE_PML3[pml3i].present) continue;
+
+        if (pool_object_size >= SIZE_2MB) {
+            // the objects span whole 2MB pages, check all the cards of the object
+            for (uintptr_t obj = PML3_BASE(pml3i); obj < PML3_BASE(pml3i) + SIZE_1GB; obj += pool_object_size) {
+                if (!PAGE_TABLE_PML2[PML2_INDEX(obj)].present) continue;
+
+                if (card_table_test_and_clear(obj, pool_object_size) && walk->callback != NULL) {
+                    walk->callback((System_Object)obj);
+                }
+            }
+        } else {
+            // iterate all the 2mb ranges in the pool
+            for (pml_index_t pml2i = pml3i << 9; pml2i < (pml3i << 9) + 512; pml2i++) {
+                if (!PAGE_TABLE_PML2[pml2i].present) continue;
+                scan_range_cards(PML2_BASE(pml2i), pool_object_size, walk->callback);
+            }
+        }
+    }
+
+    spinlock_unlock(lock);
+}
 
-                        // clear the dirty bit, must be done after we touch
-                        // all the objects
-                        PAGE_TABLE_PML1[pml1i].dirty = 0;
+void heap_iterate_dirty_objects(object_callback_t callback) {
+    uint64_t start = microtime();
+    fold_dirty_pages();
+    heap_walk_t walk = { .callback = callback };
+    for (int lock_idx = 0; lock_idx < HEAP_UNIT_COUNT; lock_idx++) {
+        scan_lock_cards(&walk, lock_idx);
+    }
+    heap_stats_record_phase(HEAP_GC_PHASE_MARK, microtime() - start);
+}
+
+/**
+ * Iterate the objects of a single subpool, must be called with the lock held
+ */
+static void iterate_subpool(pml_index_t pml3i, size_t pool_object_size, object_callback_t callback) {
+    if (!PAGE_TABLE_PML3[pml3i].present) return;
+
+    if (pool_object_size >= SIZE_2MB) {
+        // the objects are larger than 2MB, so we can skip at the object size and simply check
+        // the PML2 per object to check if it is present
+        for (uintptr_t ptr = PML3_BASE(pml3i); ptr < PML3_BASE(pml3i) + SIZE_1GB; ptr += pool_object_size) {
+            if (!PAGE_TABLE_PML2[PML2_INDEX(ptr)].present) continue;
+            callback((System_Object)ptr);
+        }
+    } else {
+        // the objects are smaller than 2MB, meaning each PML2 has multiple objects,
+        // so iterate it
+        for (pml_index_t pml2i = pml3i << 9; pml2i < (pml3i << 9) + 512; pml2i++) {
+            if (!PAGE_TABLE_PML2[pml2i].present) continue;
+
+            if (pool_object_size >= SIZE_4KB) {
+                // the objects are larger than 4KB, so we can skip at the object size
+                // and simply check the PML1 per object to check if it is present
+                for (uintptr_t ptr = PML2_BASE(pml2i); ptr < PML2_BASE(pml2i) + SIZE_2MB; ptr += pool_object_size) {
+                    if (!PAGE_TABLE_PML1[PML1_INDEX(ptr)].present) continue;
+                    callback((System_Object)ptr);
+                }
+            } else {
+                // the objects are smaller than 4KB, meaning each PML1 has multiple
+                // objects, so iterate it
+                for (pml_index_t pml1i = pml2i << 9; pml1i < (pml2i << 9) + 512; pml1i++) {
+                    if (!PAGE_TABLE_PML1[pml1i].present) continue;
+
+                    // just iterate all of them
+                    for (uintptr_t ptr = PML1_BASE(pml1i); ptr < PML1_BASE(pml1i) + SIZE_4KB; ptr += pool_object_size) {
+                        callback((System_Object)ptr);
                     }
                 }
             }
         }
     }
+}
 
-    // if we still have a taken lock then free it now
-    if (last_lock_taken != NULL) {
-        spinlock_unlock(last_lock_taken);
+/**
+ * Iterate the objects of all the subpools protected by a single lock
+ */
+static void iterate_heap_unit(void* ctx, size_t lock_idx) {
+    object_callback_t callback = ((heap_walk_t*)ctx)->callback;
+    heap_unit_t unit = get_heap_unit(lock_idx);
+
+    pml_index_t pml4i = unit.pool_idx + PML4_INDEX(OBJECT_HEAP_START);
+    size_t pool_object_size = 2 << (3 + unit.pool_idx);
+
+    spinlock_t* lock = &m_heap_locks[lock_idx];
+    spinlock_lock(lock);
+
+    for (int subpool_idx = unit.first_subpool; subpool_idx < unit.last_subpool; subpool_idx++) {
+        iterate_subpool((pml4i << 9) + subpool_idx, pool_object_size, callback);
+    }
+
+    spinlock_unlock(lock);
+}
+
+/**
+ * Walk all the objects without counting it as a collection phase
+ */
+static void iterate_objects(object_callback_t callback) {
+    heap_walk_t walk = { .callback = callback };
+    for (int lock_idx = 0; lock_idx < HEAP_UNIT_COUNT; lock_idx++) {
+        iterate_heap_unit(&walk, lock_idx);
     }
 }
 
 void heap_iterate_objects(object_callback_t callback) {
-    spinlock_t* last_lock_taken = NULL;
+    uint64_t start = microtime();
+    iterate_objects(callback);
+    heap_stats_record_phase(HEAP_GC_PHASE_SWEEP, microtime() - start);
+}
 
-    // iterate over all the top-level pools, each having 512 sub-pools
-    for (int pool_idx = 0; pool_idx < POOL_COUNT; pool_idx++) {
-        pml_index_t pml4i = pool_idx + PML4_INDEX(OBJECT_HEAP_START);
-        size_t pool_object_size = 2 << (3 + pool_idx);
-
-        // go over each 1GB region in the pool, making sure that each of the pools
-        // actually exists
-        for (int subpool_idx = 0; subpool_idx < SUBPOOLS_COUNT; subpool_idx++) {
-            pml_index_t pml3i = (pml4i << 9) + subpool_idx;
-
-            // we got to the first pool in the subpool region, lock the region
-            if ((subpool_idx % SUBPOOLS_PER_LOCK) == 0) {
-                // unlock the last lock taken
-                if (last_lock_taken != NULL) {
-                    spinlock_unlock(last_lock_taken);
-                }
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Stats
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
-                // now take a new lock
-                last_lock_taken = &m_heap_locks[pool_idx * POOL_COUNT + subpool_idx / SUBPOOLS_PER_LOCK];
-                spinlock_lock(last_lock_taken);
-            }
+/**
+ * Count the slots of a committed range of a pool
+ */
+static void count_range(uintptr_t base, size_t size, size_t object_size, heap_pool_stats_t* stats) {
+    stats->committed_bytes += size;
+    for (uintptr_t ptr = base; ptr < base + size; ptr += object_size) {
+        if (((System_Object)ptr)->color == COLOR_BLUE) {
+            stats->free_objects++;
+        } else {
+            stats->live_objects++;
+        }
+    }
+}
 
-            if (!PAGE_TABLE_PML3[pml3i].present) continue;
+/**
+ * Count the slots of a single subpool, must be called with the lock held
+ */
+static void count_subpool(pml_index_t pml3i, size_t pool_object_size, heap_pool_stats_t* stats) {
+    if (!PAGE_TABLE_PML3[pml3i].present) return;
 
-            if (pool_object_size >= SIZE_2MB) {
-                // the objects are larger than 2MB, so we can skip at the object size and simply check
-                // the PML2 per object to check if it is present
-                for (uintptr_t ptr = PML3_BASE(pml3i); ptr < PML3_BASE(pml3i) + SIZE_1GB; ptr += pool_object_size) {
-                    if (!PAGE_TABLE_PML2[PML2_INDEX(ptr)].present) continue;
-                    callback((System_Object)ptr);
+    if (pool_object_size >= SIZE_2MB) {
+        for (uintptr_t ptr = PML3_BASE(pml3i); ptr < PML3_BASE(pml3i) + SIZE_1GB; ptr += pool_object_size) {
+            if (!PAGE_TABLE_PML2[PML2_INDEX(ptr)].present) continue;
+            count_range(ptr, pool_object_size, pool_object_size, stats);
+        }
+    } else {
+        for (pml_index_t pml2i = pml3i << 9; pml2i < (pml3i << 9) + 512; pml2i++) {
+            if (!PAGE_TABLE_PML2[pml2i].present) continue;
+
+            if (pool_object_size >= SIZE_4KB) {
+                for (uintptr_t ptr = PML2_BASE(pml2i); ptr < PML2_BASE(pml2i) + SIZE_2MB; ptr += pool_object_size) {
+                    if (!PAGE_TABLE_PML1[PML1_INDEX(ptr)].present) continue;
+                    count_range(ptr, pool_object_size, pool_object_size, stats);
                 }
             } else {
-                // the objects are smaller than 2MB, meaning each PML2 has multiple objects,
-                // so iterate it
-                for (pml_index_t pml2i = pml3i << 9; pml2i < (pml3i << 9) + 512; pml2i++) {
-                    if (!PAGE_TABLE_PML2[pml2i].present) continue;
-
-                    if (pool_object_size >= SIZE_4KB) {
-                        // the objects are larger than 4KB, so we can skip at the object size
-                        // and simply check the PML1 per object to check if it is present
-                        for (uintptr_t ptr = PML2_BASE(pml2i); ptr < PML2_BASE(pml2i) + SIZE_2MB; ptr += pool_object_size) {
-                            if (!PAGE_TABLE_PML1[PML1_INDEX(ptr)].present) continue;
-                            callback((System_Object)ptr);
-                        }
-                    } else {
-                        // the objects are smaller than 4KB, meaning each PML1 has multiple
-                        // objects, so iterate it
-                        for (pml_index_t pml1i = pml2i << 9; pml1i < (pml2i << 9) + 512; pml1i++) {
-                            if (!PAGE_TABLE_PML1[pml1i].present) continue;
-
-                            // just iterate all of them
-                            for (uintptr_t ptr = PML1_BASE(pml1i); ptr < PML1_BASE(pml1i) + SIZE_4KB; ptr += pool_object_size) {
-                                callback((System_Object)ptr);
-                            }
-                        }
-                    }
+                for (pml_index_t pml1i = pml2i << 9; pml1i < (pml2i << 9) + 512; pml1i++) {
+                    if (!PAGE_TABLE_PML1[pml1i].present) continue;
+                    count_range(PML1_BASE(pml1i), SIZE_4KB, pool_object_size, stats);
                 }
             }
         }
     }
+}
 
-    // if we still have a taken lock then free it now
-    if (last_lock_taken != NULL) {
-        spinlock_unlock(last_lock_taken);
+typedef struct heap_count {
+    spinlock_t lock;
+    heap_pool_stats_t* pools;
+    int first_pool;
+} heap_count_t;
+
+/**
+ * Count the slots of all the subpools protected by a single lock, the result is
+ * added to the pool stats at the end so the shared lock is only taken once
+ */
+static void count_heap_unit(void* ctx, size_t lock_idx) {
+    heap_count_t* count = ctx;
+    heap_unit_t unit = get_heap_unit(lock_idx);
+
+    pml_index_t pml4i = unit.pool_idx + PML4_INDEX(OBJECT_HEAP_START);
+    size_t pool_object_size = 2 << (3 + unit.pool_idx);
+    heap_pool_stats_t stats = { 0 };
+
+    spinlock_t* lock = &m_heap_locks[lock_idx];
+    spinlock_lock(lock);
+    for (int subpool_idx = unit.first_subpool; subpool_idx < unit.last_subpool; subpool_idx++) {
+        count_subpool((pml4i << 9) + subpool_idx, pool_object_size, &stats);
     }
+    spinlock_unlock(lock);
+
+    spinlock_lock(&count->lock);
+    heap_pool_stats_t* pool = &count->pools[unit.pool_idx - count->first_pool];
+    pool->live_objects += stats.live_objects;
+    pool->free_objects += stats.free_objects;
+    pool->committed_bytes += stats.committed_bytes;
+    spinlock_unlock(&count->lock);
+}
+
+void heap_get_pool_stats(int pool_idx, heap_pool_stats_t* stats) {
+    ASSERT(0 <= pool_idx && pool_idx < POOL_COUNT);
+
+    memset(stats, 0, sizeof(*stats));
+    stats->object_size = 2 << (3 + pool_idx);
+
+    heap_count_t count = { .lock = INIT_SPINLOCK(), .pools = stats, .first_pool = pool_idx };
+    for (int lock_idx = pool_idx * LOCKS_PER_POOL; lock_idx < (pool_idx + 1) * LOCKS_PER_POOL; lock_idx++) {
+        count_heap_unit(&count, lock_idx);
+    }
+}
+
+void heap_get_stats(heap_stats_t* stats) {
+    memset(stats, 0, sizeof(*stats));
+
+    // walk the whole heap
+    for (int pool_idx = 0; pool_idx < POOL_COUNT; pool_idx++) {
+        stats->pools[pool_idx].object_size = 2 << (3 + pool_idx);
+    }
+    heap_count_t count = { .lock = INIT_SPINLOCK(), .pools = stats->pools };
+    work_pool_parallel_for(m_heap_work_pool, HEAP_UNIT_COUNT, count_heap_unit, &count);
+
+    for (int pool_idx = 0; pool_idx < POOL_COUNT; pool_idx++) {
+        heap_pool_stats_t* pool = &stats->pools[pool_idx];
+        stats->committed_bytes += pool->committed_bytes;
+        stats->used_bytes += pool->live_objects * pool->object_size;
+        stats->live_objects += pool->live_objects;
+    }
+
+    // sum the per-cpu counters
+    for (int cpu = 0; cpu < get_cpu_count(); cpu++) {
+        stats->allocations += *(uint64_t*)get_cpu_base(cpu, &m_heap_allocations);
+        stats->bump_allocations += *(uint64_t*)get_cpu_base(cpu, &m_heap_bump_allocations);
+    }
+    stats->reclaimed_bytes = atomic_load_explicit(&m_heap_reclaimed_bytes, memory_order_relaxed);
+
+    spinlock_lock(&m_heap_stats_lock);
+    stats->pause = m_heap_pause_stats;
+    memcpy(stats->phases, m_heap_phase_stats, sizeof(m_heap_phase_stats));
+    spinlock_unlock(&m_heap_stats_lock);
+}
+
+static void record_time(heap_time_stats_t* stats, uint64_t duration_us) {
+    spinlock_lock(&m_heap_stats_lock);
+    stats->count++;
+    stats->last_us = duration_us;
+    stats->max_us = MAX(stats->max_us, duration_us);
+    stats->total_us += duration_us;
+    spinlock_unlock(&m_heap_stats_lock);
+}
+
+void heap_stats_record_phase(heap_gc_phase_t phase, uint64_t duration_us) {
+    ASSERT(phase < HEAP_GC_PHASE_MAX);
+    spinlock_lock(&m_heap_stats_lock);
+    m_heap_cycle_phase_us[phase] += duration_us;
+    spinlock_unlock(&m_heap_stats_lock);
+}
+
+void heap_stats_begin_pause() {
+    m_heap_pause_start = microtime();
+}
+
+void heap_stats_end_pause() {
+    uint64_t pause_us = microtime() - m_heap_pause_start;
+    spinlock_lock(&m_heap_stats_lock);
+    m_heap_cycle_pause_us += pause_us;
+    spinlock_unlock(&m_heap_stats_lock);
+}
+
+void heap_stats_finish_collection() {
+    uint64_t phases[HEAP_GC_PHASE_MAX];
+
+    spinlock_lock(&m_heap_stats_lock);
+    memcpy(phases, m_heap_cycle_phase_us, sizeof(phases));
+    memset(m_heap_cycle_phase_us, 0, sizeof(m_heap_cycle_phase_us));
+    uint64_t pause_us = m_heap_cycle_pause_us;
+    m_heap_cycle_pause_us = 0;
+    spinlock_unlock(&m_heap_stats_lock);
+
+    for (int phase = 0; phase < HEAP_GC_PHASE_MAX; phase++) {
+        record_time(&m_heap_phase_stats[phase], phases[phase]);
+    }
+    record_time(&m_heap_pause_stats, pause_us);
+}
+
+static const char* m_phase_str[] = {
+    [HEAP_GC_PHASE_MARK] = "mark",
+    [HEAP_GC_PHASE_SWEEP] = "sweep",
+    [HEAP_GC_PHASE_RECLAIM] = "reclaim",
+};
+
+static void dump_time_stats(const char* name, heap_time_stats_t* stats) {
+    if (stats->count == 0) return;
+    TRACE("\t%s: %lu times, last %luus, max %luus, avg %luus",
+          name, stats->count, stats->last_us, stats->max_us, stats->total_us / stats->count);
+}
+
+void heap_dump_stats() {
+    heap_stats_t* stats = malloc(sizeof(heap_stats_t));
+    if (stats == NULL) {
+        WARN("heap: out of memory for stats");
+        return;
+    }
+    heap_get_stats(stats);
+
+    TRACE("Object heap stats:");
+    TRACE("\t%S committed, %S used, %lu live objects",
+          stats->committed_bytes, stats->used_bytes, stats->live_objects);
+    TRACE("\t%lu allocations (%lu bump allocated), %S reclaimed",
+          stats->allocations, stats->bump_allocations, stats->reclaimed_bytes);
+
+    for (int pool_idx = 0; pool_idx < POOL_COUNT; pool_idx++) {
+        heap_pool_stats_t* pool = &stats->pools[pool_idx];
+        if (pool->committed_bytes == 0) continue;
+        TRACE("\t\t%S objects: %lu live, %lu free, %S committed",
+              pool->object_size, pool->live_objects, pool->free_objects, pool->committed_bytes);
+    }
+
+    dump_time_stats("pause", &stats->pause);
+    for (int phase = 0; phase < HEAP_GC_PHASE_MAX; phase++) {
+        dump_time_stats(m_phase_str[phase], &stats->phases[phase]);
+    }
+
+    free(stats);
 }
 
 static const char* m_color_str[] = {
@@ -753,5 +1323,5 @@ static void heap_dump_callback(System_Object object) {
 
 void heap_dump() {
     TRACE("Object heap:");
-    heap_iterate_objects(heap_dump_callback);
+    iterate_objects(heap_dump_callback);
 }
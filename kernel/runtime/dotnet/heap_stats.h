@@ -0,0 +1,93 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+
+/**
+ * The amount of object size pools in the heap
+ */
+#define HEAP_POOL_COUNT 26
+
+typedef enum heap_gc_phase {
+    HEAP_GC_PHASE_MARK,
+    HEAP_GC_PHASE_SWEEP,
+    HEAP_GC_PHASE_RECLAIM,
+    HEAP_GC_PHASE_MAX
+} heap_gc_phase_t;
+
+typedef struct heap_pool_stats {
+    uint64_t object_size;
+    uint64_t live_objects;
+    uint64_t free_objects;
+    uint64_t committed_bytes;
+} heap_pool_stats_t;
+
+typedef struct heap_time_stats {
+    uint64_t count;
+    uint64_t last_us;
+    uint64_t max_us;
+    uint64_t total_us;
+} heap_time_stats_t;
+
+typedef struct heap_stats {
+    // walked from the heap itself
+    uint64_t committed_bytes;
+    uint64_t used_bytes;
+    uint64_t live_objects;
+
+    // counters since boot
+    uint64_t allocations;
+    uint64_t bump_allocations;
+    uint64_t reclaimed_bytes;
+
+    // the count of the pause is the amount of collections, and each
+    // pause is the time the world was stopped in a collection
+    heap_time_stats_t pause;
+    heap_time_stats_t phases[HEAP_GC_PHASE_MAX];
+
+    heap_pool_stats_t pools[HEAP_POOL_COUNT];
+} heap_stats_t;
+
+/**
+ * Collect the stats of the whole heap, this walks all the objects
+ * of the heap (in parallel) so it should not be called often
+ *
+ * @param stats     [OUT] The stats
+ */
+void heap_get_stats(heap_stats_t* stats);
+
+/**
+ * Collect the stats of a single pool
+ *
+ * @param pool_idx  [IN] The pool, 0 being the 16 byte objects
+ * @param stats     [OUT] The stats
+ */
+void heap_get_pool_stats(int pool_idx, heap_pool_stats_t* stats);
+
+/**
+ * Add time spent in a phase of the current collection, a phase
+ * can run multiple times in a single collection
+ */
+void heap_stats_record_phase(heap_gc_phase_t phase, uint64_t duration_us);
+
+/**
+ * Called by the collector right before it suspends all the threads
+ */
+void heap_stats_begin_pause();
+
+/**
+ * Called by the collector once it resumed all the threads, the time since
+ * heap_stats_begin_pause is added to the pause of the current collection
+ */
+void heap_stats_end_pause();
+
+/**
+ * Record the end of the current collection, called once the
+ * collector reclaimed the memory of the freed objects
+ */
+void heap_stats_finish_collection();
+
+/**
+ * Print a compact summary of the heap, a line per pool that has memory
+ */
+void heap_dump_stats();
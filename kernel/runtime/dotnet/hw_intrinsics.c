@@ -0,0 +1,356 @@
+#include "hw_intrinsics.h"
+
+#include <arch/cpuid.h>
+#include <util/string.h>
+#include <util/defs.h>
+
+#include <stdint.h>
+
+typedef char i8x16 __attribute__((vector_size(16)));
+typedef uint8_t u8x16 __attribute__((vector_size(16)));
+typedef int8_t s8x16 __attribute__((vector_size(16)));
+typedef uint16_t u16x8 __attribute__((vector_size(16)));
+typedef int16_t s16x8 __attribute__((vector_size(16)));
+typedef uint32_t u32x4 __attribute__((vector_size(16)));
+typedef int32_t s32x4 __attribute__((vector_size(16)));
+typedef uint64_t u64x2 __attribute__((vector_size(16)));
+typedef int64_t s64x2 __attribute__((vector_size(16)));
+typedef long long v2di __attribute__((vector_size(16)));
+typedef float f32x4 __attribute__((vector_size(16)));
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Supported instruction sets
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+typedef enum hw_isa {
+    HW_ISA_X86BASE,
+    HW_ISA_SSE,
+    HW_ISA_SSE2,
+    HW_ISA_SSSE3,
+    HW_ISA_SSE41,
+    HW_ISA_SSE42,
+    HW_ISA_POPCNT,
+    HW_ISA_LZCNT,
+    HW_ISA_BMI1,
+    HW_ISA_BMI2,
+    HW_ISA_MAX
+} hw_isa_t;
+
+static struct {
+    const char* name;
+    bool supported;
+} m_hw_isas[HW_ISA_MAX] = {
+    [HW_ISA_X86BASE] = { "X86Base", true },
+    [HW_ISA_SSE] = { "Sse" },
+    [HW_ISA_SSE2] = { "Sse2" },
+    [HW_ISA_SSSE3] = { "Ssse3" },
+    [HW_ISA_SSE41] = { "Sse41" },
+    [HW_ISA_SSE42] = { "Sse42" },
+    [HW_ISA_POPCNT] = { "Popcnt" },
+    [HW_ISA_LZCNT] = { "Lzcnt" },
+    [HW_ISA_BMI1] = { "Bmi1" },
+    [HW_ISA_BMI2] = { "Bmi2" },
+};
+
+static void hw_detect_isas() {
+    uint32_t max_leaf = 0;
+    cpuid(0, &max_leaf, NULL, NULL, NULL);
+
+    cpuid_version_info_ecx_t ecx = { 0 };
+    cpuid_version_info_edx_t edx = { 0 };
+    cpuid(CPUID_VERSION_INFO, NULL, NULL, &ecx.packed, &edx.packed);
+
+    // the managed classes inherit each other, so a class is
+    // only supported if all of its parents are supported
+    m_hw_isas[HW_ISA_SSE].supported = edx.SSE;
+    m_hw_isas[HW_ISA_SSE2].supported = m_hw_isas[HW_ISA_SSE].supported && edx.SSE2;
+    m_hw_isas[HW_ISA_SSSE3].supported = m_hw_isas[HW_ISA_SSE2].supported && ecx.SSE3 && ecx.SSSE3;
+    m_hw_isas[HW_ISA_SSE41].supported = m_hw_isas[HW_ISA_SSSE3].supported && ecx.SSE4_1;
+    m_hw_isas[HW_ISA_SSE42].supported = m_hw_isas[HW_ISA_SSE41].supported && ecx.SSE4_2;
+    m_hw_isas[HW_ISA_POPCNT].supported = m_hw_isas[HW_ISA_SSE42].supported && ecx.POPCNT;
+
+    uint32_t max_extended_leaf = 0;
+    cpuid(CPUID_EXTENDED_FUNCTION, &max_extended_leaf, NULL, NULL, NULL);
+
+    if (max_extended_leaf >= CPUID_EXTENDED_CPU_SIG) {
+        cpuid_extended_cpu_sig_ecx_t ext_ecx = { 0 };
+        cpuid(CPUID_EXTENDED_CPU_SIG, NULL, NULL, &ext_ecx.packed, NULL);
+        m_hw_isas[HW_ISA_LZCNT].supported = ext_ecx.LZCNT;
+    }
+
+    if (max_leaf >= CPUID_STRUCTURED_EXTENDED_FEATURE_FLAGS) {
+        cpuid_structured_extended_feature_flags_ebx_t ebx = { 0 };
+        cpuidex(CPUID_STRUCTURED_EXTENDED_FEATURE_FLAGS, 0, NULL, &ebx.packed, NULL, NULL);
+        m_hw_isas[HW_ISA_BMI1].supported = ebx.BMI1;
+        m_hw_isas[HW_ISA_BMI2].supported = ebx.BMI2;
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Vector natives
+//
+// The kernel is built for skylake (without avx), so the compiler already picks the matching
+// instruction for the generic vector operations, the rest use the builtins directly.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#define HW_VECTOR_UNARY(name, type, expr) \
+    static void name(void* result, const void* value) { \
+        type a, r; \
+        __builtin_memcpy(&a, value, sizeof(a)); \
+        r = (type)(expr); \
+        __builtin_memcpy(result, &r, sizeof(r)); \
+    }
+
+#define HW_VECTOR_BINARY(name, type, expr) \
+    static void name(void* result, const void* left, const void* right) { \
+        type a, b, r; \
+        __builtin_memcpy(&a, left, sizeof(a)); \
+        __builtin_memcpy(&b, right, sizeof(b)); \
+        r = (type)(expr); \
+        __builtin_memcpy(result, &r, sizeof(r)); \
+    }
+
+/**
+ * x86 shifts by a register give zero (or the sign) once the count is as
+ * large as the element, while in C that is undefined
+ */
+#define HW_VECTOR_SHIFT(name, type, bits, expr, overflow) \
+    static void name(void* result, const void* value, uint8_t count) { \
+        type a, r; \
+        __builtin_memcpy(&a, value, sizeof(a)); \
+        r = count >= (bits) ? (type)(overflow) : (type)(expr); \
+        __builtin_memcpy(result, &r, sizeof(r)); \
+    }
+
+/**
+ * Take the elements of a where the mask is set and of b otherwise, the
+ * compiler turns this into a min/max or a blend
+ */
+#define HW_SELECT(mask, a, b) (((mask) & (a)) | (~(mask) & (b)))
+
+// Sse
+HW_VECTOR_BINARY(hw_sse_add, f32x4, a + b)
+HW_VECTOR_BINARY(hw_sse_subtract, f32x4, a - b)
+HW_VECTOR_BINARY(hw_sse_multiply, f32x4, a * b)
+HW_VECTOR_BINARY(hw_sse_divide, f32x4, a / b)
+HW_VECTOR_BINARY(hw_sse_min, f32x4, HW_SELECT((s32x4)(a < b), (s32x4)a, (s32x4)b))
+HW_VECTOR_BINARY(hw_sse_max, f32x4, HW_SELECT((s32x4)(a > b), (s32x4)a, (s32x4)b))
+HW_VECTOR_UNARY(hw_sse_sqrt, f32x4, __builtin_ia32_sqrtps(a))
+
+// Sse2
+HW_VECTOR_BINARY(hw_sse2_add8, u8x16, a + b)
+HW_VECTOR_BINARY(hw_sse2_add16, u16x8, a + b)
+HW_VECTOR_BINARY(hw_sse2_add32, u32x4, a + b)
+HW_VECTOR_BINARY(hw_sse2_add64, u64x2, a + b)
+HW_VECTOR_BINARY(hw_sse2_subtract8, u8x16, a - b)
+HW_VECTOR_BINARY(hw_sse2_subtract16, u16x8, a - b)
+HW_VECTOR_BINARY(hw_sse2_subtract32, u32x4, a - b)
+HW_VECTOR_BINARY(hw_sse2_subtract64, u64x2, a - b)
+HW_VECTOR_BINARY(hw_sse2_and, u64x2, a & b)
+HW_VECTOR_BINARY(hw_sse2_or, u64x2, a | b)
+HW_VECTOR_BINARY(hw_sse2_xor, u64x2, a ^ b)
+HW_VECTOR_BINARY(hw_sse2_and_not, u64x2, ~a & b)
+HW_VECTOR_BINARY(hw_sse2_compare_equal8, u8x16, a == b)
+HW_VECTOR_BINARY(hw_sse2_compare_equal16, u16x8, a == b)
+HW_VECTOR_BINARY(hw_sse2_compare_equal32, u32x4, a == b)
+HW_VECTOR_BINARY(hw_sse2_compare_greater_than8, s8x16, a > b)
+HW_VECTOR_BINARY(hw_sse2_compare_greater_than16, s16x8, a > b)
+HW_VECTOR_BINARY(hw_sse2_compare_greater_than32, s32x4, a > b)
+HW_VECTOR_BINARY(hw_sse2_sum_absolute_differences, u8x16, __builtin_ia32_psadbw128((i8x16)a, (i8x16)b))
+HW_VECTOR_SHIFT(hw_sse2_shift_left_logical16, u16x8, 16, a << count, (u16x8){})
+HW_VECTOR_SHIFT(hw_sse2_shift_left_logical32, u32x4, 32, a << count, (u32x4){})
+HW_VECTOR_SHIFT(hw_sse2_shift_left_logical64, u64x2, 64, a << count, (u64x2){})
+HW_VECTOR_SHIFT(hw_sse2_shift_right_logical16, u16x8, 16, a >> count, (u16x8){})
+HW_VECTOR_SHIFT(hw_sse2_shift_right_logical32, u32x4, 32, a >> count, (u32x4){})
+HW_VECTOR_SHIFT(hw_sse2_shift_right_logical64, u64x2, 64, a >> count, (u64x2){})
+HW_VECTOR_SHIFT(hw_sse2_shift_right_arithmetic16, s16x8, 16, a >> count, a >> 15)
+HW_VECTOR_SHIFT(hw_sse2_shift_right_arithmetic32, s32x4, 32, a >> count, a >> 31)
+
+static int32_t hw_sse2_move_mask8(const void* value) {
+    u8x16 a;
+    __builtin_memcpy(&a, value, sizeof(a));
+    return __builtin_ia32_pmovmskb128((i8x16)a);
+}
+
+// Ssse3
+HW_VECTOR_BINARY(hw_ssse3_shuffle8, u8x16, __builtin_ia32_pshufb128((i8x16)a, (i8x16)b))
+HW_VECTOR_UNARY(hw_ssse3_abs8, s8x16, HW_SELECT(a < 0, -a, a))
+HW_VECTOR_UNARY(hw_ssse3_abs16, s16x8, HW_SELECT(a < 0, -a, a))
+HW_VECTOR_UNARY(hw_ssse3_abs32, s32x4, HW_SELECT(a < 0, -a, a))
+HW_VECTOR_BINARY(hw_ssse3_horizontal_add16, s16x8, __builtin_ia32_phaddw128(a, b))
+HW_VECTOR_BINARY(hw_ssse3_horizontal_add32, s32x4, __builtin_ia32_phaddd128(a, b))
+
+// Sse41
+HW_VECTOR_BINARY(hw_sse41_min_int8, s8x16, HW_SELECT(a < b, a, b))
+HW_VECTOR_BINARY(hw_sse41_max_int8, s8x16, HW_SELECT(a > b, a, b))
+HW_VECTOR_BINARY(hw_sse41_min_uint16, u16x8, HW_SELECT((u16x8)(a < b), a, b))
+HW_VECTOR_BINARY(hw_sse41_max_uint16, u16x8, HW_SELECT((u16x8)(a > b), a, b))
+HW_VECTOR_BINARY(hw_sse41_min_int32, s32x4, HW_SELECT(a < b, a, b))
+HW_VECTOR_BINARY(hw_sse41_max_int32, s32x4, HW_SELECT(a > b, a, b))
+HW_VECTOR_BINARY(hw_sse41_min_uint32, u32x4, HW_SELECT((u32x4)(a < b), a, b))
+HW_VECTOR_BINARY(hw_sse41_max_uint32, u32x4, HW_SELECT((u32x4)(a > b), a, b))
+HW_VECTOR_BINARY(hw_sse41_compare_equal64, u64x2, a == b)
+HW_VECTOR_BINARY(hw_sse41_multiply_low32, u32x4, a * b)
+
+static bool hw_sse41_test_z(const void* left, const void* right) {
+    v2di a, b;
+    __builtin_memcpy(&a, left, sizeof(a));
+    __builtin_memcpy(&b, right, sizeof(b));
+    return __builtin_ia32_ptestz128(a, b);
+}
+
+// Sse42
+HW_VECTOR_BINARY(hw_sse42_compare_greater_than64, s64x2, a > b)
+
+static uint32_t hw_sse42_crc32_8(uint32_t crc, uint8_t data) { return __builtin_ia32_crc32qi(crc, data); }
+static uint32_t hw_sse42_crc32_16(uint32_t crc, uint16_t data) { return __builtin_ia32_crc32hi(crc, data); }
+static uint32_t hw_sse42_crc32_32(uint32_t crc, uint32_t data) { return __builtin_ia32_crc32si(crc, data); }
+static uint64_t hw_sse42_crc32_64(uint64_t crc, uint64_t data) { return __builtin_ia32_crc32di(crc, data); }
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Scalar natives
+//
+// The compiler turns the zero checks into a plain lzcnt/tzcnt, which already return
+// the width for zero. The Bmi1 operations which are plain arithmetic are emitted as
+// MIR by the jit instead.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+static uint32_t hw_popcnt_pop_count32(uint32_t value) { return __builtin_popcount(value); }
+static uint64_t hw_popcnt_pop_count64(uint64_t value) { return __builtin_popcountll(value); }
+static uint32_t hw_lzcnt_leading_zero_count32(uint32_t value) { return value != 0 ? __builtin_clz(value) : 32; }
+static uint64_t hw_lzcnt_leading_zero_count64(uint64_t value) { return value != 0 ? __builtin_clzll(value) : 64; }
+static uint32_t hw_bmi1_trailing_zero_count32(uint32_t value) { return value != 0 ? __builtin_ctz(value) : 32; }
+static uint64_t hw_bmi1_trailing_zero_count64(uint64_t value) { return value != 0 ? __builtin_ctzll(value) : 64; }
+static uint32_t hw_bmi2_zero_high_bits32(uint32_t value, uint32_t index) { return __builtin_ia32_bzhi_si(value, index); }
+static uint64_t hw_bmi2_zero_high_bits64(uint64_t value, uint64_t index) { return __builtin_ia32_bzhi_di(value, index); }
+static uint32_t hw_bmi2_parallel_bit_deposit32(uint32_t value, uint32_t mask) { return __builtin_ia32_pdep_si(value, mask); }
+static uint64_t hw_bmi2_parallel_bit_deposit64(uint64_t value, uint64_t mask) { return __builtin_ia32_pdep_di(value, mask); }
+static uint32_t hw_bmi2_parallel_bit_extract32(uint32_t value, uint32_t mask) { return __builtin_ia32_pext_si(value, mask); }
+static uint64_t hw_bmi2_parallel_bit_extract64(uint64_t value, uint64_t mask) { return __builtin_ia32_pext_di(value, mask); }
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// The table of internal calls
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#define HW_UNARY(isa, name, native) \
+    { isa, name, #native, native, MIR_T_UNDEF, 2, { MIR_T_P, MIR_T_P } }
+
+#define HW_BINARY(isa, name, native) \
+    { isa, name, #native, native, MIR_T_UNDEF, 3, { MIR_T_P, MIR_T_P, MIR_T_P } }
+
+#define HW_BINARY_INLINE(isa, name, native, lowering, code) \
+    { isa, name, #native, native, MIR_T_UNDEF, 3, { MIR_T_P, MIR_T_P, MIR_T_P }, lowering, code }
+
+#define HW_SHIFT(isa, name, native) \
+    { isa, name, #native, native, MIR_T_UNDEF, 3, { MIR_T_P, MIR_T_P, MIR_T_U8 } }
+
+#define HW_SCALAR(isa, name, native, result, nargs, ...) \
+    { isa, name, #native, native, result, nargs, { __VA_ARGS__ } }
+
+static hw_intrinsic_t m_hw_intrinsics[] = {
+    HW_BINARY("Sse", "AddSingle", hw_sse_add),
+    HW_BINARY("Sse", "SubtractSingle", hw_sse_subtract),
+    HW_BINARY("Sse", "MultiplySingle", hw_sse_multiply),
+    HW_BINARY("Sse", "DivideSingle", hw_sse_divide),
+    HW_BINARY("Sse", "MinSingle", hw_sse_min),
+    HW_BINARY("Sse", "MaxSingle", hw_sse_max),
+    HW_UNARY("Sse", "SqrtSingle", hw_sse_sqrt),
+
+    HW_BINARY("Sse2", "Add8", hw_sse2_add8),
+    HW_BINARY("Sse2", "Add16", hw_sse2_add16),
+    HW_BINARY("Sse2", "Add32", hw_sse2_add32),
+    HW_BINARY_INLINE("Sse2", "Add64", hw_sse2_add64, HW_LOWER_LANES64, MIR_ADD),
+    HW_BINARY("Sse2", "Subtract8", hw_sse2_subtract8),
+    HW_BINARY("Sse2", "Subtract16", hw_sse2_subtract16),
+    HW_BINARY("Sse2", "Subtract32", hw_sse2_subtract32),
+    HW_BINARY_INLINE("Sse2", "Subtract64", hw_sse2_subtract64, HW_LOWER_LANES64, MIR_SUB),
+    HW_BINARY_INLINE("Sse2", "AndVector", hw_sse2_and, HW_LOWER_LANES64, MIR_AND),
+    HW_BINARY_INLINE("Sse2", "OrVector", hw_sse2_or, HW_LOWER_LANES64, MIR_OR),
+    HW_BINARY_INLINE("Sse2", "XorVector", hw_sse2_xor, HW_LOWER_LANES64, MIR_XOR),
+    HW_BINARY_INLINE("Sse2", "AndNotVector", hw_sse2_and_not, HW_LOWER_AND_NOT, MIR_AND),
+    HW_BINARY("Sse2", "CompareEqual8", hw_sse2_compare_equal8),
+    HW_BINARY("Sse2", "CompareEqual16", hw_sse2_compare_equal16),
+    HW_BINARY("Sse2", "CompareEqual32", hw_sse2_compare_equal32),
+    HW_BINARY("Sse2", "CompareGreaterThan8", hw_sse2_compare_greater_than8),
+    HW_BINARY("Sse2", "CompareGreaterThan16", hw_sse2_compare_greater_than16),
+    HW_BINARY("Sse2", "CompareGreaterThan32", hw_sse2_compare_greater_than32),
+    HW_BINARY("Sse2", "SumAbsoluteDifferences8", hw_sse2_sum_absolute_differences),
+    HW_SHIFT("Sse2", "ShiftLeftLogical16", hw_sse2_shift_left_logical16),
+    HW_SHIFT("Sse2", "ShiftLeftLogical32", hw_sse2_shift_left_logical32),
+    HW_SHIFT("Sse2", "ShiftLeftLogical64", hw_sse2_shift_left_logical64),
+    HW_SHIFT("Sse2", "ShiftRightLogical16", hw_sse2_shift_right_logical16),
+    HW_SHIFT("Sse2", "ShiftRightLogical32", hw_sse2_shift_right_logical32),
+    HW_SHIFT("Sse2", "ShiftRightLogical64", hw_sse2_shift_right_logical64),
+    HW_SHIFT("Sse2", "ShiftRightArithmetic16", hw_sse2_shift_right_arithmetic16),
+    HW_SHIFT("Sse2", "ShiftRightArithmetic32", hw_sse2_shift_right_arithmetic32),
+    HW_SCALAR("Sse2", "MoveMask8", hw_sse2_move_mask8, MIR_T_I32, 1, MIR_T_P),
+
+    HW_BINARY("Ssse3", "Shuffle8", hw_ssse3_shuffle8),
+    HW_UNARY("Ssse3", "Abs8", hw_ssse3_abs8),
+    HW_UNARY("Ssse3", "Abs16", hw_ssse3_abs16),
+    HW_UNARY("Ssse3", "Abs32", hw_ssse3_abs32),
+    HW_BINARY("Ssse3", "HorizontalAdd16", hw_ssse3_horizontal_add16),
+    HW_BINARY("Ssse3", "HorizontalAdd32", hw_ssse3_horizontal_add32),
+
+    HW_BINARY("Sse41", "MinInt8", hw_sse41_min_int8),
+    HW_BINARY("Sse41", "MaxInt8", hw_sse41_max_int8),
+    HW_BINARY("Sse41", "MinUInt16", hw_sse41_min_uint16),
+    HW_BINARY("Sse41", "MaxUInt16", hw_sse41_max_uint16),
+    HW_BINARY("Sse41", "MinInt32", hw_sse41_min_int32),
+    HW_BINARY("Sse41", "MaxInt32", hw_sse41_max_int32),
+    HW_BINARY("Sse41", "MinUInt32", hw_sse41_min_uint32),
+    HW_BINARY("Sse41", "MaxUInt32", hw_sse41_max_uint32),
+    HW_BINARY_INLINE("Sse41", "CompareEqual64", hw_sse41_compare_equal64, HW_LOWER_COMPARE_EQUAL64, MIR_EQ),
+    HW_BINARY("Sse41", "MultiplyLow32", hw_sse41_multiply_low32),
+    { "Sse41", "TestZVector", "hw_sse41_test_z", hw_sse41_test_z, MIR_T_U8, 2, { MIR_T_P, MIR_T_P }, HW_LOWER_TEST_Z, MIR_AND },
+
+    HW_BINARY("Sse42", "CompareGreaterThan64", hw_sse42_compare_greater_than64),
+    HW_SCALAR("Sse42", "Crc32Byte", hw_sse42_crc32_8, MIR_T_U32, 2, MIR_T_U32, MIR_T_U8),
+    HW_SCALAR("Sse42", "Crc32UInt16", hw_sse42_crc32_16, MIR_T_U32, 2, MIR_T_U32, MIR_T_U16),
+    HW_SCALAR("Sse42", "Crc32UInt32", hw_sse42_crc32_32, MIR_T_U32, 2, MIR_T_U32, MIR_T_U32),
+    HW_SCALAR("Sse42", "Crc32UInt64", hw_sse42_crc32_64, MIR_T_U64, 2, MIR_T_U64, MIR_T_U64),
+
+    HW_SCALAR("Popcnt", "PopCount32", hw_popcnt_pop_count32, MIR_T_U32, 1, MIR_T_U32),
+    HW_SCALAR("Popcnt", "PopCount64", hw_popcnt_pop_count64, MIR_T_U64, 1, MIR_T_U64),
+
+    HW_SCALAR("Lzcnt", "LeadingZeroCount32", hw_lzcnt_leading_zero_count32, MIR_T_U32, 1, MIR_T_U32),
+    HW_SCALAR("Lzcnt", "LeadingZeroCount64", hw_lzcnt_leading_zero_count64, MIR_T_U64, 1, MIR_T_U64),
+
+    HW_SCALAR("Bmi1", "TrailingZeroCount32", hw_bmi1_trailing_zero_count32, MIR_T_U32, 1, MIR_T_U32),
+    HW_SCALAR("Bmi1", "TrailingZeroCount64", hw_bmi1_trailing_zero_count64, MIR_T_U64, 1, MIR_T_U64),
+
+    HW_SCALAR("Bmi2", "ZeroHighBits32", hw_bmi2_zero_high_bits32, MIR_T_U32, 2, MIR_T_U32, MIR_T_U32),
+    HW_SCALAR("Bmi2", "ZeroHighBits64", hw_bmi2_zero_high_bits64, MIR_T_U64, 2, MIR_T_U64, MIR_T_U64),
+    HW_SCALAR("Bmi2", "ParallelBitDeposit32", hw_bmi2_parallel_bit_deposit32, MIR_T_U32, 2, MIR_T_U32, MIR_T_U32),
+    HW_SCALAR("Bmi2", "ParallelBitDeposit64", hw_bmi2_parallel_bit_deposit64, MIR_T_U64, 2, MIR_T_U64, MIR_T_U64),
+    HW_SCALAR("Bmi2", "ParallelBitExtract32", hw_bmi2_parallel_bit_extract32, MIR_T_U32, 2, MIR_T_U32, MIR_T_U32),
+    HW_SCALAR("Bmi2", "ParallelBitExtract64", hw_bmi2_parallel_bit_extract64, MIR_T_U64, 2, MIR_T_U64, MIR_T_U64),
+};
+
+void init_hw_intrinsics(MIR_context_t ctx) {
+    hw_detect_isas();
+
+    for (int i = 0; i < ARRAY_LEN(m_hw_intrinsics); i++) {
+        MIR_load_external(ctx, m_hw_intrinsics[i].native_name, m_hw_intrinsics[i].native);
+    }
+}
+
+err_t hw_intrinsics_is_supported(System_String isa, bool* supported) {
+    for (int i = 0; i < ARRAY_LEN(m_hw_isas); i++) {
+        if (string_equals_cstr(isa, m_hw_isas[i].name)) {
+            *supported = m_hw_isas[i].supported;
+            return NO_ERROR;
+        }
+    }
+    return ERROR_NOT_FOUND;
+}
+
+const hw_intrinsic_t* hw_intrinsics_find(System_String isa, System_String name) {
+    for (int i = 0; i < ARRAY_LEN(m_hw_intrinsics); i++) {
+        hw_intrinsic_t* intrinsic = &m_hw_intrinsics[i];
+        if (string_equals_cstr(isa, intrinsic->isa) && string_equals_cstr(name, intrinsic->name)) {
+            return intrinsic;
+        }
+    }
+    return NULL;
+}
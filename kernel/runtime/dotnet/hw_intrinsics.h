@@ -0,0 +1,81 @@
+#pragma once
+
+#include <dotnet/jit/jit.h>
+
+#include <util/except.h>
+
+#include <stdbool.h>
+
+//
+// Native kernels of the managed hardware intrinsics (System.Runtime.Intrinsics.X86). MIR has no
+// vector registers, so most operations are a leaf function which is just the instruction and a
+// ret, the vectors are passed by reference and are loaded and stored unaligned. The jit emits a
+// direct call to the native in place of the internal call, without any method_result_t.
+//
+// The hot operations that work the same on 64bit halves (the bitwise ones, the 64bit lane
+// arithmetic and compare, TestZ) are lowered to inline MIR on the two halves instead, which
+// saves the call and lets MIR keep the halves in registers.
+//
+// IsSupported is checked with cpuid once at boot, and is folded into a constant by the jit.
+//
+
+typedef enum hw_lowering {
+    // call the native
+    HW_LOWER_NONE,
+
+    // result = left <code> right, on each 64bit half
+    HW_LOWER_LANES64,
+
+    // result = ~left & right, on each 64bit half
+    HW_LOWER_AND_NOT,
+
+    // each 64bit half of the result is all ones if the halves are equal
+    HW_LOWER_COMPARE_EQUAL64,
+
+    // returns true if left & right is zero
+    HW_LOWER_TEST_Z,
+} hw_lowering_t;
+
+typedef struct hw_intrinsic {
+    // the declaring class and the name of the internal call
+    const char* isa;
+    const char* name;
+
+    // the native and the name it is imported as
+    const char* native_name;
+    void* native;
+
+    // the result is MIR_T_UNDEF if there is none
+    MIR_type_t result;
+    int nargs;
+    MIR_type_t args[3];
+
+    // emit inline MIR instead of calling the native
+    hw_lowering_t lowering;
+    MIR_insn_code_t code;
+} hw_intrinsic_t;
+
+/**
+ * Check the cpu features and register all the natives with MIR
+ */
+void init_hw_intrinsics(MIR_context_t ctx);
+
+/**
+ * Check if the given intrinsics class is supported by the cpu
+ *
+ * @param isa           [IN] The name of the class
+ * @param supported     [OUT] Is the class supported
+ *
+ * @retval ERROR_NOT_FOUND if this is not an intrinsics class
+ */
+err_t hw_intrinsics_is_supported(System_String isa, bool* supported);
+
+/**
+ * Find the native of an internal call in one of the intrinsics classes
+ *
+ * @param isa   [IN] The name of the class
+ * @param name  [IN] The name of the internal call
+ *
+ * @returns NULL if this is not a hardware intrinsic
+ */
+const hw_intrinsic_t* hw_intrinsics_find(System_String isa, System_String name);
@@ -4,8 +4,21 @@
 #include "mem/phys.h"
 #include "mem/mem.h"
 #include "dotnet/loader.h"
+#include "runtime/dotnet/heap_stats.h"
+#include "runtime/dotnet/monitor.h"
+#include "runtime/dotnet/card_table.h"
+#include "runtime/dotnet/hw_intrinsics.h"
+#include "util/stb_ds.h"
+#include "util/string.h"
+#include "util/span.h"
 #include "acpi/acpi.h"
+#include "thread/waitable.h"
+#include "thread/timer.h"
+#include "thread/cpu_local.h"
+#include "thread/scheduler.h"
+#include "time/tsc.h"
 #include <irq/irq.h>
+#include <kernel.h>
 
 // Uncomment this if you need to debug MamMemory-related stuff
 #define MAPMEMORY_TRACE
@@ -32,11 +45,12 @@ static System_Exception Pentagon_HAL_MemoryServices_FreeMemory(uint64_t ptr) {
     return NULL;
 }
 
-static method_result_t Pentagon_HAL_MemoryServices_MapMemory(uint64_t phys, uint64_t pages) {
+static method_result_t Pentagon_HAL_MemoryServices_MapMemory(uint64_t phys, uint64_t pages, int32_t memory_type) {
 #ifdef MAPMEMORY_TRACE
-    printf("Pentagon.DriverServices.MemoryServices::MapMemory(0x%p, %d)\n", phys, pages);
+    printf("Pentagon.DriverServices.MemoryServices::MapMemory(0x%p, %d, %d)\n", phys, pages, memory_type);
 #endif
-    vmm_map(phys, PHYS_TO_DIRECT(phys), pages, MAP_WRITE);
+    // the managed MemoryType values are the same as the MAP_CACHE_* values
+    vmm_map(phys, PHYS_TO_DIRECT(phys), pages, MAP_WRITE | ((memory_type << 3) & MAP_CACHE_MASK));
     return (method_result_t){ .exception = NULL, .value = (uintptr_t)PHYS_TO_DIRECT(phys) };
 }
 
@@ -56,38 +70,805 @@ static void jit_MemoryServices_GetSpanPtr(MIR_context_t ctx) {
     MIR_new_export(ctx, fname);
 }
 
-static err_t pentagon_gen(MIR_context_t ctx, System_Reflection_MethodInfo method) {
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Intrinsics
+//
+// These are internal calls which are emitted as MIR instead of calling into a native function, the
+// MIR function is already created by the jit (with arguments named arg0, arg1, ...), and we only
+// need to emit the body. This saves the whole native call and the method_result_t round trip for
+// the hottest kernel services, and lets the MIR generator inline them into the caller.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+typedef err_t (*jit_intrinsic_gen_t)(MIR_context_t ctx, System_Reflection_MethodInfo method);
+
+typedef struct jit_intrinsic {
+    const char* namespace;
+    const char* type;
+    const char* name;
+    jit_intrinsic_gen_t gen;
+} jit_intrinsic_t;
+
+static void emit_ret_void(MIR_context_t ctx, System_Reflection_MethodInfo method) {
+    MIR_append_insn(ctx, method->MirFunc,
+                    MIR_new_ret_insn(ctx, 1,
+                                     MIR_new_int_op(ctx, 0)));
+}
+
+static void emit_ret_op(MIR_context_t ctx, System_Reflection_MethodInfo method, MIR_op_t op) {
+    MIR_append_insn(ctx, method->MirFunc,
+                    MIR_new_ret_insn(ctx, 2,
+                                     MIR_new_int_op(ctx, 0),
+                                     op));
+}
+
+static MIR_reg_t get_arg(MIR_context_t ctx, System_Reflection_MethodInfo method, int index) {
+    char name[16];
+    snprintf(name, sizeof(name), "arg%d", index);
+    return MIR_reg(ctx, name, method->MirFunc->u.func);
+}
+
+/**
+ * Used to give unique names to the prototypes of the leaf calls
+ */
+static atomic_int m_jit_leaf_proto_gen = 0;
+
+/**
+ * Emit a direct call to a leaf native with the arguments of the internal call, and return its
+ * result, MIR_T_UNDEF means there is no result. The native must be loaded with MIR_load_external
+ * under the given name, and can't throw.
+ */
+static void emit_leaf_call(MIR_context_t ctx, System_Reflection_MethodInfo method, const char* native,
+                           MIR_type_t result_type, int nargs, const MIR_type_t* arg_types) {
+    static const char* arg_names[] = { "a0", "a1", "a2", "a3" };
+    MIR_var_t vars[ARRAY_LEN(arg_names)] = {};
+    ASSERT(nargs <= ARRAY_LEN(vars));
+    for (int i = 0; i < nargs; i++) {
+        vars[i].type = arg_types[i];
+        vars[i].name = arg_names[i];
+    }
+
+    char name[64];
+    snprintf(name, sizeof(name), "%s_proto%d", native, atomic_fetch_add(&m_jit_leaf_proto_gen, 1));
+    MIR_item_t proto = MIR_new_proto_arr(ctx, name, result_type == MIR_T_UNDEF ? 0 : 1, &result_type, nargs, vars);
+    MIR_item_t import = MIR_new_import(ctx, native);
+
+    MIR_op_t ops[2 + 1 + ARRAY_LEN(vars)];
+    int nops = 0;
+    ops[nops++] = MIR_new_ref_op(ctx, proto);
+    ops[nops++] = MIR_new_ref_op(ctx, import);
+
+    MIR_reg_t result = 0;
+    if (result_type != MIR_T_UNDEF) {
+        result = MIR_new_func_reg(ctx, method->MirFunc->u.func, MIR_T_I64, "result");
+        ops[nops++] = MIR_new_reg_op(ctx, result);
+    }
+
+    for (int i = 0; i < nargs; i++) {
+        ops[nops++] = MIR_new_reg_op(ctx, get_arg(ctx, method, i));
+    }
+
+    MIR_append_insn(ctx, method->MirFunc, MIR_new_insn_arr(ctx, MIR_CALL, nops, ops));
+
+    if (result_type == MIR_T_UNDEF) {
+        emit_ret_void(ctx, method);
+    } else {
+        emit_ret_op(ctx, method, MIR_new_reg_op(ctx, result));
+    }
+}
+
+static err_t jit_MemoryServices_UnsafePtrToRef(MIR_context_t ctx, System_Reflection_MethodInfo method) {
+    emit_ret_op(ctx, method, MIR_new_reg_op(ctx, get_arg(ctx, method, 0)));
+    return NO_ERROR;
+}
+
+static err_t jit_MemoryServices_PhysicalToVirtual(MIR_context_t ctx, System_Reflection_MethodInfo method) {
+    MIR_reg_t phys = get_arg(ctx, method, 0);
+    MIR_append_insn(ctx, method->MirFunc,
+                    MIR_new_insn(ctx, MIR_ADD,
+                                 MIR_new_reg_op(ctx, phys),
+                                 MIR_new_reg_op(ctx, phys),
+                                 MIR_new_uint_op(ctx, DIRECT_MAP_START)));
+    emit_ret_op(ctx, method, MIR_new_reg_op(ctx, phys));
+    return NO_ERROR;
+}
+
+static err_t jit_MemoryServices_VirtualToPhysical(MIR_context_t ctx, System_Reflection_MethodInfo method) {
+    MIR_reg_t virt = get_arg(ctx, method, 0);
+    MIR_append_insn(ctx, method->MirFunc,
+                    MIR_new_insn(ctx, MIR_SUB,
+                                 MIR_new_reg_op(ctx, virt),
+                                 MIR_new_reg_op(ctx, virt),
+                                 MIR_new_uint_op(ctx, DIRECT_MAP_START)));
+    emit_ret_op(ctx, method, MIR_new_reg_op(ctx, virt));
+    return NO_ERROR;
+}
+
+//
+// Generic helpers used by the Corelib span code, these are resolved for the
+// generic argument at jit time so the managed code is left with a constant
+//
+
+static System_Type get_generic_argument(System_Reflection_MethodInfo method, int index) {
+    return method->GenericArguments->Data[index];
+}
+
+static err_t jit_Unsafe_AsPointer(MIR_context_t ctx, System_Reflection_MethodInfo method) {
+    emit_ret_op(ctx, method, MIR_new_reg_op(ctx, get_arg(ctx, method, 0)));
+    return NO_ERROR;
+}
+
+static err_t jit_RuntimeHelpers_IsReferenceOrContainsReferences(MIR_context_t ctx, System_Reflection_MethodInfo method) {
+    System_Type type = get_generic_argument(method, 0);
+    bool result = !type->IsValueType || arrlen(type->ManagedPointersOffsets) != 0;
+    emit_ret_op(ctx, method, MIR_new_int_op(ctx, result));
+    return NO_ERROR;
+}
+
+static err_t jit_RuntimeHelpers_IsBitwiseEquatable(MIR_context_t ctx, System_Reflection_MethodInfo method) {
+    // only types where Equals is the same as comparing the bits, this is
+    // not true for floating point types (NaN, -0.0) or most structs
+    System_Type type = get_generic_argument(method, 0);
+    bool result =
+        type == tSystem_Boolean || type == tSystem_Char ||
+        type == tSystem_SByte || type == tSystem_Byte ||
+        type == tSystem_Int16 || type == tSystem_UInt16 ||
+        type == tSystem_Int32 || type == tSystem_UInt32 ||
+        type == tSystem_Int64 || type == tSystem_UInt64 ||
+        type == tSystem_IntPtr || type == tSystem_UIntPtr;
+    emit_ret_op(ctx, method, MIR_new_int_op(ctx, result));
+    return NO_ERROR;
+}
+
+static err_t jit_RuntimeHelpers_GetHashCode(MIR_context_t ctx, System_Reflection_MethodInfo method) {
+    // objects never move, so the address is a stable identity, the low bits are
+    // always zero because of the alignment so take the top of a multiplicative hash
+    MIR_reg_t obj = get_arg(ctx, method, 0);
+    MIR_append_insn(ctx, method->MirFunc,
+                    MIR_new_insn(ctx, MIR_MUL,
+                                 MIR_new_reg_op(ctx, obj),
+                                 MIR_new_reg_op(ctx, obj),
+                                 MIR_new_uint_op(ctx, 0x9E3779B97F4A7C15ull)));
+    MIR_append_insn(ctx, method->MirFunc,
+                    MIR_new_insn(ctx, MIR_URSH,
+                                 MIR_new_reg_op(ctx, obj),
+                                 MIR_new_reg_op(ctx, obj),
+                                 MIR_new_int_op(ctx, 32)));
+    MIR_append_insn(ctx, method->MirFunc,
+                    MIR_new_insn(ctx, MIR_EXT32,
+                                 MIR_new_reg_op(ctx, obj),
+                                 MIR_new_reg_op(ctx, obj)));
+    emit_ret_op(ctx, method, MIR_new_reg_op(ctx, obj));
+    return NO_ERROR;
+}
+
+//
+// Thin locks, the managed Monitor takes and releases an uncontended lock with a single
+// compare exchange on the lock word, these give it the word without calling into native
+// code, and the id of the current thread with a single leaf call, see monitor.h for the layout
+//
+
+static err_t jit_Monitor_GetLockWord(MIR_context_t ctx, System_Reflection_MethodInfo method) {
+    MIR_reg_t obj = get_arg(ctx, method, 0);
+    MIR_reg_t slot = MIR_new_func_reg(ctx, method->MirFunc->u.func, MIR_T_I64, "slot");
+    MIR_reg_t pool = MIR_new_func_reg(ctx, method->MirFunc->u.func, MIR_T_I64, "pool");
+    MIR_reg_t shift = MIR_new_func_reg(ctx, method->MirFunc->u.func, MIR_T_I64, "shift");
+
+    // obj = obj - OBJECT_HEAP_START
+    MIR_append_insn(ctx, method->MirFunc,
+                    MIR_new_insn(ctx, MIR_SUB,
+                                 MIR_new_reg_op(ctx, obj),
+                                 MIR_new_reg_op(ctx, obj),
+                                 MIR_new_uint_op(ctx, OBJECT_HEAP_START)));
+
+    // pool = obj / SIZE_512GB
+    MIR_append_insn(ctx, method->MirFunc,
+                    MIR_new_insn(ctx, MIR_URSH,
+                                 MIR_new_reg_op(ctx, pool),
+                                 MIR_new_reg_op(ctx, obj),
+                                 MIR_new_int_op(ctx, __builtin_ctzll(SIZE_512GB))));
+
+    // slot = (obj % SIZE_512GB) >> (pool + 4)
+    MIR_append_insn(ctx, method->MirFunc,
+                    MIR_new_insn(ctx, MIR_AND,
+                                 MIR_new_reg_op(ctx, slot),
+                                 MIR_new_reg_op(ctx, obj),
+                                 MIR_new_uint_op(ctx, SIZE_512GB - 1)));
+    MIR_append_insn(ctx, method->MirFunc,
+                    MIR_new_insn(ctx, MIR_ADD,
+                                 MIR_new_reg_op(ctx, shift),
+                                 MIR_new_reg_op(ctx, pool),
+                                 MIR_new_int_op(ctx, 4)));
+    MIR_append_insn(ctx, method->MirFunc,
+                    MIR_new_insn(ctx, MIR_URSH,
+                                 MIR_new_reg_op(ctx, slot),
+                                 MIR_new_reg_op(ctx, slot),
+                                 MIR_new_reg_op(ctx, shift)));
+
+    // LOCK_TABLE_START + pool * SIZE_256GB + slot * MONITOR_LOCK_WORD_SIZE
+    MIR_append_insn(ctx, method->MirFunc,
+                    MIR_new_insn(ctx, MIR_LSH,
+                                 MIR_new_reg_op(ctx, pool),
+                                 MIR_new_reg_op(ctx, pool),
+                                 MIR_new_int_op(ctx, __builtin_ctzll(SIZE_256GB))));
+    MIR_append_insn(ctx, method->MirFunc,
+                    MIR_new_insn(ctx, MIR_LSH,
+                                 MIR_new_reg_op(ctx, slot),
+                                 MIR_new_reg_op(ctx, slot),
+                                 MIR_new_int_op(ctx, __builtin_ctzll(MONITOR_LOCK_WORD_SIZE))));
+    MIR_append_insn(ctx, method->MirFunc,
+                    MIR_new_insn(ctx, MIR_ADD,
+                                 MIR_new_reg_op(ctx, obj),
+                                 MIR_new_reg_op(ctx, pool),
+                                 MIR_new_reg_op(ctx, slot)));
+    MIR_append_insn(ctx, method->MirFunc,
+                    MIR_new_insn(ctx, MIR_ADD,
+                                 MIR_new_reg_op(ctx, obj),
+                                 MIR_new_reg_op(ctx, obj),
+                                 MIR_new_uint_op(ctx, LOCK_TABLE_START)));
+    emit_ret_op(ctx, method, MIR_new_reg_op(ctx, obj));
+    return NO_ERROR;
+}
+
+static uint32_t jit_monitor_thread_id() {
+    return get_current_thread()->id;
+}
+
+static err_t jit_Monitor_GetCurrentThreadId(MIR_context_t ctx, System_Reflection_MethodInfo method) {
+    emit_leaf_call(ctx, method, "jit_monitor_thread_id", MIR_T_U32, 0, NULL);
+    return NO_ERROR;
+}
+
+//
+// Interlocked and Volatile, MIR has no atomic instructions so the read-modify-write
+// operations are a single call to a leaf native which is just the locked instruction
+// and a ret, no method_result_t and no exception check. Plain loads and stores are
+// already acquire and release on x86, but MIR knows nothing about volatile and is free
+// to hoist a load out of a spin loop or merge it with another, so the volatile accesses
+// (and Interlocked.Read) are leaf calls as well. The width of the access is taken from
+// the generic argument.
+//
+
+static uint32_t jit_atomic_xadd32(_Atomic(uint32_t)* location, uint32_t value) { return atomic_fetch_add(location, value); }
+static uint64_t jit_atomic_xadd64(_Atomic(uint64_t)* location, uint64_t value) { return atomic_fetch_add(location, value); }
+static uint32_t jit_atomic_xchg32(_Atomic(uint32_t)* location, uint32_t value) { return atomic_exchange(location, value); }
+static uint64_t jit_atomic_xchg64(_Atomic(uint64_t)* location, uint64_t value) { return atomic_exchange(location, value); }
+static uint32_t jit_atomic_and32(_Atomic(uint32_t)* location, uint32_t value) { return atomic_fetch_and(location, value); }
+static uint64_t jit_atomic_and64(_Atomic(uint64_t)* location, uint64_t value) { return atomic_fetch_and(location, value); }
+static uint32_t jit_atomic_or32(_Atomic(uint32_t)* location, uint32_t value) { return atomic_fetch_or(location, value); }
+static uint64_t jit_atomic_or64(_Atomic(uint64_t)* location, uint64_t value) { return atomic_fetch_or(location, value); }
+
+static uint32_t jit_atomic_cmpxchg32(_Atomic(uint32_t)* location, uint32_t value, uint32_t comparand) {
+    atomic_compare_exchange_strong(location, &comparand, value);
+    return comparand;
+}
+
+static uint64_t jit_atomic_cmpxchg64(_Atomic(uint64_t)* location, uint64_t value, uint64_t comparand) {
+    atomic_compare_exchange_strong(location, &comparand, value);
+    return comparand;
+}
+
+// the reference versions also need the write barrier
+
+static void* jit_atomic_xchg_ref(_Atomic(void*)* location, void* value) {
+    void* old = atomic_exchange(location, value);
+    card_table_mark(location);
+    return old;
+}
+
+static void* jit_atomic_cmpxchg_ref(_Atomic(void*)* location, void* value, void* comparand) {
+    if (atomic_compare_exchange_strong(location, &comparand, value)) {
+        card_table_mark(location);
+    }
+    return comparand;
+}
+
+static void jit_atomic_barrier() {
+    atomic_thread_fence(memory_order_seq_cst);
+}
+
+static uint8_t jit_volatile_read8(volatile uint8_t* location) { return *location; }
+static uint16_t jit_volatile_read16(volatile uint16_t* location) { return *location; }
+static uint32_t jit_volatile_read32(volatile uint32_t* location) { return *location; }
+static uint64_t jit_volatile_read64(volatile uint64_t* location) { return *location; }
+static void jit_volatile_write8(volatile uint8_t* location, uint8_t value) { *location = value; }
+static void jit_volatile_write16(volatile uint16_t* location, uint16_t value) { *location = value; }
+static void jit_volatile_write32(volatile uint32_t* location, uint32_t value) { *location = value; }
+static void jit_volatile_write64(volatile uint64_t* location, uint64_t value) { *location = value; }
+
+static void jit_volatile_write_ref(void* volatile* location, void* value) {
+    *location = value;
+    card_table_mark((void*)location);
+}
+
+/**
+ * The MIR type of a generic argument, only primitives and references,
+ * MIR_T_UNDEF for anything else
+ */
+static MIR_type_t get_atomic_type(System_Type type) {
+    if (!type->IsValueType) return MIR_T_P;
+    if (type == tSystem_Boolean || type == tSystem_Byte) return MIR_T_U8;
+    if (type == tSystem_SByte) return MIR_T_I8;
+    if (type == tSystem_Char || type == tSystem_UInt16) return MIR_T_U16;
+    if (type == tSystem_Int16) return MIR_T_I16;
+    if (type == tSystem_Int32) return MIR_T_I32;
+    if (type == tSystem_UInt32) return MIR_T_U32;
+    if (type == tSystem_Int64 || type == tSystem_IntPtr) return MIR_T_I64;
+    if (type == tSystem_UInt64 || type == tSystem_UIntPtr) return MIR_T_U64;
+    return MIR_T_UNDEF;
+}
+
+/**
+ * Emit a call to one of the atomic natives, the first argument is
+ * the location and the rest have the given type
+ */
+static void emit_atomic_call(MIR_context_t ctx, System_Reflection_MethodInfo method, const char* native, MIR_type_t type, int nargs) {
+    MIR_type_t args[] = { MIR_T_P, type, type };
+    emit_leaf_call(ctx, method, native, type, nargs, args);
+}
+
+/**
+ * Pick the native of the right width for the generic argument
+ */
+static err_t emit_atomic_op(MIR_context_t ctx, System_Reflection_MethodInfo method,
+                            const char* native32, const char* native64, const char* native_ref,
+                            int nargs) {
     err_t err = NO_ERROR;
 
-    if (method->GenericMethodDefinition != NULL) {
-        if (string_equals_cstr( method->GenericMethodDefinition->Name, "UnsafePtrToRef")) {
-            MIR_reg_t this = MIR_reg(ctx, "arg0", method->MirFunc->u.func);
-            MIR_append_insn(ctx, method->MirFunc,
-                            MIR_new_ret_insn(ctx, 2,
-                                             MIR_new_int_op(ctx, 0),
-                                             MIR_new_reg_op(ctx, this)));
-        } else {
-            CHECK_FAIL("%U", method->Name);
+    MIR_type_t type = get_atomic_type(get_generic_argument(method, 0));
+    switch (type) {
+        case MIR_T_I32:
+        case MIR_T_U32: emit_atomic_call(ctx, method, native32, type, nargs); break;
+        case MIR_T_I64:
+        case MIR_T_U64: emit_atomic_call(ctx, method, native64, type, nargs); break;
+        case MIR_T_P: {
+            CHECK(native_ref != NULL);
+            emit_atomic_call(ctx, method, native_ref, type, nargs);
+        } break;
+        default: CHECK_FAIL("Invalid type for %U", method->Name);
+    }
+
+cleanup:
+    return err;
+}
+
+static err_t jit_Interlocked_AtomicExchangeAdd(MIR_context_t ctx, System_Reflection_MethodInfo method) {
+    return emit_atomic_op(ctx, method, "jit_atomic_xadd32", "jit_atomic_xadd64", NULL, 2);
+}
+
+static err_t jit_Interlocked_AtomicExchange(MIR_context_t ctx, System_Reflection_MethodInfo method) {
+    return emit_atomic_op(ctx, method, "jit_atomic_xchg32", "jit_atomic_xchg64", "jit_atomic_xchg_ref", 2);
+}
+
+static err_t jit_Interlocked_AtomicCompareExchange(MIR_context_t ctx, System_Reflection_MethodInfo method) {
+    return emit_atomic_op(ctx, method, "jit_atomic_cmpxchg32", "jit_atomic_cmpxchg64", "jit_atomic_cmpxchg_ref", 3);
+}
+
+static err_t jit_Interlocked_AtomicAnd(MIR_context_t ctx, System_Reflection_MethodInfo method) {
+    return emit_atomic_op(ctx, method, "jit_atomic_and32", "jit_atomic_and64", NULL, 2);
+}
+
+static err_t jit_Interlocked_AtomicOr(MIR_context_t ctx, System_Reflection_MethodInfo method) {
+    return emit_atomic_op(ctx, method, "jit_atomic_or32", "jit_atomic_or64", NULL, 2);
+}
+
+static err_t jit_Interlocked_AtomicMemoryBarrier(MIR_context_t ctx, System_Reflection_MethodInfo method) {
+    emit_atomic_call(ctx, method, "jit_atomic_barrier", MIR_T_UNDEF, 0);
+    return NO_ERROR;
+}
+
+/**
+ * Pick the volatile native of the right width for the MIR type
+ */
+static const char* get_volatile_native(MIR_type_t type, bool write) {
+    switch (type) {
+        case MIR_T_I8:
+        case MIR_T_U8: return write ? "jit_volatile_write8" : "jit_volatile_read8";
+        case MIR_T_I16:
+        case MIR_T_U16: return write ? "jit_volatile_write16" : "jit_volatile_read16";
+        case MIR_T_I32:
+        case MIR_T_U32: return write ? "jit_volatile_write32" : "jit_volatile_read32";
+        case MIR_T_P: return write ? "jit_volatile_write_ref" : "jit_volatile_read64";
+        default: return write ? "jit_volatile_write64" : "jit_volatile_read64";
+    }
+}
+
+static err_t jit_Volatile_ReadValue(MIR_context_t ctx, System_Reflection_MethodInfo method) {
+    err_t err = NO_ERROR;
+
+    MIR_type_t type = get_atomic_type(get_generic_argument(method, 0));
+    CHECK(type != MIR_T_UNDEF, "Invalid type for %U", method->Name);
+
+    MIR_type_t args[] = { MIR_T_P };
+    emit_leaf_call(ctx, method, get_volatile_native(type, false), type, 1, args);
+
+cleanup:
+    return err;
+}
+
+static err_t jit_Volatile_WriteValue(MIR_context_t ctx, System_Reflection_MethodInfo method) {
+    err_t err = NO_ERROR;
+
+    MIR_type_t type = get_atomic_type(get_generic_argument(method, 0));
+    CHECK(type != MIR_T_UNDEF, "Invalid type for %U", method->Name);
+
+    MIR_type_t args[] = { MIR_T_P, type };
+    emit_leaf_call(ctx, method, get_volatile_native(type, true), MIR_T_UNDEF, 2, args);
+
+cleanup:
+    return err;
+}
+
+//
+// MMIO accesses, MIR has no volatile memory operands, so a plain load or store could be
+// merged with another access to the same address or hoisted out of a loop. Instead each
+// access is a call to a leaf native doing a single volatile access of the exact width,
+// the call is opaque to the optimizer so the device sees every access in program order.
+//
+
+static uint8_t jit_mmio_read8(volatile uint8_t* address) { return *address; }
+static uint16_t jit_mmio_read16(volatile uint16_t* address) { return *address; }
+static uint32_t jit_mmio_read32(volatile uint32_t* address) { return *address; }
+static uint64_t jit_mmio_read64(volatile uint64_t* address) { return *address; }
+static void jit_mmio_write8(volatile uint8_t* address, uint8_t value) { *address = value; }
+static void jit_mmio_write16(volatile uint16_t* address, uint16_t value) { *address = value; }
+static void jit_mmio_write32(volatile uint32_t* address, uint32_t value) { *address = value; }
+static void jit_mmio_write64(volatile uint64_t* address, uint64_t value) { *address = value; }
+
+static err_t emit_mmio_read(MIR_context_t ctx, System_Reflection_MethodInfo method, const char* native, MIR_type_t type) {
+    MIR_type_t args[] = { MIR_T_P };
+    emit_leaf_call(ctx, method, native, type, 1, args);
+    return NO_ERROR;
+}
+
+static err_t emit_mmio_write(MIR_context_t ctx, System_Reflection_MethodInfo method, const char* native, MIR_type_t type) {
+    MIR_type_t args[] = { MIR_T_P, type };
+    emit_leaf_call(ctx, method, native, MIR_T_UNDEF, 2, args);
+    return NO_ERROR;
+}
+
+static err_t jit_Mmio_Read8(MIR_context_t ctx, System_Reflection_MethodInfo method) { return emit_mmio_read(ctx, method, "jit_mmio_read8", MIR_T_U8); }
+static err_t jit_Mmio_Read16(MIR_context_t ctx, System_Reflection_MethodInfo method) { return emit_mmio_read(ctx, method, "jit_mmio_read16", MIR_T_U16); }
+static err_t jit_Mmio_Read32(MIR_context_t ctx, System_Reflection_MethodInfo method) { return emit_mmio_read(ctx, method, "jit_mmio_read32", MIR_T_U32); }
+static err_t jit_Mmio_Read64(MIR_context_t ctx, System_Reflection_MethodInfo method) { return emit_mmio_read(ctx, method, "jit_mmio_read64", MIR_T_U64); }
+static err_t jit_Mmio_Write8(MIR_context_t ctx, System_Reflection_MethodInfo method) { return emit_mmio_write(ctx, method, "jit_mmio_write8", MIR_T_U8); }
+static err_t jit_Mmio_Write16(MIR_context_t ctx, System_Reflection_MethodInfo method) { return emit_mmio_write(ctx, method, "jit_mmio_write16", MIR_T_U16); }
+static err_t jit_Mmio_Write32(MIR_context_t ctx, System_Reflection_MethodInfo method) { return emit_mmio_write(ctx, method, "jit_mmio_write32", MIR_T_U32); }
+static err_t jit_Mmio_Write64(MIR_context_t ctx, System_Reflection_MethodInfo method) { return emit_mmio_write(ctx, method, "jit_mmio_write64", MIR_T_U64); }
+
+/**
+ * Pick the mmio native of the right width for the MIR type
+ */
+static const char* get_mmio_native(MIR_type_t type, bool write) {
+    switch (type) {
+        case MIR_T_I8:
+        case MIR_T_U8: return write ? "jit_mmio_write8" : "jit_mmio_read8";
+        case MIR_T_I16:
+        case MIR_T_U16: return write ? "jit_mmio_write16" : "jit_mmio_read16";
+        case MIR_T_I32:
+        case MIR_T_U32: return write ? "jit_mmio_write32" : "jit_mmio_read32";
+        default: return write ? "jit_mmio_write64" : "jit_mmio_read64";
+    }
+}
+
+static err_t jit_Mmio_Read(MIR_context_t ctx, System_Reflection_MethodInfo method) {
+    err_t err = NO_ERROR;
+
+    // only integers, the width of the access is the width of the type
+    MIR_type_t type = get_atomic_type(get_generic_argument(method, 0));
+    CHECK(type != MIR_T_UNDEF && type != MIR_T_P, "Invalid type for %U", method->Name);
+    CHECK_AND_RETHROW(emit_mmio_read(ctx, method, get_mmio_native(type, false), type));
+
+cleanup:
+    return err;
+}
+
+static err_t jit_Mmio_Write(MIR_context_t ctx, System_Reflection_MethodInfo method) {
+    err_t err = NO_ERROR;
+
+    MIR_type_t type = get_atomic_type(get_generic_argument(method, 0));
+    CHECK(type != MIR_T_UNDEF && type != MIR_T_P, "Invalid type for %U", method->Name);
+    CHECK_AND_RETHROW(emit_mmio_write(ctx, method, get_mmio_native(type, true), type));
+
+cleanup:
+    return err;
+}
+
+//
+// Hardware intrinsics, the classes of System.Runtime.Intrinsics.X86 have IsSupported folded into a
+// constant, so the MIR optimizer removes the paths the cpu can't run, and the rest of the internal
+// calls are direct calls to the natives in hw_intrinsics.c. The Bmi1 operations which are just
+// arithmetic are emitted inline instead, the 32bit versions zero extend the result, and so are
+// the vector operations that hw_intrinsics.c marks as lowered.
+//
+
+#define HW_INTRINSICS_NAMESPACE "System.Runtime.Intrinsics.X86"
+
+static void emit_bmi1_op(MIR_context_t ctx, System_Reflection_MethodInfo method,
+                         MIR_insn_code_t first, MIR_op_t first_op,
+                         MIR_insn_code_t second, bool is_64bit) {
+    MIR_reg_t value = get_arg(ctx, method, 0);
+    MIR_reg_t bits = MIR_new_func_reg(ctx, method->MirFunc->u.func, MIR_T_I64, "bits");
+
+    // bits = value - first_op, or -value for MIR_NEG
+    // bits = bits <second> value
+    if (first == MIR_NEG) {
+        MIR_append_insn(ctx, method->MirFunc,
+                        MIR_new_insn(ctx, MIR_NEG,
+                                     MIR_new_reg_op(ctx, bits),
+                                     MIR_new_reg_op(ctx, value)));
+    } else {
+        MIR_append_insn(ctx, method->MirFunc,
+                        MIR_new_insn(ctx, first,
+                                     MIR_new_reg_op(ctx, bits),
+                                     MIR_new_reg_op(ctx, value),
+                                     first_op));
+    }
+    MIR_append_insn(ctx, method->MirFunc,
+                    MIR_new_insn(ctx, second,
+                                 MIR_new_reg_op(ctx, bits),
+                                 MIR_new_reg_op(ctx, bits),
+                                 MIR_new_reg_op(ctx, value)));
+    if (!is_64bit) {
+        MIR_append_insn(ctx, method->MirFunc,
+                        MIR_new_insn(ctx, MIR_UEXT32,
+                                     MIR_new_reg_op(ctx, bits),
+                                     MIR_new_reg_op(ctx, bits)));
+    }
+    emit_ret_op(ctx, method, MIR_new_reg_op(ctx, bits));
+}
+
+static void emit_bmi1_and_not(MIR_context_t ctx, System_Reflection_MethodInfo method, bool is_64bit) {
+    // ~left & right, the right side is already zero extended
+    MIR_reg_t left = get_arg(ctx, method, 0);
+    MIR_reg_t right = get_arg(ctx, method, 1);
+    MIR_append_insn(ctx, method->MirFunc,
+                    MIR_new_insn(ctx, MIR_XOR,
+                                 MIR_new_reg_op(ctx, left),
+                                 MIR_new_reg_op(ctx, left),
+                                 MIR_new_int_op(ctx, -1)));
+    MIR_append_insn(ctx, method->MirFunc,
+                    MIR_new_insn(ctx, MIR_AND,
+                                 MIR_new_reg_op(ctx, left),
+                                 MIR_new_reg_op(ctx, left),
+                                 MIR_new_reg_op(ctx, right)));
+    emit_ret_op(ctx, method, MIR_new_reg_op(ctx, left));
+}
+
+static err_t jit_Bmi1_AndNot32(MIR_context_t ctx, System_Reflection_MethodInfo method) {
+    emit_bmi1_and_not(ctx, method, false);
+    return NO_ERROR;
+}
+
+static err_t jit_Bmi1_AndNot64(MIR_context_t ctx, System_Reflection_MethodInfo method) {
+    emit_bmi1_and_not(ctx, method, true);
+    return NO_ERROR;
+}
+
+// value & -value
+static err_t jit_Bmi1_ExtractLowestSetBit32(MIR_context_t ctx, System_Reflection_MethodInfo method) {
+    emit_bmi1_op(ctx, method, MIR_NEG, MIR_new_int_op(ctx, 0), MIR_AND, false);
+    return NO_ERROR;
+}
+
+static err_t jit_Bmi1_ExtractLowestSetBit64(MIR_context_t ctx, System_Reflection_MethodInfo method) {
+    emit_bmi1_op(ctx, method, MIR_NEG, MIR_new_int_op(ctx, 0), MIR_AND, true);
+    return NO_ERROR;
+}
+
+// (value - 1) ^ value
+static err_t jit_Bmi1_GetMaskUpToLowestSetBit32(MIR_context_t ctx, System_Reflection_MethodInfo method) {
+    emit_bmi1_op(ctx, method, MIR_SUB, MIR_new_int_op(ctx, 1), MIR_XOR, false);
+    return NO_ERROR;
+}
+
+static err_t jit_Bmi1_GetMaskUpToLowestSetBit64(MIR_context_t ctx, System_Reflection_MethodInfo method) {
+    emit_bmi1_op(ctx, method, MIR_SUB, MIR_new_int_op(ctx, 1), MIR_XOR, true);
+    return NO_ERROR;
+}
+
+// (value - 1) & value
+static err_t jit_Bmi1_ResetLowestSetBit32(MIR_context_t ctx, System_Reflection_MethodInfo method) {
+    emit_bmi1_op(ctx, method, MIR_SUB, MIR_new_int_op(ctx, 1), MIR_AND, false);
+    return NO_ERROR;
+}
+
+static err_t jit_Bmi1_ResetLowestSetBit64(MIR_context_t ctx, System_Reflection_MethodInfo method) {
+    emit_bmi1_op(ctx, method, MIR_SUB, MIR_new_int_op(ctx, 1), MIR_AND, true);
+    return NO_ERROR;
+}
+
+static bool is_hw_intrinsic(System_Reflection_MethodInfo method) {
+    System_Type type = method->DeclaringType;
+    if (!string_equals_cstr(type->Namespace, HW_INTRINSICS_NAMESPACE)) {
+        return false;
+    }
+
+    bool supported;
+    if (string_equals_cstr(method->Name, "get_IsSupported")) {
+        return hw_intrinsics_is_supported(type->Name, &supported) == NO_ERROR;
+    }
+
+    return hw_intrinsics_find(type->Name, method->Name) != NULL;
+}
+
+/**
+ * Emit one of the vector operations that work on the 64bit halves as inline MIR
+ */
+static void emit_hw_lowered(MIR_context_t ctx, System_Reflection_MethodInfo method, const hw_intrinsic_t* intrinsic) {
+    MIR_reg_t lane = MIR_new_func_reg(ctx, method->MirFunc->u.func, MIR_T_I64, "lane");
+
+    if (intrinsic->lowering == HW_LOWER_TEST_Z) {
+        MIR_reg_t left = get_arg(ctx, method, 0);
+        MIR_reg_t right = get_arg(ctx, method, 1);
+        MIR_reg_t high = MIR_new_func_reg(ctx, method->MirFunc->u.func, MIR_T_I64, "high");
+
+        // ((left[0] & right[0]) | (left[1] & right[1])) == 0
+        MIR_append_insn(ctx, method->MirFunc,
+                        MIR_new_insn(ctx, MIR_AND,
+                                     MIR_new_reg_op(ctx, lane),
+                                     MIR_new_mem_op(ctx, MIR_T_I64, 0, left, 0, 1),
+                                     MIR_new_mem_op(ctx, MIR_T_I64, 0, right, 0, 1)));
+        MIR_append_insn(ctx, method->MirFunc,
+                        MIR_new_insn(ctx, MIR_AND,
+                                     MIR_new_reg_op(ctx, high),
+                                     MIR_new_mem_op(ctx, MIR_T_I64, 8, left, 0, 1),
+                                     MIR_new_mem_op(ctx, MIR_T_I64, 8, right, 0, 1)));
+        MIR_append_insn(ctx, method->MirFunc,
+                        MIR_new_insn(ctx, MIR_OR,
+                                     MIR_new_reg_op(ctx, lane),
+                                     MIR_new_reg_op(ctx, lane),
+                                     MIR_new_reg_op(ctx, high)));
+        MIR_append_insn(ctx, method->MirFunc,
+                        MIR_new_insn(ctx, MIR_EQ,
+                                     MIR_new_reg_op(ctx, lane),
+                                     MIR_new_reg_op(ctx, lane),
+                                     MIR_new_int_op(ctx, 0)));
+        emit_ret_op(ctx, method, MIR_new_reg_op(ctx, lane));
+        return;
+    }
+
+    MIR_reg_t result = get_arg(ctx, method, 0);
+    MIR_reg_t left = get_arg(ctx, method, 1);
+    MIR_reg_t right = get_arg(ctx, method, 2);
+    for (int offset = 0; offset < 16; offset += 8) {
+        MIR_op_t left_op = MIR_new_mem_op(ctx, MIR_T_I64, offset, left, 0, 1);
+        MIR_op_t right_op = MIR_new_mem_op(ctx, MIR_T_I64, offset, right, 0, 1);
+
+        switch (intrinsic->lowering) {
+            case HW_LOWER_LANES64: {
+                MIR_append_insn(ctx, method->MirFunc,
+                                MIR_new_insn(ctx, intrinsic->code,
+                                             MIR_new_reg_op(ctx, lane), left_op, right_op));
+            } break;
+
+            case HW_LOWER_AND_NOT: {
+                // lane = (left ^ -1) & right
+                MIR_append_insn(ctx, method->MirFunc,
+                                MIR_new_insn(ctx, MIR_XOR,
+                                             MIR_new_reg_op(ctx, lane), left_op, MIR_new_int_op(ctx, -1)));
+                MIR_append_insn(ctx, method->MirFunc,
+                                MIR_new_insn(ctx, MIR_AND,
+                                             MIR_new_reg_op(ctx, lane), MIR_new_reg_op(ctx, lane), right_op));
+            } break;
+
+            case HW_LOWER_COMPARE_EQUAL64: {
+                // lane = -(left == right)
+                MIR_append_insn(ctx, method->MirFunc,
+                                MIR_new_insn(ctx, MIR_EQ,
+                                             MIR_new_reg_op(ctx, lane), left_op, right_op));
+                MIR_append_insn(ctx, method->MirFunc,
+                                MIR_new_insn(ctx, MIR_NEG,
+                                             MIR_new_reg_op(ctx, lane), MIR_new_reg_op(ctx, lane)));
+            } break;
+
+            default: ASSERT(!"Invalid hw lowering");
         }
+
+        MIR_append_insn(ctx, method->MirFunc,
+                        MIR_new_insn(ctx, MIR_MOV,
+                                     MIR_new_mem_op(ctx, MIR_T_I64, offset, result, 0, 1),
+                                     MIR_new_reg_op(ctx, lane)));
+    }
+    emit_ret_void(ctx, method);
+}
+
+static err_t jit_hw_intrinsic(MIR_context_t ctx, System_Reflection_MethodInfo method) {
+    err_t err = NO_ERROR;
+    System_Type type = method->DeclaringType;
+
+    if (string_equals_cstr(method->Name, "get_IsSupported")) {
+        bool supported = false;
+        CHECK_AND_RETHROW(hw_intrinsics_is_supported(type->Name, &supported));
+        emit_ret_op(ctx, method, MIR_new_int_op(ctx, supported));
     } else {
-        CHECK_FAIL("%U", method->Name);
+        const hw_intrinsic_t* intrinsic = hw_intrinsics_find(type->Name, method->Name);
+        CHECK(intrinsic != NULL, "%U", method->Name);
+        if (intrinsic->lowering != HW_LOWER_NONE) {
+            emit_hw_lowered(ctx, method, intrinsic);
+        } else {
+            emit_leaf_call(ctx, method, intrinsic->native_name, intrinsic->result, intrinsic->nargs, intrinsic->args);
+        }
     }
 
 cleanup:
     return err;
 }
 
-static bool pentagon_can_gen(System_Reflection_MethodInfo method) {
+static jit_intrinsic_t m_jit_intrinsics[] = {
+    { "Pentagon.DriverServices", "MemoryServices", "UnsafePtrToRef", jit_MemoryServices_UnsafePtrToRef },
+    { "Pentagon.DriverServices", "MemoryServices", "PhysicalToVirtual", jit_MemoryServices_PhysicalToVirtual },
+    { "Pentagon.DriverServices", "MemoryServices", "VirtualToPhysical", jit_MemoryServices_VirtualToPhysical },
+    { "Pentagon.DriverServices", "Mmio", "Read8", jit_Mmio_Read8 },
+    { "Pentagon.DriverServices", "Mmio", "Read16", jit_Mmio_Read16 },
+    { "Pentagon.DriverServices", "Mmio", "Read32", jit_Mmio_Read32 },
+    { "Pentagon.DriverServices", "Mmio", "Read64", jit_Mmio_Read64 },
+    { "Pentagon.DriverServices", "Mmio", "Write8", jit_Mmio_Write8 },
+    { "Pentagon.DriverServices", "Mmio", "Write16", jit_Mmio_Write16 },
+    { "Pentagon.DriverServices", "Mmio", "Write32", jit_Mmio_Write32 },
+    { "Pentagon.DriverServices", "Mmio", "Write64", jit_Mmio_Write64 },
+    { "Pentagon.DriverServices", "Mmio", "Read", jit_Mmio_Read },
+    { "Pentagon.DriverServices", "Mmio", "Write", jit_Mmio_Write },
+    { "System.Runtime.CompilerServices", "Unsafe", "AsPointer", jit_Unsafe_AsPointer },
+    { "System.Runtime.CompilerServices", "RuntimeHelpers", "IsReferenceOrContainsReferences", jit_RuntimeHelpers_IsReferenceOrContainsReferences },
+    { "System.Runtime.CompilerServices", "RuntimeHelpers", "IsBitwiseEquatable", jit_RuntimeHelpers_IsBitwiseEquatable },
+    { "System.Runtime.CompilerServices", "RuntimeHelpers", "GetHashCode", jit_RuntimeHelpers_GetHashCode },
+    { "System.Threading", "Monitor", "GetLockWord", jit_Monitor_GetLockWord },
+    { "System.Threading", "Monitor", "GetCurrentThreadId", jit_Monitor_GetCurrentThreadId },
+    { "System.Threading", "Interlocked", "AtomicExchangeAdd", jit_Interlocked_AtomicExchangeAdd },
+    { "System.Threading", "Interlocked", "AtomicExchange", jit_Interlocked_AtomicExchange },
+    { "System.Threading", "Interlocked", "AtomicCompareExchange", jit_Interlocked_AtomicCompareExchange },
+    { "System.Threading", "Interlocked", "AtomicAnd", jit_Interlocked_AtomicAnd },
+    { "System.Threading", "Interlocked", "AtomicOr", jit_Interlocked_AtomicOr },
+    { "System.Threading", "Interlocked", "AtomicMemoryBarrier", jit_Interlocked_AtomicMemoryBarrier },
+    { "System.Threading", "Volatile", "ReadValue", jit_Volatile_ReadValue },
+    { "System.Threading", "Volatile", "WriteValue", jit_Volatile_WriteValue },
+    { "System.Runtime.Intrinsics.X86", "Bmi1", "AndNot32", jit_Bmi1_AndNot32 },
+    { "System.Runtime.Intrinsics.X86", "Bmi1", "AndNot64", jit_Bmi1_AndNot64 },
+    { "System.Runtime.Intrinsics.X86", "Bmi1", "ExtractLowestSetBit32", jit_Bmi1_ExtractLowestSetBit32 },
+    { "System.Runtime.Intrinsics.X86", "Bmi1", "ExtractLowestSetBit64", jit_Bmi1_ExtractLowestSetBit64 },
+    { "System.Runtime.Intrinsics.X86", "Bmi1", "GetMaskUpToLowestSetBit32", jit_Bmi1_GetMaskUpToLowestSetBit32 },
+    { "System.Runtime.Intrinsics.X86", "Bmi1", "GetMaskUpToLowestSetBit64", jit_Bmi1_GetMaskUpToLowestSetBit64 },
+    { "System.Runtime.Intrinsics.X86", "Bmi1", "ResetLowestSetBit32", jit_Bmi1_ResetLowestSetBit32 },
+    { "System.Runtime.Intrinsics.X86", "Bmi1", "ResetLowestSetBit64", jit_Bmi1_ResetLowestSetBit64 },
+};
+
+static jit_intrinsic_t* find_intrinsic(System_Reflection_MethodInfo method) {
     System_Type type = method->DeclaringType;
-    if (string_equals_cstr(type->Namespace, "Pentagon.DriverServices")) {
-        if (string_equals_cstr(type->Name, "MemoryServices")) {
-            if (method->GenericMethodDefinition != NULL) {
-                method = method->GenericMethodDefinition;
-                if (string_equals_cstr(method->Name, "UnsafePtrToRef")) return true;
-            }
+    if (method->GenericMethodDefinition != NULL) {
+        method = method->GenericMethodDefinition;
+    }
+
+    for (int i = 0; i < ARRAY_LEN(m_jit_intrinsics); i++) {
+        jit_intrinsic_t* intrinsic = &m_jit_intrinsics[i];
+        if (
+            string_equals_cstr(type->Namespace, intrinsic->namespace) &&
+            string_equals_cstr(type->Name, intrinsic->type) &&
+            string_equals_cstr(method->Name, intrinsic->name)
+        ) {
+            return intrinsic;
         }
     }
-    return false;
+
+    return NULL;
+}
+
+static err_t pentagon_gen(MIR_context_t ctx, System_Reflection_MethodInfo method) {
+    err_t err = NO_ERROR;
+
+    jit_intrinsic_t* intrinsic = find_intrinsic(method);
+    if (intrinsic != NULL) {
+        CHECK_AND_RETHROW(intrinsic->gen(ctx, method));
+    } else {
+        CHECK(is_hw_intrinsic(method), "%U", method->Name);
+        CHECK_AND_RETHROW(jit_hw_intrinsic(ctx, method));
+    }
+
+cleanup:
+    return err;
+}
+
+static bool pentagon_can_gen(System_Reflection_MethodInfo method) {
+    return find_intrinsic(method) != NULL || is_hw_intrinsic(method);
 }
 
 static jit_generic_extern_hook_t m_jit_extern_hook = {
@@ -105,8 +886,18 @@ static System_Exception Pentagon_DriverServices_Log_LogString(System_String val)
     return NULL;
 }
 
-static method_result_t Pentagon_DriverServices_Acpi_GetRsdt() {
-    return (method_result_t){ .exception = NULL, .value = DIRECT_TO_PHYS(m_rsdt) };
+static System_Exception Pentagon_DriverServices_Log_LogChars(System_Char* chars, int32_t length) {
+    // a single printf so the whole line is written under the printf lock
+    // and can't interleave with the lines of other cpus
+    TRACE("%.*W", length, chars);
+    return NULL;
+}
+
+static method_result_t Pentagon_DriverServices_Acpi_GetTables(int32_t* count) {
+    size_t table_count;
+    const acpi_table_entry_t* tables = acpi_get_tables(&table_count);
+    *count = (int32_t)table_count;
+    return (method_result_t){ .exception = NULL, .value = (uintptr_t)tables };
 }
 
 static method_result_t Pentagon_GetMappedPhysicalAddress(System_Memory memory) {
@@ -138,10 +929,239 @@ static System_Exception Pentagon_IrqWait(uint64_t irq) {
     return NULL;
 }
 
+//
+// Native kernels for the span helpers of Corelib, the pointers are of blittable
+// elements only, the managed side falls back to loops for anything else
+//
+
+static System_Exception System_Buffer_Memmove(uint64_t dest, uint64_t src, uint64_t size) {
+    memmove((void*)dest, (void*)src, size);
+    return NULL;
+}
+
+static System_Exception System_Buffer_ZeroMemory(uint64_t dest, uint64_t size) {
+    memset((void*)dest, 0, size);
+    return NULL;
+}
+
+static System_Exception System_Buffer_Fill(uint64_t dest, uint64_t count, uint64_t element_size, uint64_t value) {
+    span_fill((void*)dest, count, element_size, (void*)value);
+    return NULL;
+}
+
+static method_result_t System_Buffer_IndexOf(uint64_t ptr, uint64_t count, uint64_t element_size, uint64_t value) {
+    size_t index = span_index_of((void*)ptr, count, element_size, (void*)value);
+    return (method_result_t){ .exception = NULL, .value = index == SPAN_NOT_FOUND ? (uintptr_t)-1 : index };
+}
+
+static method_result_t System_Buffer_SequenceEqual(uint64_t a, uint64_t b, uint64_t size) {
+    return (method_result_t){ .exception = NULL, .value = span_sequence_equal((void*)a, (void*)b, size) };
+}
+
+static method_result_t System_Environment_GetProcessorCount() {
+    return (method_result_t){ .exception = NULL, .value = get_cpu_count() };
+}
+
+static method_result_t System_Threading_Thread_GetCurrentProcessorId() {
+    return (method_result_t){ .exception = NULL, .value = get_cpu_id() };
+}
+
+static method_result_t System_Threading_Tasks_Task_GetNativeCurrentTask() {
+    return (method_result_t){ .exception = NULL, .value = (uintptr_t)get_current_thread()->tcb->current_task };
+}
+
+static System_Exception System_Threading_Tasks_Task_SetNativeCurrentTask(void* task) {
+    get_current_thread()->tcb->current_task = task;
+    return NULL;
+}
+
+static System_Exception System_Diagnostics_Debug_WriteFailure(System_String message) {
+    ERROR("Debug.Fail: %U", message);
+    return NULL;
+}
+
+//
+// ValueType equality, the bytes of a boxed value that are not references are compared
+// and hashed directly, the references are handed back to the managed code so it can use
+// their own Equals and GetHashCode. The value of a boxed object starts right after the
+// object header, and the offsets of the references are the ones the gc already uses.
+//
+
+static bool is_managed_pointer_offset(System_Type type, size_t offset) {
+    for (int i = 0; i < arrlen(type->ManagedPointersOffsets); i++) {
+        if (type->ManagedPointersOffsets[i] == offset) {
+            return true;
+        }
+    }
+    return false;
+}
+
+static method_result_t System_ValueType_ValueDataEquals(System_Object a, System_Object b) {
+    if (b == NULL || OBJECT_TYPE(a) != OBJECT_TYPE(b)) {
+        return (method_result_t){ .exception = NULL, .value = false };
+    }
+
+    System_Type type = OBJECT_TYPE(a);
+    uint8_t* data_a = (uint8_t*)(a + 1);
+    uint8_t* data_b = (uint8_t*)(b + 1);
+
+    // references are always aligned, so go a pointer at a time
+    // and compare the tail as bytes
+    size_t offset = 0;
+    for (; offset + sizeof(void*) <= type->ManagedSize; offset += sizeof(void*)) {
+        if (is_managed_pointer_offset(type, offset)) continue;
+        if (memcmp(data_a + offset, data_b + offset, sizeof(void*)) != 0) {
+            return (method_result_t){ .exception = NULL, .value = false };
+        }
+    }
+    bool equal = memcmp(data_a + offset, data_b + offset, type->ManagedSize - offset) == 0;
+
+    return (method_result_t){ .exception = NULL, .value = equal };
+}
+
+static method_result_t System_ValueType_GetValueDataHashCode(System_Object obj) {
+    System_Type type = OBJECT_TYPE(obj);
+    uint8_t* data = (uint8_t*)(obj + 1);
+
+    // FNV-1a over the bytes that are not references
+    uint32_t hash = 2166136261u;
+    for (size_t offset = 0; offset < type->ManagedSize; offset++) {
+        if ((offset % sizeof(void*)) == 0 && is_managed_pointer_offset(type, offset)) {
+            offset += sizeof(void*) - 1;
+            continue;
+        }
+        hash = (hash ^ data[offset]) * 16777619u;
+    }
+
+    return (method_result_t){ .exception = NULL, .value = (int32_t)hash };
+}
+
+static method_result_t System_ValueType_GetReferenceCount(System_Object obj) {
+    return (method_result_t){ .exception = NULL, .value = arrlen(OBJECT_TYPE(obj)->ManagedPointersOffsets) };
+}
+
+static method_result_t System_ValueType_GetReference(System_Object obj, int32_t index) {
+    System_Type type = OBJECT_TYPE(obj);
+    ASSERT(0 <= index && index < arrlen(type->ManagedPointersOffsets));
+    System_Object ref = *(System_Object*)((uint8_t*)(obj + 1) + type->ManagedPointersOffsets[index]);
+    return (method_result_t){ .exception = NULL, .value = (uintptr_t)ref };
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Managed timers
+//
+// The timer callbacks run from the scheduler with interrupts disabled, so they can't call into managed
+// code, instead the managed timer queue owns a single kernel timer that signals a waitable, and the queue
+// re-arms it for the earliest managed timer. The waitable only has a single slot, so all the expirations
+// that happen before the queue gets to run are coalesced into a single wakeup.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+static void managed_timer_fire(waitable_t* waitable, uintptr_t now) {
+    // non-blocking, if the queue was already signaled it will see this expiration as well
+    waitable_send(waitable, false);
+}
+
+static method_result_t System_Threading_TimerQueue_CreateNativeTimer(waitable_t* waitable) {
+    timer_t* timer = create_timer();
+    if (timer == NULL) {
+        return (method_result_t){ .exception = NULL, .value = 0 };
+    }
+
+    // the timer keeps its own reference to the waitable
+    timer->func = (timer_func_t)managed_timer_fire;
+    timer->arg = put_waitable(waitable);
+
+    return (method_result_t){ .exception = NULL, .value = (uintptr_t)timer };
+}
+
+static System_Exception System_Threading_TimerQueue_ChangeNativeTimer(timer_t* timer, int64_t due) {
+    if (due <= 0) {
+        timer_stop(timer);
+    } else {
+        timer_reset(timer, due);
+    }
+    return NULL;
+}
+
+static method_result_t System_Threading_TimerQueue_GetMicrotime() {
+    return (method_result_t){ .exception = NULL, .value = microtime() };
+}
+
+static method_result_t System_Threading_Monitor_EnterSlow(System_Object obj, uint32_t thread_id) {
+    return (method_result_t){ .exception = NULL, .value = monitor_enter(obj, thread_id) };
+}
+
+static method_result_t System_Threading_Monitor_ExitSlow(System_Object obj, uint32_t thread_id) {
+    return (method_result_t){ .exception = NULL, .value = monitor_exit(obj, thread_id) };
+}
+
+static method_result_t System_Threading_Monitor_WaitSlow(System_Object obj, uint32_t thread_id) {
+    return (method_result_t){ .exception = NULL, .value = monitor_wait(obj, thread_id) };
+}
+
+static method_result_t System_Threading_Monitor_PulseSlow(System_Object obj, uint32_t thread_id, bool all) {
+    return (method_result_t){ .exception = NULL, .value = monitor_pulse(obj, thread_id, all) };
+}
+
+typedef struct Pentagon_DriverServices_HeapInfo {
+    uint64_t CommittedBytes;
+    uint64_t UsedBytes;
+    uint64_t LiveObjects;
+    uint64_t Allocations;
+    uint64_t BumpAllocations;
+    uint64_t ReclaimedBytes;
+    uint64_t CollectionCount;
+    uint64_t LastPause;
+    uint64_t MaxPause;
+    uint64_t TotalPause;
+    uint64_t LastMark;
+    uint64_t LastSweep;
+    uint64_t LastReclaim;
+} Pentagon_DriverServices_HeapInfo;
+
+static System_Exception Pentagon_DriverServices_HeapStats_GetHeapInfo(Pentagon_DriverServices_HeapInfo* info) {
+    // too large for the stack
+    heap_stats_t* stats = malloc(sizeof(heap_stats_t));
+    if (stats == NULL) {
+        return NULL;
+    }
+    heap_get_stats(stats);
+
+    info->CommittedBytes = stats->committed_bytes;
+    info->UsedBytes = stats->used_bytes;
+    info->LiveObjects = stats->live_objects;
+    info->Allocations = stats->allocations;
+    info->BumpAllocations = stats->bump_allocations;
+    info->ReclaimedBytes = stats->reclaimed_bytes;
+    info->CollectionCount = stats->pause.count;
+    info->LastPause = stats->pause.last_us;
+    info->MaxPause = stats->pause.max_us;
+    info->TotalPause = stats->pause.total_us;
+    info->LastMark = stats->phases[HEAP_GC_PHASE_MARK].last_us;
+    info->LastSweep = stats->phases[HEAP_GC_PHASE_SWEEP].last_us;
+    info->LastReclaim = stats->phases[HEAP_GC_PHASE_RECLAIM].last_us;
+
+    free(stats);
+    return NULL;
+}
+
+static System_Exception Pentagon_DriverServices_HeapStats_GetPoolInfo(int pool, heap_pool_stats_t* info) {
+    heap_get_pool_stats(pool, info);
+    return NULL;
+}
+
+static System_Exception Pentagon_DriverServices_HeapStats_Dump() {
+    heap_dump_stats();
+    return NULL;
+}
+
 err_t init_kernel_internal_calls() {
     err_t err = NO_ERROR;
 
+    // the kernel resolves the externs of the kernel assembly and the
+    // [Corelib-v1] natives registered below (Buffer, Monitor, TimerQueue...)
     jit_add_extern_whitelist("Pentagon.dll");
+    jit_add_extern_whitelist("Corelib.dll");
     jit_add_generic_extern_hook( &m_jit_extern_hook);
 
     MIR_context_t ctx = jit_get_mir_context();
@@ -150,16 +1170,83 @@ err_t init_kernel_internal_calls() {
     MIR_load_external(ctx, "[Pentagon-v1]Pentagon.DriverServices.MemoryServices::UpdateMemory([Corelib-v1]System.Memory`1<uint8>&,object,uint64,int32)", Pentagon_HAL_MemoryServices_UpdateMemory);
     MIR_load_external(ctx, "[Pentagon-v1]Pentagon.DriverServices.MemoryServices::AllocateMemory(uint64)", Pentagon_HAL_MemoryServices_AllocateMemory);
     MIR_load_external(ctx, "[Pentagon-v1]Pentagon.DriverServices.MemoryServices::FreeMemory(uint64)", Pentagon_HAL_MemoryServices_FreeMemory);
-    MIR_load_external(ctx, "[Pentagon-v1]Pentagon.DriverServices.MemoryServices::MapMemory(uint64,uint64)", Pentagon_HAL_MemoryServices_MapMemory);
+    MIR_load_external(ctx, "[Pentagon-v1]Pentagon.DriverServices.MemoryServices::MapMemory(uint64,uint64,int32)", Pentagon_HAL_MemoryServices_MapMemory);
     MIR_load_external(ctx, "[Pentagon-v1]Pentagon.DriverServices.MemoryServices::GetMappedPhysicalAddress([Corelib-v1]System.Memory`1<uint8>)", Pentagon_GetMappedPhysicalAddress);
 
     MIR_load_external(ctx, "[Pentagon-v1]Pentagon.DriverServices.Log::LogHex(uint64)", Pentagon_DriverServices_Log_LogHex);
     MIR_load_external(ctx, "[Pentagon-v1]Pentagon.DriverServices.Log::LogString(string)", Pentagon_DriverServices_Log_LogString);
+    MIR_load_external(ctx, "[Pentagon-v1]Pentagon.DriverServices.Log::LogChars(char&,int32)", Pentagon_DriverServices_Log_LogChars);
 
     MIR_load_external(ctx, "[Pentagon-v1]Pentagon.DriverServices.Irq::AllocateIrq(int32,[Pentagon-v1]Pentagon.DriverServices.Irq+IrqMaskType,uint64)", Pentagon_AllocateIrq);
     MIR_load_external(ctx, "[Pentagon-v1]Pentagon.DriverServices.Irq::IrqWait(int32)", Pentagon_IrqWait);
 
-    MIR_load_external(ctx, "[Pentagon-v1]Pentagon.DriverServices.Acpi.Acpi::GetRsdt()", Pentagon_DriverServices_Acpi_GetRsdt);
+    MIR_load_external(ctx, "[Pentagon-v1]Pentagon.DriverServices.Acpi.Acpi::GetTables(int32&)", Pentagon_DriverServices_Acpi_GetTables);
+
+    MIR_load_external(ctx, "[Corelib-v1]System.Buffer::Memmove(uint64,uint64,uint64)", System_Buffer_Memmove);
+    MIR_load_external(ctx, "[Corelib-v1]System.Buffer::ZeroMemory(uint64,uint64)", System_Buffer_ZeroMemory);
+    MIR_load_external(ctx, "[Corelib-v1]System.Buffer::Fill(uint64,uint64,uint64,uint64)", System_Buffer_Fill);
+    MIR_load_external(ctx, "[Corelib-v1]System.Buffer::IndexOf(uint64,uint64,uint64,uint64)", System_Buffer_IndexOf);
+    MIR_load_external(ctx, "[Corelib-v1]System.Buffer::SequenceEqual(uint64,uint64,uint64)", System_Buffer_SequenceEqual);
+
+    MIR_load_external(ctx, "[Corelib-v1]System.Environment::GetProcessorCount()", System_Environment_GetProcessorCount);
+    MIR_load_external(ctx, "[Corelib-v1]System.Threading.Thread::GetCurrentProcessorId()", System_Threading_Thread_GetCurrentProcessorId);
+    MIR_load_external(ctx, "[Corelib-v1]System.Threading.Tasks.Task::GetNativeCurrentTask()", System_Threading_Tasks_Task_GetNativeCurrentTask);
+    MIR_load_external(ctx, "[Corelib-v1]System.Threading.Tasks.Task::SetNativeCurrentTask([Corelib-v1]System.Threading.Tasks.Task)", System_Threading_Tasks_Task_SetNativeCurrentTask);
+    MIR_load_external(ctx, "[Corelib-v1]System.Diagnostics.Debug::WriteFailure(string)", System_Diagnostics_Debug_WriteFailure);
+
+    MIR_load_external(ctx, "[Corelib-v1]System.ValueType::ValueDataEquals(object,object)", System_ValueType_ValueDataEquals);
+    MIR_load_external(ctx, "[Corelib-v1]System.ValueType::GetValueDataHashCode(object)", System_ValueType_GetValueDataHashCode);
+    MIR_load_external(ctx, "[Corelib-v1]System.ValueType::GetReferenceCount(object)", System_ValueType_GetReferenceCount);
+    MIR_load_external(ctx, "[Corelib-v1]System.ValueType::GetReference(object,int32)", System_ValueType_GetReference);
+
+    MIR_load_external(ctx, "[Corelib-v1]System.Threading.TimerQueue::CreateNativeTimer(uint64)", System_Threading_TimerQueue_CreateNativeTimer);
+    MIR_load_external(ctx, "[Corelib-v1]System.Threading.TimerQueue::ChangeNativeTimer(uint64,int64)", System_Threading_TimerQueue_ChangeNativeTimer);
+    MIR_load_external(ctx, "[Corelib-v1]System.Threading.TimerQueue::GetMicrotime()", System_Threading_TimerQueue_GetMicrotime);
+
+    MIR_load_external(ctx, "[Corelib-v1]System.Threading.Monitor::EnterSlow(object,uint32)", System_Threading_Monitor_EnterSlow);
+    MIR_load_external(ctx, "[Corelib-v1]System.Threading.Monitor::ExitSlow(object,uint32)", System_Threading_Monitor_ExitSlow);
+    MIR_load_external(ctx, "[Corelib-v1]System.Threading.Monitor::WaitSlow(object,uint32)", System_Threading_Monitor_WaitSlow);
+    MIR_load_external(ctx, "[Corelib-v1]System.Threading.Monitor::PulseSlow(object,uint32,bool)", System_Threading_Monitor_PulseSlow);
+
+    MIR_load_external(ctx, "jit_monitor_thread_id", jit_monitor_thread_id);
+
+    MIR_load_external(ctx, "jit_atomic_xadd32", jit_atomic_xadd32);
+    MIR_load_external(ctx, "jit_atomic_xadd64", jit_atomic_xadd64);
+    MIR_load_external(ctx, "jit_atomic_xchg32", jit_atomic_xchg32);
+    MIR_load_external(ctx, "jit_atomic_xchg64", jit_atomic_xchg64);
+    MIR_load_external(ctx, "jit_atomic_xchg_ref", jit_atomic_xchg_ref);
+    MIR_load_external(ctx, "jit_atomic_cmpxchg32", jit_atomic_cmpxchg32);
+    MIR_load_external(ctx, "jit_atomic_cmpxchg64", jit_atomic_cmpxchg64);
+    MIR_load_external(ctx, "jit_atomic_cmpxchg_ref", jit_atomic_cmpxchg_ref);
+    MIR_load_external(ctx, "jit_atomic_and32", jit_atomic_and32);
+    MIR_load_external(ctx, "jit_atomic_and64", jit_atomic_and64);
+    MIR_load_external(ctx, "jit_atomic_or32", jit_atomic_or32);
+    MIR_load_external(ctx, "jit_atomic_or64", jit_atomic_or64);
+    MIR_load_external(ctx, "jit_atomic_barrier", jit_atomic_barrier);
+    MIR_load_external(ctx, "jit_volatile_read8", jit_volatile_read8);
+    MIR_load_external(ctx, "jit_volatile_read16", jit_volatile_read16);
+    MIR_load_external(ctx, "jit_volatile_read32", jit_volatile_read32);
+    MIR_load_external(ctx, "jit_volatile_read64", jit_volatile_read64);
+    MIR_load_external(ctx, "jit_volatile_write8", jit_volatile_write8);
+    MIR_load_external(ctx, "jit_volatile_write16", jit_volatile_write16);
+    MIR_load_external(ctx, "jit_volatile_write32", jit_volatile_write32);
+    MIR_load_external(ctx, "jit_volatile_write64", jit_volatile_write64);
+    MIR_load_external(ctx, "jit_volatile_write_ref", jit_volatile_write_ref);
+
+    MIR_load_external(ctx, "jit_mmio_read8", jit_mmio_read8);
+    MIR_load_external(ctx, "jit_mmio_read16", jit_mmio_read16);
+    MIR_load_external(ctx, "jit_mmio_read32", jit_mmio_read32);
+    MIR_load_external(ctx, "jit_mmio_read64", jit_mmio_read64);
+    MIR_load_external(ctx, "jit_mmio_write8", jit_mmio_write8);
+    MIR_load_external(ctx, "jit_mmio_write16", jit_mmio_write16);
+    MIR_load_external(ctx, "jit_mmio_write32", jit_mmio_write32);
+    MIR_load_external(ctx, "jit_mmio_write64", jit_mmio_write64);
+
+    init_hw_intrinsics(ctx);
+
+    MIR_load_external(ctx, "[Pentagon-v1]Pentagon.DriverServices.HeapStats::GetHeapInfo([Pentagon-v1]Pentagon.DriverServices.HeapInfo&)", Pentagon_DriverServices_HeapStats_GetHeapInfo);
+    MIR_load_external(ctx, "[Pentagon-v1]Pentagon.DriverServices.HeapStats::GetPoolInfo(int32,[Pentagon-v1]Pentagon.DriverServices.HeapPoolInfo&)", Pentagon_DriverServices_HeapStats_GetPoolInfo);
+    MIR_load_external(ctx, "[Pentagon-v1]Pentagon.DriverServices.HeapStats::Dump()", Pentagon_DriverServices_HeapStats_Dump);
 
     MIR_module_t pentagon = MIR_new_module(ctx, "pentagon");
     MIR_load_external(ctx, "[Pentagon-v1]Pentagon.DriverServices.MemoryServices::GetSpanPtr([Corelib-v1]System.Span`1<uint8>&)", Pentagon_HAL_MemoryServices_MapMemory);
@@ -0,0 +1,299 @@
+#include "monitor.h"
+
+#include <dotnet/gc/gc.h>
+
+#include <sync/conditional.h>
+#include <sync/spinlock.h>
+#include <sync/mutex.h>
+#include <util/stb_ds.h>
+#include <mem/malloc.h>
+
+/**
+ * How many times to spin on a thin lock before inflating it, most critical
+ * sections are short enough that the owner will release it by then
+ */
+#define MONITOR_SPIN_COUNT          100
+
+#define SYNC_BLOCK_CHUNK_SIZE       256
+#define SYNC_BLOCK_CHUNK_COUNT      256
+
+typedef struct sync_block {
+    mutex_t mutex;
+    conditional_t conditional;
+
+    // the object that owns the block, used to find blocks of dead objects
+    System_Object object;
+
+    // set once the block is in the lock word of the object
+    atomic_bool installed;
+
+    // only written by the thread that holds the mutex
+    _Atomic(uint32_t) owner;
+    uint32_t recursion;
+} sync_block_t;
+
+/**
+ * The blocks are allocated in chunks that are never freed, so a block can
+ * be found from its index without taking any lock
+ */
+static sync_block_t* m_sync_blocks[SYNC_BLOCK_CHUNK_COUNT];
+
+/**
+ * The amount of block indexes that were ever handed out
+ */
+static uint32_t m_sync_block_count = 0;
+
+/**
+ * Indexes of blocks that can be reused
+ */
+static uint32_t* m_free_sync_blocks = NULL;
+
+/**
+ * Protects the allocation of blocks
+ */
+static spinlock_t m_sync_block_lock = INIT_SPINLOCK();
+
+static sync_block_t* get_sync_block(uint32_t index) {
+    return &m_sync_blocks[index / SYNC_BLOCK_CHUNK_SIZE][index % SYNC_BLOCK_CHUNK_SIZE];
+}
+
+/**
+ * Check if the object of the block is gone, the heap might have reclaimed the slot
+ * (or even unmapped it), so we need to check that it is still there before looking
+ * at the lock word
+ */
+static bool sync_block_is_dead(uint32_t index) {
+    sync_block_t* block = get_sync_block(index);
+    if (heap_find((uintptr_t)block->object) != block->object) return true;
+    if (block->object->color == COLOR_BLUE) return true;
+    return atomic_load(monitor_lock_word(block->object)) != (MONITOR_INFLATED | index);
+}
+
+static err_t alloc_sync_block(System_Object object, uint32_t* out_index) {
+    err_t err = NO_ERROR;
+
+    spinlock_lock(&m_sync_block_lock);
+
+    // we are about to start a new chunk, reclaim the blocks of dead objects first
+    if (arrlen(m_free_sync_blocks) == 0 && m_sync_block_count % SYNC_BLOCK_CHUNK_SIZE == 0) {
+        for (uint32_t i = 0; i < m_sync_block_count; i++) {
+            sync_block_t* block = get_sync_block(i);
+            if (block->object != NULL && atomic_load(&block->installed) && sync_block_is_dead(i)) {
+                block->object = NULL;
+                arrpush(m_free_sync_blocks, i);
+            }
+        }
+    }
+
+    uint32_t index;
+    if (arrlen(m_free_sync_blocks) != 0) {
+        index = arrpop(m_free_sync_blocks);
+    } else {
+        CHECK_ERROR(m_sync_block_count < SYNC_BLOCK_CHUNK_SIZE * SYNC_BLOCK_CHUNK_COUNT, ERROR_OUT_OF_MEMORY);
+
+        if (m_sync_block_count % SYNC_BLOCK_CHUNK_SIZE == 0) {
+            sync_block_t* chunk = malloc(sizeof(sync_block_t) * SYNC_BLOCK_CHUNK_SIZE);
+            CHECK_ERROR(chunk != NULL, ERROR_OUT_OF_MEMORY);
+            m_sync_blocks[m_sync_block_count / SYNC_BLOCK_CHUNK_SIZE] = chunk;
+        }
+
+        index = m_sync_block_count++;
+    }
+
+    sync_block_t* block = get_sync_block(index);
+    *block = (sync_block_t){
+        .mutex = INIT_MUTEX(),
+        .conditional = INIT_CONDITIONAL(),
+        .object = object,
+    };
+    *out_index = index;
+
+cleanup:
+    spinlock_unlock(&m_sync_block_lock);
+
+    return err;
+}
+
+static void free_sync_block(uint32_t index) {
+    spinlock_lock(&m_sync_block_lock);
+    get_sync_block(index)->object = NULL;
+    arrpush(m_free_sync_blocks, index);
+    spinlock_unlock(&m_sync_block_lock);
+}
+
+/**
+ * Inflate a thin lock that is held by some thread, the block starts out locked
+ * on behalf of that thread, so its exit will go through the block.
+ *
+ * If the lock word changed in the meanwhile nothing is done, the caller should
+ * look at the lock word again.
+ */
+static err_t monitor_inflate(System_Object object, _Atomic(uint64_t)* word, uint64_t value) {
+    err_t err = NO_ERROR;
+
+    uint32_t index;
+    CHECK_AND_RETHROW(alloc_sync_block(object, &index));
+    sync_block_t* block = get_sync_block(index);
+
+    // a new mutex, this won't block
+    mutex_lock(&block->mutex);
+    atomic_store(&block->owner, value & MONITOR_OWNER_MASK);
+    block->recursion = value >> MONITOR_RECURSION_SHIFT;
+
+    if (atomic_compare_exchange_strong(word, &value, MONITOR_INFLATED | index)) {
+        atomic_store(&block->installed, true);
+    } else {
+        free_sync_block(index);
+    }
+
+cleanup:
+    return err;
+}
+
+/**
+ * Get the block of the object, inflating the lock if needed, the current thread must own the lock
+ */
+static err_t monitor_get_owned_block(System_Object object, uint32_t thread_id, sync_block_t** out_block) {
+    err_t err = NO_ERROR;
+    _Atomic(uint64_t)* word = monitor_lock_word(object);
+
+    while (true) {
+        uint64_t value = atomic_load(word);
+        if (value & MONITOR_INFLATED) {
+            sync_block_t* block = get_sync_block(value & MONITOR_OWNER_MASK);
+            CHECK_ERROR(atomic_load(&block->owner) == thread_id, ERROR_SYNCHRONIZATION_LOCK);
+            *out_block = block;
+            break;
+        }
+
+        CHECK_ERROR((value & MONITOR_OWNER_MASK) == thread_id, ERROR_SYNCHRONIZATION_LOCK);
+        CHECK_AND_RETHROW(monitor_inflate(object, word, value));
+    }
+
+cleanup:
+    return err;
+}
+
+err_t monitor_enter(System_Object object, uint32_t thread_id) {
+    err_t err = NO_ERROR;
+    _Atomic(uint64_t)* word = monitor_lock_word(object);
+
+    for (int spin = 0; ; spin++) {
+        uint64_t value = atomic_load(word);
+
+        if (value & MONITOR_INFLATED) {
+            sync_block_t* block = get_sync_block(value & MONITOR_OWNER_MASK);
+            if (atomic_load(&block->owner) == thread_id) {
+                block->recursion++;
+            } else {
+                mutex_lock(&block->mutex);
+                atomic_store(&block->owner, thread_id);
+                block->recursion = 0;
+            }
+            break;
+        }
+
+        if (value == 0) {
+            if (atomic_compare_exchange_weak(word, &value, thread_id)) {
+                break;
+            }
+            continue;
+        }
+
+        if ((value & MONITOR_OWNER_MASK) == thread_id) {
+            if ((value >> MONITOR_RECURSION_SHIFT) < MONITOR_RECURSION_MAX) {
+                if (atomic_compare_exchange_weak(word, &value, value + MONITOR_RECURSION_UNIT)) {
+                    break;
+                }
+                continue;
+            }
+
+            // out of recursion bits, the block has a full counter
+            CHECK_AND_RETHROW(monitor_inflate(object, word, value));
+            continue;
+        }
+
+        // held by someone else, give a short critical section a chance to end
+        if (spin < MONITOR_SPIN_COUNT) {
+            __builtin_ia32_pause();
+            continue;
+        }
+
+        // contended, inflate so we can sleep on the mutex
+        CHECK_AND_RETHROW(monitor_inflate(object, word, value));
+    }
+
+cleanup:
+    return err;
+}
+
+err_t monitor_exit(System_Object object, uint32_t thread_id) {
+    err_t err = NO_ERROR;
+    _Atomic(uint64_t)* word = monitor_lock_word(object);
+
+    while (true) {
+        uint64_t value = atomic_load(word);
+
+        if (value & MONITOR_INFLATED) {
+            sync_block_t* block = get_sync_block(value & MONITOR_OWNER_MASK);
+            CHECK_ERROR(atomic_load(&block->owner) == thread_id, ERROR_SYNCHRONIZATION_LOCK);
+            if (block->recursion != 0) {
+                block->recursion--;
+            } else {
+                atomic_store(&block->owner, 0);
+                mutex_unlock(&block->mutex);
+            }
+            break;
+        }
+
+        CHECK_ERROR((value & MONITOR_OWNER_MASK) == thread_id, ERROR_SYNCHRONIZATION_LOCK);
+
+        uint64_t new_value = (value >> MONITOR_RECURSION_SHIFT) != 0 ? value - MONITOR_RECURSION_UNIT : 0;
+        if (atomic_compare_exchange_weak(word, &value, new_value)) {
+            break;
+        }
+    }
+
+cleanup:
+    return err;
+}
+
+err_t monitor_wait(System_Object object, uint32_t thread_id) {
+    err_t err = NO_ERROR;
+
+    sync_block_t* block;
+    CHECK_AND_RETHROW(monitor_get_owned_block(object, thread_id, &block));
+
+    // fully release the lock while waiting, and restore it afterwards
+    uint32_t recursion = block->recursion;
+    atomic_store(&block->owner, 0);
+    conditional_wait(&block->conditional, &block->mutex);
+    atomic_store(&block->owner, thread_id);
+    block->recursion = recursion;
+
+cleanup:
+    return err;
+}
+
+err_t monitor_pulse(System_Object object, uint32_t thread_id, bool all) {
+    err_t err = NO_ERROR;
+
+    // a thin lock never had anyone wait on it, no need to inflate
+    uint64_t value = atomic_load(monitor_lock_word(object));
+    if (!(value & MONITOR_INFLATED)) {
+        CHECK_ERROR((value & MONITOR_OWNER_MASK) == thread_id, ERROR_SYNCHRONIZATION_LOCK);
+        goto cleanup;
+    }
+
+    sync_block_t* block;
+    CHECK_AND_RETHROW(monitor_get_owned_block(object, thread_id, &block));
+
+    if (all) {
+        conditional_broadcast(&block->conditional);
+    } else {
+        conditional_signal(&block->conditional);
+    }
+
+cleanup:
+    return err;
+}
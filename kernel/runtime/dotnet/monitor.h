@@ -0,0 +1,84 @@
+#pragma once
+
+#include <dotnet/gc/heap.h>
+
+#include <util/except.h>
+#include <mem/mem.h>
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+//
+// Thin locks for Monitor, every slot of the object heap has a lock word in the lock table, each
+// pool gets SIZE_256GB of the table (enough for the 16 byte pool) and the slot index inside of the
+// pool picks the word, so the word of an object is found with the same address math the heap uses
+// to find the slot size, without taking any space from the slot itself. While the lock is not
+// contended the word holds the id of the owner thread and the recursion count, and the managed code
+// takes and releases it with a single compare exchange. Once a thread has to wait for the lock (or
+// someone calls Wait/Pulse) the word is inflated into an index of a sync block, which has a real
+// mutex and conditional, and stays inflated for the lifetime of the object.
+//
+// Most objects are never locked, so the pages of the table are not committed with the heap, the
+// page fault handler commits a zeroed page on the first access to it, which is the first lock of
+// any object that has its word in the page.
+//
+
+#define MONITOR_OWNER_MASK          0xFFFFFFFFull
+#define MONITOR_RECURSION_SHIFT     32
+#define MONITOR_RECURSION_UNIT      (1ull << MONITOR_RECURSION_SHIFT)
+#define MONITOR_RECURSION_MAX       0x7FFFFFFFull
+#define MONITOR_INFLATED            (1ull << 63)
+
+#define MONITOR_LOCK_WORD_SIZE      sizeof(uint64_t)
+
+/**
+ * Get the lock word of an object from the lock table
+ */
+static inline _Atomic(uint64_t)* monitor_lock_word(System_Object object) {
+    uintptr_t offset = (uintptr_t)object - OBJECT_HEAP_START;
+    uintptr_t pool_idx = offset / SIZE_512GB;
+    uintptr_t slot_idx = (offset % SIZE_512GB) >> (4 + pool_idx);
+    return (_Atomic(uint64_t)*)(LOCK_TABLE_START + pool_idx * SIZE_256GB + slot_idx * MONITOR_LOCK_WORD_SIZE);
+}
+
+/**
+ * Reset the lock word of a newly allocated object, the word was left over from the
+ * last object in the slot. If the page of the word was never committed then no object
+ * in it was ever locked, and it will be committed zeroed, so it is not touched.
+ */
+static inline void monitor_reset(System_Object object) {
+    _Atomic(uint64_t)* word = monitor_lock_word(object);
+    if (vmm_is_mapped((uintptr_t)word)) {
+        atomic_store_explicit(word, 0, memory_order_relaxed);
+    }
+}
+
+/**
+ * The slow path of Monitor.Enter, called once the compare exchange of the managed code failed
+ *
+ * @param object        [IN] The object to lock
+ * @param thread_id     [IN] The id of the current thread
+ */
+err_t monitor_enter(System_Object object, uint32_t thread_id);
+
+/**
+ * The slow path of Monitor.Exit
+ *
+ * @param object        [IN] The object to unlock
+ * @param thread_id     [IN] The id of the current thread
+ *
+ * @retval ERROR_SYNCHRONIZATION_LOCK   The current thread does not own the lock
+ */
+err_t monitor_exit(System_Object object, uint32_t thread_id);
+
+/**
+ * Release the lock and wait until someone pulses the object, the lock is taken
+ * again (with the same recursion count) before returning
+ */
+err_t monitor_wait(System_Object object, uint32_t thread_id);
+
+/**
+ * Wake one (or all) of the threads waiting on the object
+ */
+err_t monitor_pulse(System_Object object, uint32_t thread_id, bool all);
@@ -30,7 +30,8 @@ err_t init_cpu_locals() {
     // set the base in here, for easy access in the future
     m_per_cpu_base = ptr;
 
-    // setup the list of per cpu bases
+    // setup the list of per cpu bases, the bsp gets here before
+    // any other cpu is started so there is no race on this
     if (m_per_cpu_base_list == NULL) {
         m_per_cpu_base_list = early_palloc(sizeof(void*) * get_cpu_count());
     }
@@ -343,12 +343,32 @@ retry:
     // super important, the tcb itself must not be cleared, the gc
     // relies on the values to be consistent!
     memset((void*)((uintptr_t)thread->tcb - m_tls_size), 0, m_tls_size);
+    thread->tcb->current_task = NULL;
 
 cleanup:
     scheduler_preempt_enable();
+
+    // the thread gave its stack back when it died
+    if (thread != NULL && thread->stack_top == NULL) {
+        thread->stack_top = alloc_stack();
+        if (thread->stack_top == NULL) {
+            spinlock_lock(&m_global_free_threads_lock);
+            thread_list_push(&m_global_free_threads, thread);
+            m_global_free_threads_count++;
+            spinlock_unlock(&m_global_free_threads_lock);
+            thread = NULL;
+        }
+    }
+
     return thread;
 }
 
+/**
+ * The next thread id, the ids are never reused so the monitor can use them
+ * as the owner of a thin lock even after the owner thread is gone
+ */
+static _Atomic(uint64_t) m_next_thread_id = 1;
+
 static thread_t* alloc_thread() {
     err_t err = NO_ERROR;
 
@@ -365,6 +385,7 @@ static thread_t* alloc_thread() {
 
     // set the tcb base in the tcb (part of sysv)
     thread->tcb->tcb = thread->tcb;
+    thread->tcb->current_task = NULL;
 
 cleanup:
     if (IS_ERROR(err)) {
@@ -381,6 +402,12 @@ cleanup:
 }
 
 thread_t* create_thread(thread_entry_t entry, void* ctx, const char* fmt, ...) {
+    uint64_t id = atomic_fetch_add_explicit(&m_next_thread_id, 1, memory_order_relaxed);
+    if (id > UINT32_MAX) {
+        WARN("thread: out of thread ids");
+        return NULL;
+    }
+
     thread_t* thread = get_free_thread();
     if (thread == NULL) {
         thread = alloc_thread();
@@ -396,6 +423,8 @@ thread_t* create_thread(thread_entry_t entry, void* ctx, const char* fmt, ...) {
     vsnprintf(thread->name, sizeof(thread->name), fmt, ap);
     va_end(ap);
 
+    thread->id = id;
+
     // thread starts with a single reference that is considered to belong to the scheduler
     // that means that the caller should not actually release the thread on its own, but only
     // if he plans to continue using it after the thread_ready
@@ -453,6 +482,13 @@ void release_thread(thread_t* thread) {
         // the last ref should only come after the thread is dead
         ASSERT(thread->status == THREAD_STATUS_DEAD);
 
+        // don't keep a stack that went deep around with the thread, it gets
+        // a new one when it is reused and the pages of this one are reclaimed
+        if (stack_is_deep(thread->stack_top)) {
+            free_stack(thread->stack_top, true);
+            thread->stack_top = NULL;
+        }
+
         thread_list_t* free_threads = get_cpu_local_base(&m_free_threads);
 
         // add to the list
@@ -487,7 +523,9 @@ void reclaim_free_threads() {
         free(tcb);
 
         // free the stack
-        free_stack(thread->stack_top);
+        if (thread->stack_top != NULL) {
+            free_stack(thread->stack_top, stack_is_deep(thread->stack_top));
+        }
 
         // free the thread itself
         free(thread);
@@ -139,6 +139,10 @@ typedef struct thread_control_block {
 
     // the managed thread instance for this thread
     void* managed_thread;
+
+    // the task currently running on this thread, the task is kept
+    // alive by the frame that runs it so the gc doesn't need to see it
+    void* current_task;
 } thread_control_block_t;
 
 typedef struct waiting_thread waiting_thread_t;
@@ -147,6 +151,10 @@ typedef struct thread {
     // the thread name
     char name[64];
 
+    // unique id of the thread, a new one is given every time a thread
+    // is created and it is never reused, zero is never a valid id
+    uint32_t id;
+
     // ref count
     atomic_size_t ref_count;
 
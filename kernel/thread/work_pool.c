@@ -0,0 +1,151 @@
+#include "work_pool.h"
+
+#include <thread/scheduler.h>
+#include <thread/thread.h>
+#include <sync/conditional.h>
+#include <sync/wait_group.h>
+#include <sync/mutex.h>
+#include <mem/malloc.h>
+#include <util/string.h>
+
+#include <stdatomic.h>
+
+/**
+ * The size of the work queue, each entry is a worker helping with a batch
+ * so we never need more than a single entry per worker per batch
+ */
+#define WORK_POOL_QUEUE_SIZE    64
+
+typedef struct work_pool_batch {
+    work_pool_func_t func;
+    void* ctx;
+    size_t count;
+
+    // the next item to claim
+    atomic_size_t next;
+
+    // the workers that were asked to help with the batch
+    wait_group_t wg;
+} work_pool_batch_t;
+
+struct work_pool {
+    // the work queue, each entry asks a single worker to help with a batch
+    mutex_t lock;
+    conditional_t not_empty;
+    conditional_t not_full;
+    work_pool_batch_t* queue[WORK_POOL_QUEUE_SIZE];
+    int queue_head;
+    int queue_len;
+
+    // the workers of the pool
+    int worker_count;
+    thread_t* workers[];
+};
+
+static void run_batch(work_pool_batch_t* batch) {
+    size_t index;
+    while ((index = atomic_fetch_add(&batch->next, 1)) < batch->count) {
+        batch->func(batch->ctx, index);
+    }
+}
+
+static void work_pool_worker(work_pool_t* pool) {
+    while (true) {
+        mutex_lock(&pool->lock);
+        while (pool->queue_len == 0) {
+            conditional_wait(&pool->not_empty, &pool->lock);
+        }
+        work_pool_batch_t* batch = pool->queue[pool->queue_head];
+        pool->queue_head = (pool->queue_head + 1) % WORK_POOL_QUEUE_SIZE;
+        pool->queue_len--;
+        conditional_signal(&pool->not_full);
+        mutex_unlock(&pool->lock);
+
+        // the batch is alive until we mark that we are done with it
+        run_batch(batch);
+        wait_group_done(&batch->wg);
+    }
+}
+
+static bool is_pool_worker(work_pool_t* pool) {
+    thread_t* current = get_current_thread();
+    for (int i = 0; i < pool->worker_count; i++) {
+        if (pool->workers[i] == current) {
+            return true;
+        }
+    }
+    return false;
+}
+
+work_pool_t* create_work_pool(int worker_count, const char* name) {
+    work_pool_t* pool = malloc(sizeof(work_pool_t) + worker_count * sizeof(thread_t*));
+    if (pool == NULL) {
+        return NULL;
+    }
+    memset(pool, 0, sizeof(work_pool_t) + worker_count * sizeof(thread_t*));
+
+    // the workers are never destroyed, so if we failed to create some
+    // of them we will just work with less workers
+    for (int i = 0; i < worker_count; i++) {
+        thread_t* thread = create_thread((void*)work_pool_worker, pool, "%s-%d", name, i);
+        if (thread == NULL) {
+            WARN("work-pool: failed to create worker %s-%d", name, i);
+            break;
+        }
+        pool->workers[pool->worker_count++] = thread;
+        scheduler_ready_thread(thread);
+    }
+
+    return pool;
+}
+
+int work_pool_get_worker_count(work_pool_t* pool) {
+    return pool->worker_count;
+}
+
+void work_pool_parallel_for(work_pool_t* pool, size_t count, work_pool_func_t func, void* ctx) {
+    if (count == 0) {
+        return;
+    }
+
+    work_pool_batch_t batch = {
+        .func = func,
+        .ctx = ctx,
+        .count = count,
+        .next = 0,
+        .wg = INIT_WAIT_GROUP(),
+    };
+
+    // a worker can't wait on other workers, since they might all end up
+    // waiting on each other, so just do it inline
+    int helpers = 0;
+    if (!is_pool_worker(pool)) {
+        helpers = (int)MIN(count - 1, (size_t)pool->worker_count);
+    }
+
+    // ask for help
+    if (helpers > 0) {
+        wait_group_add(&batch.wg, helpers);
+
+        mutex_lock(&pool->lock);
+        for (int i = 0; i < helpers; i++) {
+            while (pool->queue_len == WORK_POOL_QUEUE_SIZE) {
+                conditional_wait(&pool->not_full, &pool->lock);
+            }
+            int tail = (pool->queue_head + pool->queue_len) % WORK_POOL_QUEUE_SIZE;
+            pool->queue[tail] = &batch;
+            pool->queue_len++;
+            conditional_signal(&pool->not_empty);
+        }
+        mutex_unlock(&pool->lock);
+    }
+
+    // do our part
+    run_batch(&batch);
+
+    // wait for everyone who was asked to help to finish, even if all the
+    // items were already claimed they still reference the batch
+    if (helpers > 0) {
+        wait_group_wait(&batch.wg);
+    }
+}
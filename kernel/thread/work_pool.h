@@ -0,0 +1,44 @@
+#pragma once
+
+#include <util/except.h>
+
+#include <stddef.h>
+
+/**
+ * A single unit of work, called with the index of the item
+ */
+typedef void (*work_pool_func_t)(void* ctx, size_t index);
+
+typedef struct work_pool work_pool_t;
+
+/**
+ * Create a new pool of worker threads
+ *
+ * @param worker_count  [IN] The amount of workers, can be zero in which case all
+ *                           the work is done by the caller
+ * @param name          [IN] The name of the pool, workers are named <name>-<index>
+ */
+work_pool_t* create_work_pool(int worker_count, const char* name);
+
+/**
+ * Get the amount of workers in the pool, the calling thread of
+ * work_pool_parallel_for is not counted
+ */
+int work_pool_get_worker_count(work_pool_t* pool);
+
+/**
+ * Run the function on all the indices in the range [0, count), spreading
+ * the work across the pool. The caller takes part in the work and returns
+ * only once all the items were processed.
+ *
+ * Items are claimed one at a time, so items of different cost are balanced
+ * between the workers.
+ *
+ * When called from a worker of the same pool the items are processed inline.
+ *
+ * @param pool      [IN] The pool
+ * @param count     [IN] The amount of items
+ * @param func      [IN] The function to call on every item
+ * @param ctx       [IN] Passed to the function
+ */
+void work_pool_parallel_for(work_pool_t* pool, size_t count, work_pool_func_t func, void* ctx);
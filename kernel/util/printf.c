@@ -947,6 +947,33 @@ static NO_SANITIZE int _vsnprintf(out_fct_type out, char* buffer, const size_t m
             break;
         }
 
+        case 'W' : {
+            // utf16 chars that are not a string, the precision is the count, anything
+            // outside of ascii is printed as a '?'
+            const System_Char* p = va_arg(va, const System_Char*);
+            unsigned int l = (flags & FLAGS_PRECISION) ? precision : 0;
+
+            if (!(flags & FLAGS_LEFT)) {
+                while (l++ < width) {
+                    out(' ', buffer, idx++, maxlen);
+                }
+            }
+
+            while ((flags & FLAGS_PRECISION) && precision--) {
+                System_Char c = *(p++);
+                out(c < 0x80 ? (char)c : '?', buffer, idx++, maxlen);
+            }
+
+            if (flags & FLAGS_LEFT) {
+                while (l++ < width) {
+                    out(' ', buffer, idx++, maxlen);
+                }
+            }
+
+            format++;
+            break;
+        }
+
       case 'p' : {
         width = sizeof(void*) * 2U;
         flags |= FLAGS_ZEROPAD | FLAGS_UPPERCASE;
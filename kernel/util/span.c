@@ -0,0 +1,122 @@
+#include "span.h"
+
+#include <util/string.h>
+#include <util/defs.h>
+
+typedef char i8x16 __attribute__((vector_size(16)));
+typedef uint8_t u8x16 __attribute__((vector_size(16)));
+typedef uint16_t u16x8 __attribute__((vector_size(16)));
+typedef uint32_t u32x4 __attribute__((vector_size(16)));
+typedef uint64_t u64x2 __attribute__((vector_size(16)));
+
+/**
+ * Get a mask with a bit per byte of the comparison result
+ */
+#define VECTOR_MASK(cmp) __builtin_ia32_pmovmskb128((i8x16)(cmp))
+
+/**
+ * Search 16 bytes at a time, the mask has a bit per byte so the index
+ * of the element is the index of the first bit divided by the element size
+ */
+#define SPAN_INDEX_OF(vector_type, ptr, count, value) \
+    do { \
+        size_t __i = 0; \
+        vector_type __needle = (vector_type){} + (value); \
+        const size_t __per_vector = sizeof(vector_type) / sizeof(*(ptr)); \
+        for (; __i + __per_vector <= (count); __i += __per_vector) { \
+            vector_type __chunk; \
+            __builtin_memcpy(&__chunk, (ptr) + __i, sizeof(__chunk)); \
+            int __mask = VECTOR_MASK(__chunk == __needle); \
+            if (__mask != 0) { \
+                return __i + __builtin_ctz(__mask) / sizeof(*(ptr)); \
+            } \
+        } \
+        for (; __i < (count); __i++) { \
+            if ((ptr)[__i] == (value)) { \
+                return __i; \
+            } \
+        } \
+        return SPAN_NOT_FOUND; \
+    } while (0)
+
+size_t span_index_of8(const uint8_t* ptr, size_t count, uint8_t value) {
+    SPAN_INDEX_OF(u8x16, ptr, count, value);
+}
+
+size_t span_index_of16(const uint16_t* ptr, size_t count, uint16_t value) {
+    SPAN_INDEX_OF(u16x8, ptr, count, value);
+}
+
+size_t span_index_of32(const uint32_t* ptr, size_t count, uint32_t value) {
+    SPAN_INDEX_OF(u32x4, ptr, count, value);
+}
+
+size_t span_index_of64(const uint64_t* ptr, size_t count, uint64_t value) {
+    SPAN_INDEX_OF(u64x2, ptr, count, value);
+}
+
+size_t span_index_of(const void* ptr, size_t count, size_t element_size, const void* value) {
+    switch (element_size) {
+        case 1: return span_index_of8(ptr, count, *(const uint8_t*)value);
+        case 2: return span_index_of16(ptr, count, *(const uint16_t*)value);
+        case 4: return span_index_of32(ptr, count, *(const uint32_t*)value);
+        case 8: return span_index_of64(ptr, count, *(const uint64_t*)value);
+        default: {
+            const uint8_t* element = ptr;
+            for (size_t i = 0; i < count; i++, element += element_size) {
+                if (memcmp(element, value, element_size) == 0) {
+                    return i;
+                }
+            }
+            return SPAN_NOT_FOUND;
+        }
+    }
+}
+
+void span_fill(void* ptr, size_t count, size_t element_size, const void* value) {
+    uint8_t* dest = ptr;
+    size_t size = count * element_size;
+
+    if (count == 0) {
+        return;
+    }
+
+    switch (element_size) {
+        case 1: {
+            memset(dest, *(const uint8_t*)value, count);
+        } break;
+
+        case 2:
+        case 4:
+        case 8:
+        case 16: {
+            // repeat the element over a whole vector, since every store is at
+            // a multiple of 16 bytes the pattern always starts on an element
+            u8x16 pattern;
+            for (size_t i = 0; i < sizeof(pattern); i += element_size) {
+                __builtin_memcpy((uint8_t*)&pattern + i, value, element_size);
+            }
+
+            size_t i = 0;
+            for (; i + sizeof(pattern) <= size; i += sizeof(pattern)) {
+                __builtin_memcpy(dest + i, &pattern, sizeof(pattern));
+            }
+            memcpy(dest + i, &pattern, size - i);
+        } break;
+
+        default: {
+            // set the first element and keep doubling the filled part
+            memcpy(dest, value, element_size);
+            size_t filled = element_size;
+            while (filled < size) {
+                size_t chunk = MIN(filled, size - filled);
+                memcpy(dest + filled, dest, chunk);
+                filled += chunk;
+            }
+        } break;
+    }
+}
+
+bool span_sequence_equal(const void* a, const void* b, size_t size) {
+    return memcmp(a, b, size) == 0;
+}
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stddef.h>
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Native kernels for spans of blittable elements, these are used by the managed Span/Array
+// helpers, so they work on element counts and sizes instead of raw byte lengths. The searches
+// use SSE2 and check 16 bytes at a time.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * Returned by the searches when the value is not found
+ */
+#define SPAN_NOT_FOUND ((size_t)-1)
+
+/**
+ * Find the first element equal to the value, elements are compared bitwise
+ *
+ * @param ptr           [IN] The first element
+ * @param count         [IN] The amount of elements
+ * @param element_size  [IN] The size of a single element
+ * @param value         [IN] Pointer to the value to search for
+ */
+size_t span_index_of(const void* ptr, size_t count, size_t element_size, const void* value);
+
+size_t span_index_of8(const uint8_t* ptr, size_t count, uint8_t value);
+size_t span_index_of16(const uint16_t* ptr, size_t count, uint16_t value);
+size_t span_index_of32(const uint32_t* ptr, size_t count, uint32_t value);
+size_t span_index_of64(const uint64_t* ptr, size_t count, uint64_t value);
+
+/**
+ * Set all the elements to the given value
+ *
+ * @param ptr           [IN] The first element
+ * @param count         [IN] The amount of elements
+ * @param element_size  [IN] The size of a single element
+ * @param value         [IN] Pointer to the value to fill with, must not be inside the span
+ */
+void span_fill(void* ptr, size_t count, size_t element_size, const void* value);
+
+/**
+ * Compare two byte ranges for equality
+ */
+bool span_sequence_equal(const void* a, const void* b, size_t size);
@@ -4,6 +4,12 @@
 #include <stdbool.h>
 #include <limits.h>
 
+#include <arch/cpuid.h>
+#include <util/except.h>
+#include <util/defs.h>
+#include <mem/phys.h>
+#include <time/tsc.h>
+
 #define alias_load(T, p) \
     ({ \
         T value; \
@@ -19,7 +25,160 @@
         p += sizeof(T); \
     } while (0);
 
+//
+// The mem* functions are tiered by size:
+//  - up to 32 bytes, two overlapping loads and stores of the largest size that fits
+//  - medium sizes, 16 byte SSE2 vectors, with the destination aligned and the tail
+//    done with a single overlapping store
+//  - large sizes, rep movsb/stosb if the cpu has ERMS (or FSRM, which makes it good
+//    even for short copies)
+//  - huge clears, non-temporal stores so we won't evict the whole cache
+//
+// The cpu features are checked once at boot, before that the SSE2 variants are used.
+//
+
+typedef char v16 __attribute__((vector_size(16)));
+typedef long long v2di __attribute__((vector_size(16)));
+
+/**
+ * From this size rep movsb/stosb is used when the cpu has ERMS
+ */
+#define REP_MOVSB_THRESHOLD     SIZE_2KB
+
+/**
+ * From this size rep movsb is used when the cpu has FSRM
+ */
+#define FSRM_THRESHOLD          128
+
+/**
+ * From this size memset will bypass the cache
+ */
+#define NON_TEMPORAL_THRESHOLD  SIZE_4MB
+
+static bool m_string_erms = false;
+static bool m_string_fsrm = false;
+
+void init_string() {
+    uint32_t max_leaf = 0;
+    cpuid(0, &max_leaf, NULL, NULL, NULL);
+    if (max_leaf < CPUID_STRUCTURED_EXTENDED_FEATURE_FLAGS) {
+        return;
+    }
+
+    cpuid_structured_extended_feature_flags_ebx_t ebx = { 0 };
+    cpuid_structured_extended_feature_flags_edx_t edx = { 0 };
+    cpuidex(CPUID_STRUCTURED_EXTENDED_FEATURE_FLAGS, 0, NULL, &ebx.packed, NULL, &edx.packed);
+    m_string_erms = ebx.ERMS;
+    m_string_fsrm = edx.FSRM;
+}
+
+bool string_has_erms() {
+    return m_string_erms;
+}
+
+bool string_has_fsrm() {
+    return m_string_fsrm;
+}
+
+/**
+ * Copy up to 32 bytes, everything is loaded before anything is stored
+ * so this is also safe for overlapping buffers
+ */
+static inline void copy_small(unsigned char* d, const unsigned char* s, size_t n) {
+    if (n >= 16) {
+        v16 a = alias_load(v16, s);
+        s += n - 32;
+        v16 b = alias_load(v16, s);
+        alias_store(v16, d, a);
+        d += n - 32;
+        alias_store(v16, d, b);
+    } else if (n >= 8) {
+        uint64_t a = alias_load(uint64_t, s);
+        s += n - 16;
+        uint64_t b = alias_load(uint64_t, s);
+        alias_store(uint64_t, d, a);
+        d += n - 16;
+        alias_store(uint64_t, d, b);
+    } else if (n >= 4) {
+        uint32_t a = alias_load(uint32_t, s);
+        s += n - 8;
+        uint32_t b = alias_load(uint32_t, s);
+        alias_store(uint32_t, d, a);
+        d += n - 8;
+        alias_store(uint32_t, d, b);
+    } else if (n >= 2) {
+        uint16_t a = alias_load(uint16_t, s);
+        s += n - 4;
+        uint16_t b = alias_load(uint16_t, s);
+        alias_store(uint16_t, d, a);
+        d += n - 4;
+        alias_store(uint16_t, d, b);
+    } else if (n == 1) {
+        *d = *s;
+    }
+}
+
+void* memcpy_sse(void* restrict dest, const void* restrict src, size_t n) {
+    unsigned char* d = dest;
+    const unsigned char* s = src;
+
+    if (n <= 32) {
+        copy_small(d, s, n);
+        return dest;
+    }
+
+    // the first and last vectors are done unaligned, the rest
+    // is done with aligned stores
+    const unsigned char* tail_src = s + n - 16;
+    v16 head = alias_load(v16, s);
+    v16 tail = alias_load(v16, tail_src);
+
+    size_t skip = 16 - ((uintptr_t)d & 15);
+    unsigned char* end = d + n - 16;
+    unsigned char* cur = d + skip;
+    s = (const unsigned char*)src + skip;
+
+    while (cur + 64 <= end) {
+        v16 w1 = alias_load(v16, s);
+        v16 w2 = alias_load(v16, s);
+        v16 w3 = alias_load(v16, s);
+        v16 w4 = alias_load(v16, s);
+        *(v16*)(cur + 0) = w1;
+        *(v16*)(cur + 16) = w2;
+        *(v16*)(cur + 32) = w3;
+        *(v16*)(cur + 48) = w4;
+        cur += 64;
+    }
+    while (cur < end) {
+        *(v16*)cur = alias_load(v16, s);
+        cur += 16;
+    }
+
+    alias_store(v16, d, head);
+    alias_store(v16, end, tail);
+    return dest;
+}
+
+void* memcpy_rep_movsb(void* restrict dest, const void* restrict src, size_t n) {
+    void* d = dest;
+    __asm__ volatile ("rep movsb" : "+D"(d), "+S"(src), "+c"(n) : : "memory");
+    return dest;
+}
+
 void* memcpy(void* restrict dest, const void* restrict src, size_t n) {
+    if (n <= 32) {
+        copy_small(dest, src, n);
+        return dest;
+    }
+
+    if ((m_string_fsrm && n >= FSRM_THRESHOLD) || (m_string_erms && n >= REP_MOVSB_THRESHOLD)) {
+        return memcpy_rep_movsb(dest, src, n);
+    }
+
+    return memcpy_sse(dest, src, n);
+}
+
+void* memcpy_unrolled(void* restrict dest, const void* restrict src, size_t n) {
     unsigned char* curDest = dest;
     const unsigned char* curSrc = src;
 
@@ -80,7 +239,109 @@ void* memcpy(void* restrict dest, const void* restrict src, size_t n) {
     return dest;
 }
 
+/**
+ * Repeat the byte on all the bytes of the vector
+ */
+static inline v16 splat_byte(unsigned char byte) {
+    return (v16){} + (char)byte;
+}
+
+void* memset_sse(void* dest, int val, size_t n) {
+    unsigned char* d = dest;
+    unsigned char byte = val;
+
+    if (n < 16) {
+        uint64_t pattern64 = 0x0101010101010101ull * byte;
+        if (n >= 8) {
+            unsigned char* last = d + n - 8;
+            alias_store(uint64_t, d, pattern64);
+            alias_store(uint64_t, last, pattern64);
+        } else if (n >= 4) {
+            unsigned char* last = d + n - 4;
+            alias_store(uint32_t, d, (uint32_t)pattern64);
+            alias_store(uint32_t, last, (uint32_t)pattern64);
+        } else {
+            while (n--) {
+                *d++ = byte;
+            }
+        }
+        return dest;
+    }
+
+    // same as the copy, unaligned head and tail with aligned stores in between
+    v16 pattern = splat_byte(byte);
+    unsigned char* end = d + n - 16;
+    unsigned char* cur = d + 16 - ((uintptr_t)d & 15);
+
+    while (cur + 64 <= end) {
+        *(v16*)(cur + 0) = pattern;
+        *(v16*)(cur + 16) = pattern;
+        *(v16*)(cur + 32) = pattern;
+        *(v16*)(cur + 48) = pattern;
+        cur += 64;
+    }
+    while (cur < end) {
+        *(v16*)cur = pattern;
+        cur += 16;
+    }
+
+    alias_store(v16, d, pattern);
+    alias_store(v16, end, pattern);
+    return dest;
+}
+
+void* memset_rep_stosb(void* dest, int val, size_t n) {
+    void* d = dest;
+    __asm__ volatile ("rep stosb" : "+D"(d), "+c"(n) : "a"(val) : "memory");
+    return dest;
+}
+
+void* memset_nt(void* dest, int val, size_t n) {
+    unsigned char* d = dest;
+    v16 pattern = splat_byte(val);
+
+    if (n < 64) {
+        return memset_sse(dest, val, n);
+    }
+
+    // align the destination with normal stores
+    size_t head = (16 - ((uintptr_t)d & 15)) & 15;
+    alias_store(v16, d, pattern);
+    d = (unsigned char*)dest + head;
+    n -= head;
+
+    // bypass the cache for the bulk
+    while (n >= 64) {
+        __builtin_ia32_movntdq((v2di*)(d + 0), (v2di)pattern);
+        __builtin_ia32_movntdq((v2di*)(d + 16), (v2di)pattern);
+        __builtin_ia32_movntdq((v2di*)(d + 32), (v2di)pattern);
+        __builtin_ia32_movntdq((v2di*)(d + 48), (v2di)pattern);
+        d += 64;
+        n -= 64;
+    }
+
+    // the non-temporal stores are weakly ordered
+    __builtin_ia32_sfence();
+
+    if (n != 0) {
+        memset_sse(d, val, n);
+    }
+    return dest;
+}
+
 void* memset(void* dest, int val, size_t n) {
+    if (n >= NON_TEMPORAL_THRESHOLD) {
+        return memset_nt(dest, val, n);
+    }
+
+    if ((m_string_fsrm && n >= FSRM_THRESHOLD) || (m_string_erms && n >= REP_MOVSB_THRESHOLD)) {
+        return memset_rep_stosb(dest, val, n);
+    }
+
+    return memset_sse(dest, val, n);
+}
+
+void* memset_unrolled(void* dest, int val, size_t n) {
     unsigned char* curDest = dest;
     unsigned char byte = val;
 
@@ -150,25 +411,58 @@ void* memset(void* dest, int val, size_t n) {
     return dest;
 }
 
-void* memmove (void* dest, const void* src, size_t len) {
-    char *d = dest;
-    const char *s = src;
-    if (d < s) {
-        memcpy(dest, src, len);
-    } else {
-        const char* lasts = s + (len - 1);
-        char* lastd = d + (len - 1);
-        while (len--) {
-            *lastd-- = *lasts--;
-        }
+void* memmove(void* dest, const void* src, size_t len) {
+    unsigned char* d = dest;
+    const unsigned char* s = src;
+
+    // small moves load everything before storing
+    if (len <= 32) {
+        copy_small(d, s, len);
+        return dest;
+    }
+
+    // a forward copy is fine unless the destination starts inside of the source
+    if ((uintptr_t)d - (uintptr_t)s >= len) {
+        return memcpy(dest, src, len);
+    }
+
+    // copy backwards, the first vector is loaded before anything can overwrite it
+    v16 head;
+    __builtin_memcpy(&head, s, sizeof(head));
+
+    s += len;
+    unsigned char* cur = d + len;
+    while (cur - d > 16) {
+        v16 w;
+        s -= 16;
+        cur -= 16;
+        __builtin_memcpy(&w, s, sizeof(w));
+        __builtin_memcpy(cur, &w, sizeof(w));
     }
+
+    __builtin_memcpy(d, &head, sizeof(head));
     return dest;
 }
 
 int memcmp(const void* lhs, const void* rhs, size_t count) {
     const uint8_t* lhs_str = (const uint8_t*)lhs;
     const uint8_t* rhs_str = (const uint8_t*)rhs;
-    for(size_t i = 0; i < count; i++) {
+    size_t i = 0;
+
+    // find the first vector that is different
+    for (; i + 16 <= count; i += 16) {
+        const uint8_t* l = lhs_str + i;
+        const uint8_t* r = rhs_str + i;
+        v16 a = alias_load(v16, l);
+        v16 b = alias_load(v16, r);
+        int mask = __builtin_ia32_pmovmskb128(a == b);
+        if (mask != 0xFFFF) {
+            i += __builtin_ctz(~mask);
+            return lhs_str[i] < rhs_str[i] ? -1 : 1;
+        }
+    }
+
+    for(; i < count; i++) {
         if(lhs_str[i] < rhs_str[i]) {
             return -1;
         }
@@ -333,4 +627,85 @@ char* strcat(char* destination, const char* source) {
     }
     *ptr = '\0';
     return destination;
-}
\ No newline at end of file
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Benchmark
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#define STRING_BENCHMARK_MAX_SIZE   SIZE_16MB
+#define STRING_BENCHMARK_BYTES      SIZE_256MB
+
+typedef void* (*string_copy_t)(void* restrict dest, const void* restrict src, size_t n);
+typedef void* (*string_set_t)(void* dest, int val, size_t n);
+
+/**
+ * Turn the amount of bytes and cycles into MB/s
+ */
+static uint64_t string_benchmark_rate(size_t bytes, uint64_t cycles) {
+    if (cycles == 0) {
+        cycles = 1;
+    }
+    // scale the frequency down so the multiplication can't overflow
+    return bytes * (get_tsc_freq() / 1000) / cycles * 1000 / SIZE_1MB;
+}
+
+static uint64_t string_benchmark_copy(string_copy_t copy, void* dest, const void* src, size_t size) {
+    // do roughly the same amount of bytes for every size
+    size_t iterations = MAX(STRING_BENCHMARK_BYTES / size, 4);
+    copy(dest, src, size);
+    uint64_t start = get_tsc();
+    for (size_t i = 0; i < iterations; i++) {
+        copy(dest, src, size);
+        __asm__ volatile ("" ::: "memory");
+    }
+    return string_benchmark_rate(size * iterations, get_tsc() - start);
+}
+
+static uint64_t string_benchmark_set(string_set_t set, void* dest, size_t size) {
+    size_t iterations = MAX(STRING_BENCHMARK_BYTES / size, 4);
+    set(dest, 0, size);
+    uint64_t start = get_tsc();
+    for (size_t i = 0; i < iterations; i++) {
+        set(dest, (int)i, size);
+        __asm__ volatile ("" ::: "memory");
+    }
+    return string_benchmark_rate(size * iterations, get_tsc() - start);
+}
+
+void string_benchmark() {
+    TRACE("\tString benchmark (erms=%d, fsrm=%d)", m_string_erms, m_string_fsrm);
+
+    void* dest = palloc(STRING_BENCHMARK_MAX_SIZE);
+    void* src = palloc(STRING_BENCHMARK_MAX_SIZE);
+    if (dest == NULL || src == NULL) {
+        WARN("\t\tFailed to allocate the benchmark buffers");
+        goto cleanup;
+    }
+    memset_unrolled(src, 0x5A, STRING_BENCHMARK_MAX_SIZE);
+
+    // all numbers are in MB/s
+    TRACE("\t\t%10s | %8s %8s %8s %8s | %8s %8s %8s %8s %8s",
+          "size", "cpy", "cpy-sse", "cpy-rep", "cpy-old", "set", "set-sse", "set-rep", "set-nt", "set-old");
+    for (size_t size = 16; size <= STRING_BENCHMARK_MAX_SIZE; size *= 2) {
+        TRACE("\t\t%10lu | %8lu %8lu %8lu %8lu | %8lu %8lu %8lu %8lu %8lu",
+              size,
+              string_benchmark_copy(memcpy, dest, src, size),
+              string_benchmark_copy(memcpy_sse, dest, src, size),
+              string_benchmark_copy(memcpy_rep_movsb, dest, src, size),
+              string_benchmark_copy(memcpy_unrolled, dest, src, size),
+              string_benchmark_set(memset, dest, size),
+              string_benchmark_set(memset_sse, dest, size),
+              string_benchmark_set(memset_rep_stosb, dest, size),
+              string_benchmark_set(memset_nt, dest, size),
+              string_benchmark_set(memset_unrolled, dest, size));
+    }
+
+cleanup:
+    if (dest != NULL) {
+        pfree(dest);
+    }
+    if (src != NULL) {
+        pfree(src);
+    }
+}
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <stdbool.h>
 #include <stddef.h>
 
 #define memset __builtin_memset
@@ -16,3 +17,31 @@
 #define strcasecmp __builtin_strcasecmp
 
 unsigned long int strtoul(const char *nptr, char **endptr, int base);
+
+/**
+ * Check the cpu features used to select the mem* variants, until this
+ * is called the variants that only need SSE2 are used
+ */
+void init_string();
+
+bool string_has_erms();
+bool string_has_fsrm();
+
+//
+// The different variants of memcpy/memset, normally memcpy/memset select one
+// based on the size and cpu features, these are exposed for benchmarking
+//
+
+void* memcpy_sse(void* restrict dest, const void* restrict src, size_t n);
+void* memcpy_rep_movsb(void* restrict dest, const void* restrict src, size_t n);
+void* memcpy_unrolled(void* restrict dest, const void* restrict src, size_t n);
+
+void* memset_sse(void* dest, int val, size_t n);
+void* memset_rep_stosb(void* dest, int val, size_t n);
+void* memset_nt(void* dest, int val, size_t n);
+void* memset_unrolled(void* dest, int val, size_t n);
+
+/**
+ * Measure the throughput of all the variants over a sweep of sizes, not called by default
+ */
+void string_benchmark();